@@ -0,0 +1,115 @@
+// Copyright 2019 Oath Inc. Licensed under the terms of the Apache 2.0 license. See LICENSE in the project root.
+#include <vespa/vespalib/testkit/test_kit.h>
+#include <vespa/vespalib/util/benchmark_timer.h>
+#include <vespa/fastlib/text/normwordfolder.h>
+#include <vespa/juniper/config.h>
+#include <vespa/juniper/queryhandle.h>
+#include <vespa/juniper/queryparser.h>
+#include <vespa/juniper/result.h>
+#include <vespa/juniper/rpinterface.h>
+#include <map>
+#include <random>
+
+using vespalib::BenchmarkTimer;
+
+namespace {
+
+class MyProperties : public IJuniperProperties
+{
+    std::map<std::string, std::string> _map;
+public:
+    MyProperties() : _map() {
+        _map["juniper.dynsum.highlight_on"] = "<hi>";
+        _map["juniper.dynsum.highlight_off"] = "</hi>";
+        _map["juniper.dynsum.continuation"] = "<sep />";
+        _map["juniper.dynsum.escape_markup"] = "off";
+    }
+    const char* GetProperty(const char* name, const char* def) override {
+        auto itr = _map.find(name);
+        return (itr != _map.end()) ? itr->second.c_str() : def;
+    }
+};
+
+const char *words[] = { "the", "of", "and", "a", "to", "in", "is", "you", "that", "it",
+                        "search", "engine", "document", "summary", "teaser", "content", "node",
+                        "query", "result", "ranking", "vespa", "index", "attribute", "field",
+                        "distribution", "cluster", "container", "latency", "throughput", "memory" };
+
+/**
+ * Creates text with word frequencies roughly following a zipf distribution,
+ * punctuated like ordinary prose.
+ **/
+std::string make_text(std::mt19937 &rnd, size_t num_words) {
+    const size_t num_distinct = sizeof(words) / sizeof(words[0]);
+    std::vector<double> weights;
+    for (size_t i = 0; i < num_distinct; ++i) {
+        weights.push_back(1.0 / (i + 1));
+    }
+    std::discrete_distribution<size_t> dist(weights.begin(), weights.end());
+    std::string text;
+    for (size_t i = 0; i < num_words; ++i) {
+        if (i > 0) {
+            text.append(((i % 17) == 0) ? ". " : " ");
+        }
+        text.append(words[dist(rnd)]);
+    }
+    text.append(".");
+    return text;
+}
+
+struct Fixture {
+    MyProperties props;
+    Fast_NormalizeWordFolder wordfolder;
+    juniper::Juniper juniper;
+    std::unique_ptr<juniper::Config> config;
+    std::vector<std::string> docs;
+    Fixture(size_t num_docs, size_t num_words)
+        : props(),
+          wordfolder(),
+          juniper(&props, &wordfolder),
+          config(juniper.CreateConfig()),
+          docs()
+    {
+        std::mt19937 rnd(42);
+        for (size_t i = 0; i < num_docs; ++i) {
+            docs.push_back(make_text(rnd, num_words));
+        }
+    }
+    size_t make_teasers(juniper::QueryHandle &qh) {
+        size_t total = 0;
+        for (size_t i = 0; i < docs.size(); ++i) {
+            juniper::Result *res = juniper::Analyse(config.get(), &qh, docs[i].data(), docs[i].size(), i, 0, 0);
+            juniper::Summary *sum = juniper::GetTeaser(res, nullptr);
+            total += sum->Length();
+            juniper::ReleaseResult(res);
+        }
+        return total;
+    }
+    void benchmark(const char *query_text) {
+        juniper::QueryParser query(query_text);
+        // The query handle is shared by all hits, like it is for the hits of a docsum request
+        juniper::QueryHandle qh(query, nullptr, juniper.getModifier());
+        size_t total = 0;
+        double min_time_s = BenchmarkTimer::benchmark([&](){ total += make_teasers(qh); }, 2.0);
+        fprintf(stderr, "query '%s': %g teasers/s (%zu docs, %g ms per batch)\n",
+                query_text, docs.size() / min_time_s, docs.size(), min_time_s * 1000.0);
+        EXPECT_GREATER(total, 0u);
+    }
+};
+
+}
+
+TEST_F("benchmark teasers on short text", Fixture(100, 100)) {
+    f1.benchmark("vespa");
+    f1.benchmark("AND(search,engine)");
+    f1.benchmark("PHRASE(content,node)");
+}
+
+TEST_F("benchmark teasers on long text", Fixture(100, 5000)) {
+    f1.benchmark("vespa");
+    f1.benchmark("AND(search,engine)");
+    f1.benchmark("OR(latency,throughput,memory)");
+    f1.benchmark("missingword");
+}
+
+TEST_MAIN() { TEST_RUN_ALL(); }
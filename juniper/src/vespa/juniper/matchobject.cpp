@@ -147,12 +147,14 @@ MatchObject::MatchObject(QueryExpr* query, bool has_reductions) :
     _match_overlap(false), _max_arity(0),
     _has_reductions(has_reductions),
     _qt_byname(),
-    _reduce_matchers()
+    _reduce_matchers(),
+    _special_tokens()
 {
     LOG(debug, "MatchObject(default)");
     traverser tr(*this);
     query->Accept(tr); // Initialize structure for the query
     _max_arity = query->MaxArity();
+    _special_tokens.reset(new juniper::SpecialTokenRegistry(_query));
 }
 
 
@@ -165,7 +167,8 @@ MatchObject::MatchObject(QueryExpr* query,  bool has_reductions, uint32_t langid
     _max_arity(0),
     _has_reductions(has_reductions),
     _qt_byname(),
-    _reduce_matchers()
+    _reduce_matchers(),
+    _special_tokens()
 {
     LOG(debug, "MatchObject(language %d)", langid);
     query_expander qe(*this, langid);
@@ -179,6 +182,7 @@ MatchObject::MatchObject(QueryExpr* query,  bool has_reductions, uint32_t langid
             langid, s.c_str());
     }
     _max_arity = _query->MaxArity();
+    _special_tokens.reset(new juniper::SpecialTokenRegistry(_query));
 }
 
 
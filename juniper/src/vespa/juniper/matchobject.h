@@ -7,6 +7,8 @@
 #include <vespa/fastlib/text/unicodeutil.h>
 #include "reducematcher.h"
 #include "ITokenProcessor.h"
+#include "specialtokenregistry.h"
+#include <memory>
 
 typedef juniper::Result Result;
 typedef ITokenProcessor::Token Token;
@@ -95,6 +97,9 @@ public:
     inline QueryExpr* Query() { return _query; }
     inline bool HasReductions() { return _has_reductions; }
 
+    /** The special tokens of the query, found once and shared by all results using this match object */
+    inline const juniper::SpecialTokenRegistry& SpecialTokens() const { return *_special_tokens; }
+
     // internal use only..
     void add_queryterm(QueryTerm* term);
     void add_nonterm(QueryNode* n);
@@ -109,6 +114,7 @@ private:
     bool _has_reductions; // query contains terms that reqs reduction of tokens before matching
     queryterm_hashtable _qt_byname; // fast lookup by name
     juniper::ReduceMatcher _reduce_matchers;
+    std::unique_ptr<juniper::SpecialTokenRegistry> _special_tokens;
 
     MatchObject(MatchObject &);
     MatchObject &operator=(MatchObject &);
@@ -85,14 +85,14 @@ Result::Result(Config* config, QueryHandle* qhandle,
     _matcher.reset(new Matcher(this));
     _matcher->SetProximityFactor(mp.ProximityFactor());
 
-    _registry.reset(new SpecialTokenRegistry(_matcher->getQuery()));
-
     if (qhandle->_log_mask)
         _matcher->set_log(qhandle->_log_mask);
 
     _tokenizer->SetSuccessor(_matcher.get());
-    if (!_registry->getSpecialTokens().empty()) {
-        _tokenizer->setRegistry(_registry.get());
+    // The special tokens are found once per query in the match object
+    const SpecialTokenRegistry& registry = _mo->SpecialTokens();
+    if (!registry.getSpecialTokens().empty()) {
+        _tokenizer->setRegistry(&registry);
     }
 }
 
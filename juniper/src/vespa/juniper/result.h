@@ -44,7 +44,6 @@ public:
     uint32_t _langid;
     Config* _config;
     std::unique_ptr<Matcher> _matcher;
-    std::unique_ptr<SpecialTokenRegistry> _registry;
     std::unique_ptr<JuniperTokenizer> _tokenizer;
 private:
     std::vector<Summary*> _summaries; // Active summaries for this result
@@ -3,6 +3,8 @@
 #include <vespa/vespalib/testkit/testapp.h>
 #include <vespa/messagebus/destinationsession.h>
 #include <vespa/messagebus/dynamicthrottlepolicy.h>
+#include <vespa/messagebus/errorcode.h>
+#include <vespa/messagebus/latencythrottlepolicy.h>
 #include <vespa/messagebus/routablequeue.h>
 #include <vespa/messagebus/routing/retrytransienterrorspolicy.h>
 #include <vespa/messagebus/routing/routingspec.h>
@@ -13,6 +15,7 @@
 #include <vespa/messagebus/testlib/simplemessage.h>
 #include <vespa/messagebus/testlib/simplereply.h>
 #include <vespa/messagebus/testlib/testserver.h>
+#include <deque>
 
 using namespace mbus;
 
@@ -65,6 +68,59 @@ bool waitPending(SourceSession& session, uint32_t size)
     return false;
 }
 
+/**
+ * Simulates a receiver with a fixed capacity (messages per millisecond) and
+ * a fixed processing latency, queueing everything it can not process.
+ */
+class SimulatedServer {
+    struct Pending {
+        uint64_t time; // arrival time while queued, reply time while processing
+        Context  context;
+    };
+    uint32_t            _capacity;
+    uint64_t            _latency;
+    std::deque<Pending> _queue;
+    std::deque<Pending> _processing;
+    uint64_t            _numReplies;
+    uint64_t            _elapsed;
+    uint32_t            _maxSendPerTick;
+
+public:
+    SimulatedServer(uint32_t capacity, uint64_t latency)
+        : _capacity(capacity), _latency(latency), _queue(), _processing(), _numReplies(0), _elapsed(0),
+          _maxSendPerTick(UINT32_MAX)
+    { }
+    void setCapacity(uint32_t capacity) { _capacity = capacity; }
+    void setMaxSendPerTick(uint32_t maxSend) { _maxSendPerTick = maxSend; }
+    double throughput() const { return (double)_numReplies / _elapsed; }
+
+    void run(IThrottlePolicy &policy, DynamicTimer &timer, uint64_t millis) {
+        _numReplies = 0;
+        _elapsed = millis;
+        for (uint64_t end = timer._millis + millis; timer._millis < end; ++timer._millis) {
+            SimpleMessage msg("foo");
+            uint32_t numSent = 0;
+            while (numSent < _maxSendPerTick && policy.canSend(msg, pending())) {
+                policy.processMessage(msg);
+                _queue.push_back({timer._millis, msg.getContext()});
+                ++numSent;
+            }
+            for (uint32_t i = 0; i < _capacity && !_queue.empty(); ++i) {
+                _processing.push_back({timer._millis + _latency, _queue.front().context});
+                _queue.pop_front();
+            }
+            while (!_processing.empty() && _processing.front().time <= timer._millis) {
+                SimpleReply reply("bar");
+                reply.setContext(_processing.front().context);
+                policy.processReply(reply);
+                _processing.pop_front();
+                ++_numReplies;
+            }
+        }
+    }
+    uint32_t pending() const { return _queue.size() + _processing.size(); }
+};
+
 ////////////////////////////////////////////////////////////////////////////////
 //
 // Setup
@@ -83,6 +139,11 @@ protected:
     void testIdleTimePeriod();
     void testMinWindowSize();
     void testMaxWindowSize();
+    void testLatencyWindowSize();
+    void testLatencyCapacityDrop();
+    void testLatencyUnreachableTarget();
+    void testLatencyUnusedWindow();
+    void testLatencyErrorBackOff();
 
 public:
     int Main() override;
@@ -100,6 +161,11 @@ Test::Main()
     testIdleTimePeriod();    TEST_FLUSH();
     testMinWindowSize();     TEST_FLUSH();
     testMaxWindowSize();     TEST_FLUSH();
+    testLatencyWindowSize();        TEST_FLUSH();
+    testLatencyCapacityDrop();      TEST_FLUSH();
+    testLatencyUnreachableTarget(); TEST_FLUSH();
+    testLatencyUnusedWindow();      TEST_FLUSH();
+    testLatencyErrorBackOff();      TEST_FLUSH();
 
     TEST_DONE();
 }
@@ -332,6 +398,96 @@ Test::testMaxWindowSize()
 
 }
 
+void
+Test::testLatencyWindowSize()
+{
+    auto ptr = std::make_unique<DynamicTimer>();
+    DynamicTimer *timer = ptr.get();
+    LatencyThrottlePolicy policy(20, std::move(ptr));
+    SimulatedServer server(10, 5);
+
+    server.run(policy, *timer, 20000);
+    // Latency target 20 at 10 replies per ms gives about 200 pending, plus headroom
+    EXPECT_TRUE(policy.getWindowSize() >= 150 && policy.getWindowSize() <= 300);
+    EXPECT_EQUAL((uint32_t)policy.getWindowSize(), policy.getMaxPendingCount());
+    EXPECT_TRUE(policy.getNumSamples() > 100);
+    EXPECT_TRUE(policy.getSampleLatency() >= 15 && policy.getSampleLatency() <= 30);
+    EXPECT_TRUE(server.throughput() > 9.5);
+    EXPECT_EQUAL(5.0, policy.getMinLatency());
+}
+
+void
+Test::testLatencyCapacityDrop()
+{
+    auto ptr = std::make_unique<DynamicTimer>();
+    DynamicTimer *timer = ptr.get();
+    LatencyThrottlePolicy policy(20, std::move(ptr));
+    SimulatedServer server(10, 5);
+
+    server.run(policy, *timer, 20000);
+    double windowSize = policy.getWindowSize();
+    server.setCapacity(2);
+    server.run(policy, *timer, 20000);
+    EXPECT_TRUE(windowSize >= 150 && windowSize <= 300);
+    EXPECT_TRUE(policy.getWindowSize() < windowSize / 3);
+    EXPECT_TRUE(policy.getWindowSize() >= 30 && policy.getWindowSize() <= 75);
+    EXPECT_TRUE(policy.getSampleLatency() >= 15 && policy.getSampleLatency() <= 30);
+    EXPECT_TRUE(server.throughput() > 1.9);
+}
+
+void
+Test::testLatencyUnreachableTarget()
+{
+    auto ptr = std::make_unique<DynamicTimer>();
+    DynamicTimer *timer = ptr.get();
+    LatencyThrottlePolicy policy(1, std::move(ptr));
+    SimulatedServer server(10, 5);
+
+    server.run(policy, *timer, 20000);
+    // The target is floored at the no-load latency, giving about 50 pending, plus headroom
+    EXPECT_EQUAL(5.0, policy.getMinLatency());
+    EXPECT_TRUE(policy.getWindowSize() >= 50 && policy.getWindowSize() <= 100);
+    EXPECT_TRUE(policy.getSampleLatency() < 10);
+    EXPECT_TRUE(server.throughput() > 9.5);
+}
+
+void
+Test::testLatencyUnusedWindow()
+{
+    auto ptr = std::make_unique<DynamicTimer>();
+    DynamicTimer *timer = ptr.get();
+    LatencyThrottlePolicy policy(20, std::move(ptr));
+    SimulatedServer server(10, 5);
+    server.setMaxSendPerTick(1);
+
+    double windowSize = policy.getWindowSize();
+    server.run(policy, *timer, 20000);
+    EXPECT_TRUE(policy.getNumSamples() > 100);
+    EXPECT_EQUAL(windowSize, policy.getWindowSize());
+}
+
+void
+Test::testLatencyErrorBackOff()
+{
+    auto ptr = std::make_unique<DynamicTimer>();
+    DynamicTimer *timer = ptr.get();
+    LatencyThrottlePolicy policy(20, std::move(ptr));
+    SimulatedServer server(10, 5);
+
+    server.run(policy, *timer, 20000);
+    double windowSize = policy.getWindowSize();
+    uint64_t numSamples = policy.getNumSamples();
+    SimpleMessage msg("foo");
+    while (policy.getNumSamples() == numSamples) {
+        policy.processMessage(msg);
+        SimpleReply reply("bar");
+        reply.setContext(msg.getContext());
+        reply.addError(Error(ErrorCode::SESSION_BUSY, "busy"));
+        policy.processReply(reply);
+    }
+    EXPECT_TRUE(policy.getWindowSize() <= windowSize * 0.9);
+}
+
 uint32_t
 Test::getWindowSize(DynamicThrottlePolicy &policy, DynamicTimer &timer, uint32_t maxPending)
 {
@@ -0,0 +1,175 @@
+// Copyright 2019 Oath Inc. Licensed under the terms of the Apache 2.0 license. See LICENSE in the project root.
+#include "latencythrottlepolicy.h"
+#include "message.h"
+#include "steadytimer.h"
+#include <climits>
+#include <cmath>
+
+#include <vespa/log/log.h>
+LOG_SETUP(".latencythrottlepolicy");
+
+namespace mbus {
+
+LatencyThrottlePolicy::LatencyThrottlePolicy(uint64_t latencyTarget)
+    : LatencyThrottlePolicy(latencyTarget, std::make_unique<SteadyTimer>())
+{ }
+
+LatencyThrottlePolicy::LatencyThrottlePolicy(uint64_t latencyTarget, ITimer::UP timer) :
+    _timer(std::move(timer)),
+    _latencyTarget(latencyTarget),
+    _maxPendingCount(0),
+    _minSampleSize(16),
+    _maxPendingInSample(0),
+    _numReplies(0),
+    _numErrors(0),
+    _latencySum(0),
+    _numSamples(0),
+    _sampleLatency(0),
+    _minLatency(0),
+    _minLatencyDecay(0.01),
+    _smoothing(0.2),
+    _windowSizeBackOff(0.9),
+    _windowSize(20),
+    _minWindowSize(1),
+    _maxWindowSize(INT_MAX)
+{ }
+
+LatencyThrottlePolicy::~LatencyThrottlePolicy() = default;
+
+LatencyThrottlePolicy &
+LatencyThrottlePolicy::setLatencyTarget(uint64_t latencyTarget)
+{
+    _latencyTarget = latencyTarget;
+    return *this;
+}
+
+LatencyThrottlePolicy &
+LatencyThrottlePolicy::setMinSampleSize(uint32_t minSampleSize)
+{
+    _minSampleSize = std::max(minSampleSize, 1u);
+    return *this;
+}
+
+LatencyThrottlePolicy &
+LatencyThrottlePolicy::setSmoothing(double smoothing)
+{
+    _smoothing = std::max(0.01, std::min(1.0, smoothing));
+    return *this;
+}
+
+LatencyThrottlePolicy &
+LatencyThrottlePolicy::setWindowSizeBackOff(double windowSizeBackOff)
+{
+    _windowSizeBackOff = std::max(0.0, std::min(1.0, windowSizeBackOff));
+    return *this;
+}
+
+LatencyThrottlePolicy &
+LatencyThrottlePolicy::setMinLatencyDecay(double decay)
+{
+    _minLatencyDecay = std::max(0.0, std::min(1.0, decay));
+    return *this;
+}
+
+LatencyThrottlePolicy &
+LatencyThrottlePolicy::setMinWindowSize(double min)
+{
+    _minWindowSize = std::max(1.0, min);
+    _windowSize = std::max(_minWindowSize, _windowSize);
+    return *this;
+}
+
+LatencyThrottlePolicy &
+LatencyThrottlePolicy::setMaxWindowSize(double max)
+{
+    _maxWindowSize = max;
+    _windowSize = std::min(_maxWindowSize, _windowSize);
+    return *this;
+}
+
+LatencyThrottlePolicy &
+LatencyThrottlePolicy::setMaxPendingCount(uint32_t maxCount)
+{
+    _maxPendingCount = maxCount;
+    if (maxCount > 0) {
+        setMaxWindowSize(maxCount);
+    }
+    return *this;
+}
+
+uint32_t
+LatencyThrottlePolicy::getMaxPendingCount() const
+{
+    return (uint32_t)_windowSize;
+}
+
+bool
+LatencyThrottlePolicy::canSend(const Message &, uint32_t pendingCount)
+{
+    if (_maxPendingCount > 0 && pendingCount >= _maxPendingCount) {
+        return false;
+    }
+    if (pendingCount >= getMaxPendingCount()) {
+        return false;
+    }
+    _maxPendingInSample = std::max(_maxPendingInSample, pendingCount + 1);
+    return true;
+}
+
+void
+LatencyThrottlePolicy::processMessage(Message &msg)
+{
+    msg.setContext(Context(_timer->getMilliTime()));
+}
+
+void
+LatencyThrottlePolicy::processReply(Reply &reply)
+{
+    uint64_t now = _timer->getMilliTime();
+    uint64_t sent = reply.getContext().value.UINT64;
+    _latencySum += (now > sent) ? (now - sent) : 0;
+    if (reply.hasErrors()) {
+        ++_numErrors;
+    }
+    if (++_numReplies >= std::max(_minSampleSize, getMaxPendingCount())) {
+        updateWindowSize();
+    }
+}
+
+void
+LatencyThrottlePolicy::updateWindowSize()
+{
+    // Latency is measured with millisecond resolution, anything faster counts as one millisecond.
+    _sampleLatency = std::max(1.0, (double)_latencySum / _numReplies);
+    if (_numSamples == 0 || _sampleLatency < _minLatency) {
+        _minLatency = _sampleLatency;
+    } else if (_windowSize <= _minWindowSize) {
+        // Sending as little as allowed, so the sampled latency is not caused by this client queueing.
+        _minLatency += (_sampleLatency - _minLatency) * _minLatencyDecay;
+    }
+    ++_numSamples;
+
+    double target = std::max((double)_latencyTarget, _minLatency);
+    double gradient = std::max(0.5, std::min(1.0, target / _sampleLatency));
+    double newSize = _windowSize * gradient + std::sqrt(_windowSize);
+    if (_maxPendingInSample * 2 < _windowSize) {
+        // The window was not the limiting factor, so there is nothing to learn about a larger one.
+        newSize = std::min(newSize, _windowSize);
+    }
+    double oldSize = _windowSize;
+    _windowSize += (newSize - _windowSize) * _smoothing;
+    if (_numErrors > 0) {
+        _windowSize = std::min(_windowSize, oldSize * _windowSizeBackOff);
+    }
+    _windowSize = std::max(_minWindowSize, _windowSize);
+    _windowSize = std::min(_maxWindowSize, _windowSize);
+    LOG(debug, "WindowSize = %.2f, SampleLatency = %.2f, MinLatency = %.2f, Gradient = %.2f, Errors = %u",
+        _windowSize, _sampleLatency, _minLatency, gradient, _numErrors);
+
+    _numReplies = 0;
+    _numErrors = 0;
+    _latencySum = 0;
+    _maxPendingInSample = 0;
+}
+
+} // namespace mbus
@@ -0,0 +1,155 @@
+// Copyright 2019 Oath Inc. Licensed under the terms of the Apache 2.0 license. See LICENSE in the project root.
+#pragma once
+
+#include "ithrottlepolicy.h"
+#include "itimer.h"
+
+namespace mbus {
+
+/**
+ * This is an implementation of the {@link IThrottlePolicy} that adjusts the number of pending messages a {@link
+ * SourceSession} is allowed to have based on the measured reply latency, instead of the measured throughput as
+ * done by {@link DynamicThrottlePolicy}.
+ *
+ * Reply latencies are averaged over samples of roughly one window worth of replies. After each sample the
+ * window is scaled by the gradient between the latency target and the sampled latency (capped to [0.5, 1]),
+ * and a headroom of sqrt(window) is added to probe for more capacity. As long as the sampled latency is below
+ * the target the window grows, and once the receivers start queueing the window shrinks towards the size that
+ * keeps latency at the target. The target is never set below the smallest latency observed, which is used as
+ * an estimate of the no-load latency, so that a target that can not be reached does not drain the window.
+ *
+ * The window is only grown if it was actually used during the sample, and a sample containing errors backs
+ * the window off, since errors are typically caused by overloaded receivers.
+ */
+class LatencyThrottlePolicy : public IThrottlePolicy {
+private:
+    ITimer::UP _timer;
+    uint64_t   _latencyTarget;
+    uint32_t   _maxPendingCount;
+    uint32_t   _minSampleSize;
+    uint32_t   _maxPendingInSample;
+    uint32_t   _numReplies;
+    uint32_t   _numErrors;
+    uint64_t   _latencySum;
+    uint64_t   _numSamples;
+    double     _sampleLatency;
+    double     _minLatency;
+    double     _minLatencyDecay;
+    double     _smoothing;
+    double     _windowSizeBackOff;
+    double     _windowSize;
+    double     _minWindowSize;
+    double     _maxWindowSize;
+
+    void updateWindowSize();
+
+public:
+    typedef std::unique_ptr<LatencyThrottlePolicy> UP;
+    typedef std::shared_ptr<LatencyThrottlePolicy> SP;
+
+    /**
+     * Constructs a new instance of this policy, aiming for the given reply latency.
+     *
+     * @param latencyTarget The wanted reply latency in milliseconds.
+     */
+    LatencyThrottlePolicy(uint64_t latencyTarget);
+
+    /**
+     * Constructs a new instance of this policy using the given timer to measure latency.
+     *
+     * @param latencyTarget The wanted reply latency in milliseconds.
+     * @param timer         The timer to use.
+     */
+    LatencyThrottlePolicy(uint64_t latencyTarget, ITimer::UP timer);
+    ~LatencyThrottlePolicy() override;
+
+    /**
+     * Sets the wanted reply latency in milliseconds.
+     *
+     * @param latencyTarget The target to set.
+     * @return This, to allow chaining.
+     */
+    LatencyThrottlePolicy &setLatencyTarget(uint64_t latencyTarget);
+
+    /**
+     * Sets the smallest number of replies that make up a latency sample. Samples are otherwise as large as the
+     * current window.
+     *
+     * @param minSampleSize The size to set.
+     * @return This, to allow chaining.
+     */
+    LatencyThrottlePolicy &setMinSampleSize(uint32_t minSampleSize);
+
+    /**
+     * Sets how much of the newly calculated window size is used for each sample, in the (0, 1] range. The
+     * smaller the value, the less responsive, but also the less noisy, the resizing becomes.
+     *
+     * @param smoothing The factor to set.
+     * @return This, to allow chaining.
+     */
+    LatencyThrottlePolicy &setSmoothing(double smoothing);
+
+    /**
+     * Sets the factor of window size to back off to when a sample contains errors.
+     *
+     * @param windowSizeBackOff The back off to set.
+     * @return This, to allow chaining.
+     */
+    LatencyThrottlePolicy &setWindowSizeBackOff(double windowSizeBackOff);
+
+    /**
+     * Sets how fast the estimated no-load latency moves towards a larger sampled latency while the window is
+     * at its minimum size, in the [0, 1] range. This allows the estimate to recover if the receivers become
+     * permanently slower.
+     *
+     * @param decay The factor to set.
+     * @return This, to allow chaining.
+     */
+    LatencyThrottlePolicy &setMinLatencyDecay(double decay);
+
+    LatencyThrottlePolicy &setMinWindowSize(double min);
+    LatencyThrottlePolicy &setMaxWindowSize(double max);
+
+    /**
+     * Sets the maximum number of pending messages allowed, regardless of the window size. A value of 0 means
+     * no limit.
+     *
+     * @param maxCount The max count.
+     * @return This, to allow chaining.
+     */
+    LatencyThrottlePolicy &setMaxPendingCount(uint32_t maxCount);
+
+    uint64_t getLatencyTarget() const { return _latencyTarget; }
+    double getMinWindowSize() const { return _minWindowSize; }
+    double getMaxWindowSize() const { return _maxWindowSize; }
+    double getWindowSize() const { return _windowSize; }
+
+    /**
+     * Returns the maximum number of pending messages currently allowed.
+     *
+     * @return The max limit.
+     */
+    uint32_t getMaxPendingCount() const;
+
+    /**
+     * Returns the average reply latency in milliseconds of the last completed sample, or 0 if there has been
+     * none yet.
+     */
+    double getSampleLatency() const { return _sampleLatency; }
+
+    /**
+     * Returns the estimated no-load reply latency in milliseconds, or 0 if there has been no samples yet.
+     */
+    double getMinLatency() const { return _minLatency; }
+
+    /**
+     * Returns the number of samples the window size has been adjusted from.
+     */
+    uint64_t getNumSamples() const { return _numSamples; }
+
+    bool canSend(const Message &msg, uint32_t pendingCount) override;
+    void processMessage(Message &msg) override;
+    void processReply(Reply &reply) override;
+};
+
+} // namespace mbus
@@ -14,6 +14,7 @@ Config::Config() :
     _isFilter(false),
     _fastAccess(false),
     _mutable(false),
+    _searchCacheMaxBytes(0),
     _growStrategy(),
     _compactionStrategy(),
     _predicateParams(),
@@ -31,6 +32,7 @@ Config::Config(BasicType bt, CollectionType ct, bool fastSearch_, bool huge_)
       _isFilter(false),
       _fastAccess(false),
       _mutable(false),
+      _searchCacheMaxBytes(0),
       _growStrategy(),
       _compactionStrategy(),
       _predicateParams(),
@@ -54,6 +56,7 @@ Config::operator==(const Config &b) const
            _isFilter == b._isFilter &&
            _fastAccess == b._fastAccess &&
            _mutable == b._mutable &&
+           _searchCacheMaxBytes == b._searchCacheMaxBytes &&
            _growStrategy == b._growStrategy &&
            _compactionStrategy == b._compactionStrategy &&
            _predicateParams == b._predicateParams &&
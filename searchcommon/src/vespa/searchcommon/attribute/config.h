@@ -41,6 +41,13 @@ public:
     bool getEnableOnlyBitVector() const { return _enableOnlyBitVector; }
 
     bool getIsFilter() const { return _isFilter; }
+
+    /**
+     * Max number of bytes used to cache merged posting lists for a
+     * fast-search filter attribute. 0 means no cache.
+     */
+    size_t getSearchCacheMaxBytes() const { return _searchCacheMaxBytes; }
+
     bool isMutable() const { return _mutable; }
 
     /**
@@ -83,6 +90,7 @@ public:
      * Hide weight information when searching in attributes.
      */
     Config & setIsFilter(bool isFilter) { _isFilter = isFilter; return *this; }
+    Config & setSearchCacheMaxBytes(size_t v) { _searchCacheMaxBytes = v; return *this; }
 
     Config & setMutable(bool isMutable) { _mutable = isMutable; return *this; }
     Config & setFastAccess(bool v) { _fastAccess = v; return *this; }
@@ -101,6 +109,7 @@ private:
     bool           _isFilter;
     bool           _fastAccess;
     bool           _mutable;
+    size_t         _searchCacheMaxBytes;
     GrowStrategy   _growStrategy;
     CompactionStrategy _compactionStrategy;
     PredicateParams    _predicateParams;
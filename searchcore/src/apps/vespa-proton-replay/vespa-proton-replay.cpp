@@ -0,0 +1,400 @@
+// Copyright 2019 Oath Inc. Licensed under the terms of the Apache 2.0 license. See LICENSE in the project root.
+
+#include <vespa/fastos/app.h>
+#include <vespa/fnet/frt/frt.h>
+#include <vespa/searchlib/engine/proto_rpc_adapter.h>
+#include <vespa/searchlib/engine/search_request_capture.h>
+#include <vespa/vespalib/data/slime/slime.h>
+#include <vespa/vespalib/util/time.h>
+#include <algorithm>
+#include <atomic>
+#include <cinttypes>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include <vespa/log/log.h>
+LOG_SETUP("vespa-proton-replay");
+
+using search::engine::ProtoRpcAdapter;
+using search::engine::SearchRequestCapture;
+using ProtoSearchRequest = ProtoRpcAdapter::ProtoSearchRequest;
+using ProtoSearchReply = ProtoRpcAdapter::ProtoSearchReply;
+using vespalib::slime::Inspector;
+
+namespace {
+
+/**
+ * The outcome of replaying a single captured query. Phase times are
+ * taken from the search trace (needs trace level 4 or more) and are
+ * negative when not available. With several match threads the slowest
+ * thread is reported.
+ **/
+struct QueryResult {
+    bool    ok;
+    double  latency_ms;
+    int64_t total_hits;
+    int64_t coverage_docs;
+    double  setup_ms;
+    double  first_phase_ms;
+    double  second_phase_ms;
+    double  result_ms;
+    QueryResult()
+        : ok(false), latency_ms(0.0), total_hits(0), coverage_docs(0),
+          setup_ms(-1.0), first_phase_ms(-1.0), second_phase_ms(-1.0), result_ms(-1.0) {}
+    bool parse(const char *line, size_t &idx) {
+        char status[16];
+        int n = sscanf(line, "%zu %15s %lf %" SCNd64 " %" SCNd64 " %lf %lf %lf %lf", &idx, status,
+                       &latency_ms, &total_hits, &coverage_docs,
+                       &setup_ms, &first_phase_ms, &second_phase_ms, &result_ms);
+        ok = (strcmp(status, "OK") == 0);
+        return (n == 9);
+    }
+    void print(FILE *out, size_t idx) const {
+        fprintf(out, "%zu\t%s\t%.3f\t%" PRId64 "\t%" PRId64 "\t%.3f\t%.3f\t%.3f\t%.3f\n", idx, ok ? "OK" : "FAILED",
+                latency_ms, total_hits, coverage_docs, setup_ms, first_phase_ms, second_phase_ms, result_ms);
+    }
+};
+
+double find_event(const Inspector &traces, const char *name) {
+    for (size_t i = 0; i < traces.entries(); ++i) {
+        if (traces[i]["event"].asString() == name) {
+            return traces[i]["timestamp_ms"].asDouble();
+        }
+    }
+    return -1.0;
+}
+
+void set_max(double &dst, double start_ms, double end_ms) {
+    if ((start_ms >= 0.0) && (end_ms >= start_ms)) {
+        dst = std::max(dst, end_ms - start_ms);
+    }
+}
+
+void extract_phases(const std::string &slime_trace, QueryResult &result) {
+    vespalib::Slime slime;
+    vespalib::Memory mem(slime_trace.data(), slime_trace.size());
+    if (vespalib::slime::BinaryFormat::decode(mem, slime) != mem.size) {
+        return;
+    }
+    const Inspector &traces = slime.get()["traces"];
+    set_max(result.setup_ms, find_event(traces, "MTF: Start"), find_event(traces, "MTF: Complete"));
+    for (size_t i = 0; i < traces.entries(); ++i) {
+        if (traces[i]["tag"].asString() == "match_threads") {
+            const Inspector &threads = traces[i]["threads"];
+            for (size_t j = 0; j < threads.entries(); ++j) {
+                const Inspector &events = threads[j]["traces"];
+                double first_start = find_event(events, "Start match and first phase rank");
+                double second_start = find_event(events, "Start second phase rerank");
+                double result_start = find_event(events, "Create result set");
+                double done = find_event(events, "MatchThread::run Done");
+                set_max(result.first_phase_ms, first_start, (second_start >= 0.0) ? second_start : result_start);
+                set_max(result.second_phase_ms, second_start, result_start);
+                set_max(result.result_ms, result_start, done);
+            }
+        }
+    }
+}
+
+double percentile(std::vector<double> values, double p) {
+    if (values.empty()) {
+        return 0.0;
+    }
+    std::sort(values.begin(), values.end());
+    size_t idx = std::min(values.size() - 1, size_t(p * values.size()));
+    return values[idx];
+}
+
+struct Summary {
+    size_t num_ok;
+    size_t num_failed;
+    std::vector<double> latencies;
+    Summary() : num_ok(0), num_failed(0), latencies() {}
+    void add(const QueryResult &result) {
+        if (result.ok) {
+            ++num_ok;
+            latencies.push_back(result.latency_ms);
+        } else {
+            ++num_failed;
+        }
+    }
+    double avg() const {
+        double sum = 0.0;
+        for (double latency: latencies) {
+            sum += latency;
+        }
+        return latencies.empty() ? 0.0 : (sum / latencies.size());
+    }
+    void print(FILE *out, const char *name) const {
+        fprintf(out, "%s: %zu ok, %zu failed, latency ms avg %.3f, 50%% %.3f, 95%% %.3f, 99%% %.3f\n",
+                name, num_ok, num_failed, avg(), percentile(latencies, 0.50),
+                percentile(latencies, 0.95), percentile(latencies, 0.99));
+    }
+};
+
+} // namespace <unnamed>
+
+class App : public FastOS_Application
+{
+private:
+    vespalib::string _captureFile;
+    vespalib::string _spec;
+    vespalib::string _outputFile;
+    vespalib::string _baselineFile;
+    uint32_t         _concurrency;
+    uint32_t         _repeat;
+    int32_t          _traceLevel;
+    double           _timeout;
+
+    void usage();
+    bool parseOpts();
+    std::vector<ProtoSearchRequest> loadRequests() const;
+    std::vector<QueryResult> replay(const std::vector<ProtoSearchRequest> &requests);
+    bool readBaseline(std::vector<QueryResult> &baseline) const;
+    void compare(const std::vector<QueryResult> &baseline, const std::vector<QueryResult> &results) const;
+public:
+    App();
+    ~App() override;
+    int Main() override;
+};
+
+App::App()
+    : _captureFile(),
+      _spec(),
+      _outputFile(),
+      _baselineFile(),
+      _concurrency(1),
+      _repeat(1),
+      _traceLevel(0),
+      _timeout(10.0)
+{
+}
+
+App::~App() = default;
+
+void
+App::usage()
+{
+    fprintf(stderr, "Replays search requests captured by a search node (search.capture in proton config)\n");
+    fprintf(stderr, "against a search node, using the protobuf search protocol over rpc.\n");
+    fprintf(stderr, "Usage: %s [options] <capture-file> <spec>\n", _argv[0]);
+    fprintf(stderr, "\n");
+    fprintf(stderr, "  spec           rpc spec of the search node, like tcp/localhost:19106\n");
+    fprintf(stderr, "  -c concurrency number of queries in flight (default 1)\n");
+    fprintf(stderr, "  -r repeat      replay each query this many times, keeping the fastest (default 1)\n");
+    fprintf(stderr, "  -t tracelevel  trace level to use, 4 or more gives match phase times (default 0)\n");
+    fprintf(stderr, "  -T timeout     query timeout in seconds (default 10)\n");
+    fprintf(stderr, "  -o file        write per query results to file instead of stdout\n");
+    fprintf(stderr, "  -b file        compare with per query results from an earlier run\n");
+    fprintf(stderr, "\n");
+    fprintf(stderr, "Per query results are written as tab separated lines:\n");
+    fprintf(stderr, "  index status latency_ms total_hits coverage_docs setup_ms first_phase_ms second_phase_ms result_ms\n");
+    fprintf(stderr, "Phase times are -1 when not available.\n");
+}
+
+bool
+App::parseOpts()
+{
+    int c;
+    const char *optArg = nullptr;
+    int optInd = 0;
+    while ((c = GetOpt("c:r:t:T:o:b:h", optArg, optInd)) != -1) {
+        switch (c) {
+        case 'c':
+            _concurrency = std::max(atoi(optArg), 1);
+            break;
+        case 'r':
+            _repeat = std::max(atoi(optArg), 1);
+            break;
+        case 't':
+            _traceLevel = atoi(optArg);
+            break;
+        case 'T':
+            _timeout = atof(optArg);
+            break;
+        case 'o':
+            _outputFile = optArg;
+            break;
+        case 'b':
+            _baselineFile = optArg;
+            break;
+        default:
+            return false;
+        }
+    }
+    if (_argc != optInd + 2) {
+        return false;
+    }
+    _captureFile = _argv[optInd];
+    _spec = _argv[optInd + 1];
+    return true;
+}
+
+std::vector<ProtoSearchRequest>
+App::loadRequests() const
+{
+    std::vector<ProtoSearchRequest> requests;
+    SearchRequestCapture::read_file(_captureFile, [this, &requests](ProtoSearchRequest &request)
+                                    {
+                                        if (_traceLevel > 0) {
+                                            request.set_trace_level(_traceLevel);
+                                        }
+                                        requests.push_back(std::move(request));
+                                    });
+    return requests;
+}
+
+std::vector<QueryResult>
+App::replay(const std::vector<ProtoSearchRequest> &requests)
+{
+    fnet::frt::StandaloneFRT frt;
+    FRT_Target *target = frt.supervisor().GetTarget(_spec.c_str());
+    std::vector<QueryResult> results(requests.size());
+    std::mutex lock;
+    std::atomic<size_t> next(0);
+    size_t total = requests.size() * _repeat;
+    auto worker = [&]()
+                  {
+                      for (size_t i = next++; i < total; i = next++) {
+                          size_t idx = (i % requests.size());
+                          FRT_RPCRequest *rpc = frt.supervisor().AllocRPCRequest();
+                          ProtoRpcAdapter::encode_search_request(requests[idx], *rpc);
+                          vespalib::Timer timer;
+                          target->InvokeSync(rpc, _timeout);
+                          QueryResult result;
+                          result.latency_ms = vespalib::to_s(timer.elapsed()) * 1000.0;
+                          ProtoSearchReply reply;
+                          if (!rpc->IsError() && ProtoRpcAdapter::decode_search_reply(*rpc, reply)) {
+                              result.ok = true;
+                              result.total_hits = reply.total_hit_count();
+                              result.coverage_docs = reply.coverage_docs();
+                              extract_phases(reply.slime_trace(), result);
+                          }
+                          rpc->SubRef();
+                          std::lock_guard<std::mutex> guard(lock);
+                          QueryResult &best = results[idx];
+                          if (result.ok && (!best.ok || (result.latency_ms < best.latency_ms))) {
+                              best = result;
+                          }
+                      }
+                  };
+    std::vector<std::thread> threads;
+    for (uint32_t i = 0; i < _concurrency; ++i) {
+        threads.emplace_back(worker);
+    }
+    for (auto &thread: threads) {
+        thread.join();
+    }
+    target->SubRef();
+    return results;
+}
+
+bool
+App::readBaseline(std::vector<QueryResult> &baseline) const
+{
+    FILE *file = fopen(_baselineFile.c_str(), "r");
+    if (file == nullptr) {
+        fprintf(stderr, "could not open baseline file: %s\n", _baselineFile.c_str());
+        return false;
+    }
+    char line[1024];
+    while (fgets(line, sizeof(line), file) != nullptr) {
+        size_t idx;
+        QueryResult result;
+        if (result.parse(line, idx)) {
+            if (idx >= baseline.size()) {
+                baseline.resize(idx + 1);
+            }
+            baseline[idx] = result;
+        }
+    }
+    fclose(file);
+    return true;
+}
+
+void
+App::compare(const std::vector<QueryResult> &baseline, const std::vector<QueryResult> &results) const
+{
+    Summary before;
+    Summary after;
+    size_t hits_changed = 0;
+    size_t coverage_changed = 0;
+    std::vector<double> deltas;
+    size_t n = std::min(baseline.size(), results.size());
+    if (baseline.size() != results.size()) {
+        fprintf(stderr, "warning: baseline has %zu queries, this run has %zu\n", baseline.size(), results.size());
+    }
+    for (size_t i = 0; i < n; ++i) {
+        const QueryResult &a = baseline[i];
+        const QueryResult &b = results[i];
+        if (a.ok && b.ok) {
+            before.add(a);
+            after.add(b);
+            deltas.push_back(b.latency_ms - a.latency_ms);
+            if (a.total_hits != b.total_hits) {
+                ++hits_changed;
+                fprintf(stderr, "query %zu: total hits changed from %" PRId64 " to %" PRId64 "\n",
+                        i, a.total_hits, b.total_hits);
+            }
+            if (a.coverage_docs != b.coverage_docs) {
+                ++coverage_changed;
+            }
+        } else if (a.ok != b.ok) {
+            fprintf(stderr, "query %zu: status changed from %s to %s\n",
+                    i, a.ok ? "OK" : "FAILED", b.ok ? "OK" : "FAILED");
+        }
+    }
+    before.print(stderr, "baseline");
+    after.print(stderr, "current ");
+    fprintf(stderr, "latency delta ms per query: 50%% %.3f, 95%% %.3f, 99%% %.3f\n",
+            percentile(deltas, 0.50), percentile(deltas, 0.95), percentile(deltas, 0.99));
+    fprintf(stderr, "queries with changed total hits: %zu, changed coverage: %zu\n",
+            hits_changed, coverage_changed);
+}
+
+int
+App::Main()
+{
+    if (!parseOpts()) {
+        usage();
+        return 1;
+    }
+    std::vector<QueryResult> baseline;
+    if (!_baselineFile.empty() && !readBaseline(baseline)) {
+        return 1;
+    }
+    std::vector<ProtoSearchRequest> requests = loadRequests();
+    if (requests.empty()) {
+        fprintf(stderr, "no search requests found in capture file: %s\n", _captureFile.c_str());
+        return 1;
+    }
+    FILE *out = stdout;
+    if (!_outputFile.empty()) {
+        out = fopen(_outputFile.c_str(), "w");
+        if (out == nullptr) {
+            fprintf(stderr, "could not open output file: %s\n", _outputFile.c_str());
+            return 1;
+        }
+    }
+    fprintf(stderr, "replaying %zu queries %u time(s) against %s with concurrency %u\n",
+            requests.size(), _repeat, _spec.c_str(), _concurrency);
+    std::vector<QueryResult> results = replay(requests);
+    Summary summary;
+    for (size_t i = 0; i < results.size(); ++i) {
+        results[i].print(out, i);
+        summary.add(results[i]);
+    }
+    if (out != stdout) {
+        fclose(out);
+    }
+    summary.print(stderr, "summary");
+    if (!baseline.empty()) {
+        compare(baseline, results);
+    }
+    return (summary.num_failed == 0) ? 0 : 1;
+}
+
+int main(int argc, char **argv) {
+    App app;
+    return app.Entry(argc, argv);
+}
@@ -9,6 +9,7 @@
 #include <vespa/document/repo/documenttyperepo.h>
 #include <vespa/document/select/cloningvisitor.h>
 #include <vespa/document/select/parser.h>
+#include <vespa/searchcore/proton/common/attribute_select_filter.h>
 #include <vespa/searchcore/proton/common/cachedselect.h>
 #include <vespa/searchcore/proton/common/selectcontext.h>
 #include <vespa/searchlib/attribute/attributecontext.h>
@@ -20,6 +21,7 @@
 #include <vespa/searchlib/attribute/singlenumericenumattribute.hpp>
 #include <vespa/searchlib/attribute/singlenumericpostattribute.h>
 #include <vespa/searchlib/attribute/singlenumericpostattribute.hpp>
+#include <vespa/searchlib/common/bitvector.h>
 #include <vespa/searchlib/test/mock_attribute_manager.h>
 #include <vespa/vespalib/testkit/testapp.h>
 
@@ -43,6 +45,7 @@ using document::select::Context;
 using document::select::Node;
 using document::select::Result;
 using document::select::ResultSet;
+using proton::AttributeSelectFilter;
 using proton::CachedSelect;
 using proton::SelectContext;
 using search::AttributeContext;
@@ -50,6 +53,7 @@ using search::AttributeFactory;
 using search::AttributeGuard;
 using search::AttributePosting;
 using search::AttributeVector;
+using search::BitVector;
 using search::EnumAttribute;
 using search::IntegerAttribute;
 using search::IntegerAttributeTemplate;
@@ -598,6 +602,49 @@ TEST_F("Test that single value attribute with complex attribute field results in
     TEST_DO(checkSelect(cs, f.db().getDoc(3u), Result::False));
 }
 
+TEST_F("Test that attribute only selections are evaluated in bulk", TestFixture)
+{
+    MyDB &db(*f._db);
+
+    db.addDoc(1u, "id:ns:test::1", "hello", "null", 45, 37);
+    db.addDoc(2u, "id:ns:test::2", "gotcha", "foo", 3, 25);
+    db.addDoc(3u, "id:ns:test::3", "gotcha", "foo", noIntVal, noIntVal);
+    db.addDoc(4u, "id:ns:test::4", "null", "foo", 50, 7);
+
+    std::vector<uint32_t> lids({4u, 1u, 3u, 2u, 1u});
+    for (const char *selection : {"test.aa < 45", "test.aa <= 45", "45 > test.aa", "test.aa == 3",
+                                  "test.aa != 3", "test.aa > 2.5", "test.aa < now()", "test.aa > now() - 3600",
+                                  "test.aa < 10 or test.aa > 47", "test.aa > 2 and test.aa < 46",
+                                  "test.aa > 40 and true"})
+    {
+        TEST_STATE(selection);
+        CachedSelect::SP cs = f.testParse(selection, "test");
+        ASSERT_TRUE(cs->preDocOnlySelect());
+        auto session = cs->createSession();
+        const AttributeSelectFilter *filter = session->attributeFilter();
+        ASSERT_TRUE(filter != nullptr);
+        BitVector::UP result = BitVector::create(lids.size());
+        filter->evaluate(lids, *result);
+        SelectContext ctx(*cs);
+        ctx.getAttributeGuards();
+        for (size_t i = 0; i < lids.size(); ++i) {
+            ctx._docId = lids[i];
+            EXPECT_EQUAL(session->contains(ctx), result->testBit(i));
+        }
+    }
+}
+
+TEST_F("Test that bulk evaluation is not used when selection depends on document", TestFixture)
+{
+    for (const char *selection : {"test.aa == 3 AND test.ia == \"foo\"", "test.aa == 3 AND test.aaa[0] == 5",
+                                  "test.aa == 3 AND id.user == 1"})
+    {
+        TEST_STATE(selection);
+        CachedSelect::SP cs = f.testParse(selection, "test");
+        EXPECT_TRUE(cs->createSession()->attributeFilter() == nullptr);
+    }
+}
+
 TEST_F("Test performance when using attributes", TestFixture)
 {
     MyDB &db(*f._db);
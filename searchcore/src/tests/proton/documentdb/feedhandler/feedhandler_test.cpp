@@ -30,6 +30,7 @@
 #include <vespa/vespalib/testkit/testapp.h>
 #include <vespa/vespalib/util/lambdatask.h>
 #include <vespa/vespalib/util/exceptions.h>
+#include <vespa/vespalib/util/stringfmt.h>
 #include <vespa/vespalib/io/fileutil.h>
 
 #include <vespa/log/log.h>
@@ -435,13 +436,24 @@ struct PutHandler {
 struct MyTlsWriter : TlsWriter {
     int store_count;
     int erase_count;
+    int flush_count;
+    int batch_size;
+    int batch_size_at_sync;
     bool erase_return;
 
-    MyTlsWriter() : store_count(0), erase_count(0), erase_return(true) {}
-    void storeOperation(const FeedOperation &, DoneCallback) override { ++store_count; }
+    MyTlsWriter() : store_count(0), erase_count(0), flush_count(0), batch_size(0), batch_size_at_sync(0), erase_return(true) {}
+    void storeOperation(const FeedOperation &, DoneCallback) override { flush(); ++store_count; }
+    void appendOperation(const FeedOperation &, DoneCallback) override { ++store_count; ++batch_size; }
+    void flush() override {
+        if (batch_size > 0) {
+            ++flush_count;
+            batch_size = 0;
+        }
+    }
     bool erase(SerialNum) override { ++erase_count; return erase_return; }
 
     SerialNum sync(SerialNum syncTo) override {
+        batch_size_at_sync = batch_size;
         return syncTo;
     } 
 };
@@ -813,6 +825,45 @@ TEST_F("require that put with different document type repo is ok", FeedHandlerFi
     EXPECT_EQUAL(1, f.tls_writer.store_count);
 }
 
+TEST_F("require that consecutive feed operations are stored in one transaction log batch", FeedHandlerFixture)
+{
+    f.handler.changeToNormalFeedState();
+    PutHandler putHandler(f.handler, *f.schema.builder);
+    vespalib::Gate gate;
+    f.writeService.master().execute(makeLambdaTask([&gate]() { gate.await(); }));
+    for (uint32_t i = 0; i < 5; ++i) {
+        putHandler.put(vespalib::make_string("id:ns:searchdocument::%u", i));
+    }
+    gate.countDown();
+    EXPECT_TRUE(putHandler.await());
+    f.syncMaster();
+    EXPECT_EQUAL(5, f.feedView.put_count);
+    EXPECT_EQUAL(5, f.tls_writer.store_count);
+    EXPECT_EQUAL(1, f.tls_writer.flush_count);
+
+    putHandler.put("id:ns:searchdocument::5");
+    EXPECT_TRUE(putHandler.await());
+    f.syncMaster();
+    EXPECT_EQUAL(6, f.tls_writer.store_count);
+    EXPECT_EQUAL(2, f.tls_writer.flush_count);
+}
+
+TEST_F("require that sync in master thread flushes pending transaction log batch", FeedHandlerFixture)
+{
+    f.handler.changeToNormalFeedState();
+    PutHandler putHandler(f.handler, *f.schema.builder);
+    vespalib::Gate gate;
+    f.writeService.master().execute(makeLambdaTask([&gate]() { gate.await(); }));
+    putHandler.put("id:ns:searchdocument::0");
+    f.writeService.master().execute(makeLambdaTask([&f]() { f.handler.syncTls(f.handler.getSerialNum()); }));
+    gate.countDown();
+    EXPECT_TRUE(putHandler.await());
+    f.syncMaster();
+    EXPECT_EQUAL(1, f.tls_writer.store_count);
+    EXPECT_EQUAL(1, f.tls_writer.flush_count);
+    EXPECT_EQUAL(0, f.tls_writer.batch_size_at_sync);
+}
+
 }  // namespace
 
 TEST_MAIN()
@@ -13,15 +13,16 @@ using ProtonConfigBuilder = vespa::config::search::core::ProtonConfigBuilder;
 
 struct Fixture {
     ProtonConfig cfg;
-    Fixture(uint32_t baseLineIndexingThreads = 2)
-        : cfg(makeConfig(baseLineIndexingThreads))
+    Fixture(uint32_t baseLineIndexingThreads = 2, bool lockFreeFieldWriter = false)
+        : cfg(makeConfig(baseLineIndexingThreads, lockFreeFieldWriter))
     {
     }
-    ProtonConfig makeConfig(uint32_t baseLineIndexingThreads) {
+    ProtonConfig makeConfig(uint32_t baseLineIndexingThreads, bool lockFreeFieldWriter) {
         ProtonConfigBuilder builder;
         builder.indexing.threads = baseLineIndexingThreads;
         builder.indexing.tasklimit = 500;
         builder.indexing.semiunboundtasklimit = 50000;
+        builder.indexing.lockfreefieldwriter = lockFreeFieldWriter;
         return builder;
     }
     ThreadingServiceConfig make(uint32_t cpuCores) {
@@ -59,6 +60,16 @@ TEST_F("require that semiunbound task limit is scaled based on indexing threads"
     EXPECT_EQUAL(12500u, f.make(24).semiUnboundTaskLimit());
 }
 
+TEST_F("require that lock free field writer is off by default", Fixture)
+{
+    EXPECT_FALSE(f.make(24).lockFreeFieldWriter());
+}
+
+TEST_F("require that lock free field writer is set from config", Fixture(2, true))
+{
+    EXPECT_TRUE(f.make(24).lockFreeFieldWriter());
+}
+
 TEST_MAIN()
 {
     TEST_RUN_ALL();
@@ -46,6 +46,19 @@ public:
     virtual void run() override { _log.append(_name); }
 };
 
+class SizedTask : public NamedTask
+{
+    uint64_t _size;
+public:
+    SizedTask(const vespalib::string &name, TestLog &log, uint64_t size)
+        : NamedTask(name, log),
+          _size(size)
+    {
+    }
+
+    uint64_t getEstimatedLoadSize() const override { return _size; }
+};
+
 
 struct TestJob {
     TestLog::UP _log;
@@ -79,6 +92,19 @@ struct TestJob {
         B->addDependency(D);
         return TestJob(std::move(log), std::move(C));
     }
+
+    static TestJob setupSizedDependees()
+    {
+        TestLog::UP log = std::make_unique<TestLog>();
+        InitializerTask::SP A(std::make_shared<SizedTask>("A", *log, 10));
+        InitializerTask::SP B(std::make_shared<SizedTask>("B", *log, 30));
+        InitializerTask::SP C(std::make_shared<SizedTask>("C", *log, 20));
+        InitializerTask::SP D(std::make_shared<NamedTask>("D", *log));
+        D->addDependency(A);
+        D->addDependency(B);
+        D->addDependency(C);
+        return TestJob(std::move(log), std::move(D));
+    }
 };
 
 TestJob::TestJob(TestLog::UP log, InitializerTask::SP root)
@@ -119,6 +145,13 @@ TEST_F("1 thread, dag graph", Fixture(1))
     }
 }
 
+TEST_F("1 thread, largest ready task is started first", Fixture(1))
+{
+    TestJob job = TestJob::setupSizedDependees();
+    f.run(job._root);
+    EXPECT_EQUAL("BCAD", job._log->result());
+}
+
 TEST_F("multiple threads, dag graph", Fixture(10))
 {
     int dabc_count = 0;
@@ -0,0 +1,88 @@
+// Copyright 2019 Oath Inc. Licensed under the terms of the Apache 2.0 license. See LICENSE in the project root.
+
+#include <vespa/vespalib/testkit/test_kit.h>
+#include <vespa/searchcore/proton/matching/query.h>
+#include <vespa/searchcore/proton/matching/querynodes.h>
+#include <vespa/searchcore/proton/matching/viewresolver.h>
+#include <vespa/searchlib/fef/test/indexenvironment.h>
+#include <vespa/searchlib/query/tree/querybuilder.h>
+#include <vespa/searchlib/query/tree/stackdumpcreator.h>
+#include <vespa/vespalib/util/benchmark_timer.h>
+#include <vespa/vespalib/util/stringfmt.h>
+
+using namespace proton::matching;
+using search::fef::FieldInfo;
+using search::fef::FieldType;
+using search::fef::test::IndexEnvironment;
+using search::query::QueryBuilder;
+using search::query::StackDumpCreator;
+using search::query::Weight;
+using vespalib::BenchmarkTimer;
+using vespalib::make_string;
+using CollectionType = FieldInfo::CollectionType;
+
+// Measures the part of query setup that depends on the query shape and
+// not on the index or attribute snapshots: parsing the stack dump and
+// resolving views to fields. Views are resolved either by name for
+// every term, or from the fields pre-resolved when the matcher is
+// created.
+
+struct Fixture {
+    IndexEnvironment indexEnv;
+    ViewResolver resolver;
+    Fixture(uint32_t numFields, uint32_t numViews) : indexEnv(), resolver() {
+        for (uint32_t i = 0; i < numFields; ++i) {
+            indexEnv.getFields().push_back(FieldInfo(FieldType::INDEX, CollectionType::SINGLE,
+                                                     make_string("field%u", i), i));
+        }
+        for (uint32_t view = 0; view < numViews; ++view) {
+            for (uint32_t i = view; i < numFields; i += numViews) {
+                resolver.add(make_string("view%u", view), make_string("field%u", i));
+            }
+        }
+        for (uint32_t i = 0; i < numFields; i += 2) {
+            resolver.add("default", make_string("field%u", i));
+        }
+    }
+};
+
+vespalib::string makeStackDump(uint32_t numTerms, uint32_t numViews) {
+    QueryBuilder<ProtonNodeTypes> builder;
+    builder.addAnd(numTerms);
+    for (uint32_t i = 0; i < numTerms; ++i) {
+        vespalib::string view = (i % 3 == 0) ? vespalib::string("") : make_string("view%u", i % numViews);
+        builder.addStringTerm(make_string("term%u", i), view, i, Weight(100));
+    }
+    return StackDumpCreator::create(*builder.build());
+}
+
+double measureBuildTree(const vespalib::string &stackDump, const ViewResolver &resolver,
+                        const IndexEnvironment &indexEnv)
+{
+    Query check;
+    EXPECT_TRUE(check.buildTree(stackDump, "", resolver, indexEnv));
+    return BenchmarkTimer::benchmark([&]() {
+                                         Query query;
+                                         bool ok = query.buildTree(stackDump, "", resolver, indexEnv);
+                                         (void) ok;
+                                     }, 1.0);
+}
+
+TEST("measure query setup with views resolved by name and pre-resolved") {
+    for (uint32_t numFields : {4, 32}) {
+        for (uint32_t numTerms : {2, 8, 32}) {
+            uint32_t numViews = 4;
+            Fixture f(numFields, numViews);
+            vespalib::string stackDump = makeStackDump(numTerms, numViews);
+            double byName = measureBuildTree(stackDump, f.resolver, f.indexEnv);
+            ViewResolver preResolved = f.resolver;
+            preResolved.resolveFields(f.indexEnv);
+            double cached = measureBuildTree(stackDump, preResolved, f.indexEnv);
+            fprintf(stderr, "fields %u, terms %u: by name %g us, pre-resolved %g us (speedup %.2f)\n",
+                    numFields, numTerms, byName * 1000.0 * 1000.0, cached * 1000.0 * 1000.0,
+                    (cached > 0.0) ? (byName / cached) : 0.0);
+        }
+    }
+}
+
+TEST_MAIN() { TEST_RUN_ALL(); }
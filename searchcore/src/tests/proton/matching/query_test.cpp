@@ -119,6 +119,7 @@ class Test : public vespalib::TestApp {
     void requireThatSameElementTermsAreProperlyPrefixed();
     void requireThatSameElementDoesNotAllocateMatchData();
     void requireThatSameElementIteratorsCanBeBuilt();
+    void requireThatPreResolvedViewsGiveSameFields();
 
 public:
     ~Test() override;
@@ -1069,6 +1070,47 @@ Test::requireThatSameElementIteratorsCanBeBuilt() {
     EXPECT_TRUE(iterator->seek(8));
 }
 
+void verifyResolvedFields(ViewResolver &resolver, const search::fef::IIndexEnvironment &idxEnv,
+                          const string &view, bool usePositionData)
+{
+    const string &name = view.empty() ? "default" : view;
+    ProtonStringTerm expect(string_term, view, 1, Weight(2));
+    expect.setPositionData(usePositionData);
+    expect.resolve(resolver, idxEnv);
+    EXPECT_TRUE(resolver.lookupFields(name, idxEnv) == nullptr);
+    resolver.resolveFields(idxEnv);
+    EXPECT_TRUE(resolver.lookupFields(name, idxEnv) != nullptr);
+    ProtonStringTerm actual(string_term, view, 1, Weight(2));
+    actual.setPositionData(usePositionData);
+    actual.resolve(resolver, idxEnv);
+    ASSERT_EQUAL(expect.numFields(), actual.numFields());
+    for (size_t i = 0; i < actual.numFields(); ++i) {
+        EXPECT_EQUAL(expect.field(i).field_name, actual.field(i).field_name);
+        EXPECT_EQUAL(expect.field(i).getFieldId(), actual.field(i).getFieldId());
+        EXPECT_EQUAL(expect.field(i).attribute_field, actual.field(i).attribute_field);
+        EXPECT_EQUAL(expect.field(i).filter_field, actual.field(i).filter_field);
+    }
+    resolver.add("other_view", field);
+    EXPECT_TRUE(resolver.lookupFields(name, idxEnv) == nullptr);
+}
+
+void Test::requireThatPreResolvedViewsGiveSameFields() {
+    for (bool usePositionData : {true, false}) {
+        ViewResolver resolver = getViewResolver();
+        TEST_DO(verifyResolvedFields(resolver, resolved_index_env, field, usePositionData));
+        ViewResolver plain;
+        TEST_DO(verifyResolvedFields(plain, plain_index_env, field, usePositionData));
+        ViewResolver attribute;
+        TEST_DO(verifyResolvedFields(attribute, attribute_index_env, field, usePositionData));
+        ViewResolver empty;
+        TEST_DO(verifyResolvedFields(empty, plain_index_env, "", usePositionData));
+    }
+    ViewResolver resolver = getViewResolver();
+    resolver.resolveFields(resolved_index_env);
+    EXPECT_TRUE(resolver.lookupFields(field, plain_index_env) == nullptr);
+    EXPECT_TRUE(resolver.lookupFields(unknown_field, resolved_index_env) == nullptr);
+}
+
 Test::~Test() = default;
 
 int
@@ -1107,6 +1149,7 @@ Test::Main()
     TEST_CALL(requireThatSameElementTermsAreProperlyPrefixed);
     TEST_CALL(requireThatSameElementDoesNotAllocateMatchData);
     TEST_CALL(requireThatSameElementIteratorsCanBeBuilt);
+    TEST_CALL(requireThatPreResolvedViewsGiveSameFields);
 
     TEST_DONE();
 }
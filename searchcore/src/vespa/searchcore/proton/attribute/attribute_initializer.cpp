@@ -9,6 +9,7 @@
 #include <vespa/vespalib/stllike/asciistream.h>
 #include <vespa/vespalib/io/fileutil.h>
 #include <vespa/searchlib/util/fileutil.h>
+#include <vespa/searchlib/util/dirtraverse.h>
 #include <vespa/searchlib/attribute/attribute_header.h>
 #include <vespa/searchlib/attribute/attributevector.h>
 #include <vespa/fastos/file.h>
@@ -229,6 +230,18 @@ AttributeInitializer::AttributeInitializer(const std::shared_ptr<AttributeDirect
 
 AttributeInitializer::~AttributeInitializer() = default;
 
+uint64_t
+AttributeInitializer::getEstimatedLoadSize() const
+{
+    search::SerialNum serialNum = _attrDir->getFlushedSerialNum();
+    if (_attrDir->empty() || serialNum == 0) {
+        return 0u;
+    }
+    vespalib::string snapshotDir = vespalib::dirname(_attrDir->getAttributeFileName(serialNum));
+    search::DirectoryTraverse dirt(snapshotDir.c_str());
+    return dirt.GetTreeSize();
+}
+
 AttributeInitializerResult
 AttributeInitializer::init() const
 {
@@ -47,6 +47,12 @@ public:
 
     AttributeInitializerResult init() const;
     uint64_t getCurrentSerialNum() const { return _currentSerialNum; }
+
+    /**
+     * Returns the disk size of the attribute snapshot to be loaded,
+     * or 0 if there is nothing to load.
+     **/
+    uint64_t getEstimatedLoadSize() const;
 };
 
 } // namespace proton
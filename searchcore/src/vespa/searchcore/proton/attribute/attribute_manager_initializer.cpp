@@ -23,6 +23,7 @@ private:
     AttributeInitializer::UP _initializer;
     DocumentMetaStore::SP _documentMetaStore;
     InitializedAttributesResult &_result;
+    uint64_t _estimatedLoadSize;
 
 public:
     AttributeInitializerTask(AttributeInitializer::UP initializer,
@@ -30,7 +31,8 @@ public:
                              InitializedAttributesResult &result)
         : _initializer(std::move(initializer)),
           _documentMetaStore(documentMetaStore),
-          _result(result)
+          _result(result),
+          _estimatedLoadSize(_initializer->getEstimatedLoadSize())
     {}
 
     void run() override {
@@ -42,6 +44,10 @@ public:
             _result.add(result);
         }
     }
+
+    uint64_t getEstimatedLoadSize() const override {
+        return _estimatedLoadSize;
+    }
 };
 
 class AttributeManagerInitializerTask : public vespalib::Executor::Task
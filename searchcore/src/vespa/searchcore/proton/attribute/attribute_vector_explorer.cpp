@@ -10,6 +10,7 @@
 using search::attribute::Status;
 using search::AddressSpaceUsage;
 using search::AttributeVector;
+using search::CacheStats;
 using search::IEnumStore;
 using vespalib::AddressSpace;
 using vespalib::MemoryUsage;
@@ -95,10 +96,21 @@ convertChangeVectorToSlime(const AttributeVector &v, Cursor &object)
     convertMemoryUsageToSlime(usage, object);
 }
 
+void
+convertCacheStatsToSlime(const CacheStats &stats, Cursor &object)
+{
+    object.setLong("hits", stats.hits);
+    object.setLong("misses", stats.misses);
+    object.setLong("elements", stats.elements);
+    object.setLong("memoryUsed", stats.memory_used);
+    object.setLong("invalidations", stats.invalidations);
+}
+
 void
 convertPostingBaseToSlime(const IPostingListAttributeBase &postingBase, Cursor &object)
 {
     convertMemoryUsageToSlime(postingBase.getMemoryUsage(), object.setObject("memoryUsage"));
+    convertCacheStatsToSlime(postingBase.getSearchCacheStats(), object.setObject("searchCache"));
 }
 
 }
@@ -0,0 +1,261 @@
+// Copyright 2019 Oath Inc. Licensed under the terms of the Apache 2.0 license. See LICENSE in the project root.
+
+#include "attribute_select_filter.h"
+#include "attributefieldvaluenode.h"
+#include <vespa/document/select/branch.h>
+#include <vespa/document/select/compare.h>
+#include <vespa/document/select/constant.h>
+#include <vespa/document/select/context.h>
+#include <vespa/document/select/traversingvisitor.h>
+#include <vespa/document/select/value.h>
+#include <vespa/searchlib/attribute/attributevector.h>
+#include <vespa/searchlib/common/bitvector.h>
+
+namespace proton {
+
+using document::select::And;
+using document::select::Compare;
+using document::select::Constant;
+using document::select::FieldValueNode;
+using document::select::FloatValue;
+using document::select::FunctionOperator;
+using document::select::IdValueNode;
+using document::select::IntegerValue;
+using document::select::Node;
+using document::select::Operator;
+using document::select::Or;
+using document::select::Value;
+using document::select::ValueNode;
+using document::select::VariableValueNode;
+using search::AttributeVector;
+using search::BitVector;
+
+namespace {
+
+/*
+ * Detects value expressions depending on the document, i.e. anything
+ * but constants, now() and arithmetic on those.
+ */
+class DocumentDependencyDetector : public document::select::TraversingVisitor
+{
+public:
+    bool _dependsOnDocument;
+
+    DocumentDependencyDetector() : _dependsOnDocument(false) {}
+    void visitIdValueNode(const IdValueNode &) override { _dependsOnDocument = true; }
+    void visitFieldValueNode(const FieldValueNode &) override { _dependsOnDocument = true; }
+    void visitVariableValueNode(const VariableValueNode &) override { _dependsOnDocument = true; }
+};
+
+bool
+isConstant(const ValueNode &node)
+{
+    DocumentDependencyDetector detector;
+    node.visit(detector);
+    return !detector._dependsOnDocument;
+}
+
+enum class CompareOp { LT, LEQ, GT, GEQ, EQ, NE };
+
+bool
+resolveOperator(const Operator &op, bool swapped, CompareOp &result)
+{
+    if (op == FunctionOperator::EQ) {
+        result = CompareOp::EQ;
+    } else if (op == FunctionOperator::NE) {
+        result = CompareOp::NE;
+    } else if (op == FunctionOperator::LT) {
+        result = swapped ? CompareOp::GT : CompareOp::LT;
+    } else if (op == FunctionOperator::LEQ) {
+        result = swapped ? CompareOp::GEQ : CompareOp::LEQ;
+    } else if (op == FunctionOperator::GT) {
+        result = swapped ? CompareOp::LT : CompareOp::GT;
+    } else if (op == FunctionOperator::GEQ) {
+        result = swapped ? CompareOp::LEQ : CompareOp::GEQ;
+    } else {
+        return false;
+    }
+    return true;
+}
+
+template <typename T>
+bool
+compare(CompareOp op, T lhs, T rhs)
+{
+    switch (op) {
+    case CompareOp::LT:  return lhs < rhs;
+    case CompareOp::LEQ: return lhs <= rhs;
+    case CompareOp::GT:  return lhs > rhs;
+    case CompareOp::GEQ: return lhs >= rhs;
+    case CompareOp::EQ:  return lhs == rhs;
+    case CompareOp::NE:  return lhs != rhs;
+    }
+    return false;
+}
+
+class ConstantFilter : public AttributeSelectFilter
+{
+    bool _value;
+public:
+    explicit ConstantFilter(bool value) : _value(value) {}
+    void evaluate(const LidVector &lids, BitVector &result) const override {
+        if (_value) {
+            result.setInterval(0, lids.size());
+        } else {
+            result.clear();
+        }
+    }
+};
+
+/*
+ * Compares an attribute value with a constant. Documents without a
+ * value in the attribute give null, which only matches '!='.
+ */
+template <typename T>
+class CompareFilter : public AttributeSelectFilter
+{
+    const AttributeVector &_attribute;
+    CompareOp              _op;
+    T                      _constant;
+
+    static T getValue(const AttributeVector &attribute, uint32_t lid);
+public:
+    CompareFilter(const AttributeVector &attribute, CompareOp op, T constant)
+        : _attribute(attribute),
+          _op(op),
+          _constant(constant)
+    {}
+    void evaluate(const LidVector &lids, BitVector &result) const override {
+        result.clear();
+        for (size_t i = 0; i < lids.size(); ++i) {
+            uint32_t lid = lids[i];
+            bool hit = _attribute.isUndefined(lid)
+                       ? (_op == CompareOp::NE)
+                       : compare(_op, getValue(_attribute, lid), _constant);
+            if (hit) {
+                result.setBit(i);
+            }
+        }
+        result.invalidateCachedCount();
+    }
+};
+
+template <>
+int64_t
+CompareFilter<int64_t>::getValue(const AttributeVector &attribute, uint32_t lid)
+{
+    return attribute.getInt(lid);
+}
+
+template <>
+double
+CompareFilter<double>::getValue(const AttributeVector &attribute, uint32_t lid)
+{
+    return attribute.getFloat(lid);
+}
+
+class AndFilter : public AttributeSelectFilter
+{
+    std::unique_ptr<AttributeSelectFilter> _left;
+    std::unique_ptr<AttributeSelectFilter> _right;
+public:
+    AndFilter(std::unique_ptr<AttributeSelectFilter> left, std::unique_ptr<AttributeSelectFilter> right)
+        : _left(std::move(left)),
+          _right(std::move(right))
+    {}
+    void evaluate(const LidVector &lids, BitVector &result) const override {
+        _left->evaluate(lids, result);
+        if (result.countTrueBits() == 0) {
+            return;
+        }
+        BitVector::UP rhs = BitVector::create(lids.size());
+        _right->evaluate(lids, *rhs);
+        result.andWith(*rhs);
+    }
+};
+
+class OrFilter : public AttributeSelectFilter
+{
+    std::unique_ptr<AttributeSelectFilter> _left;
+    std::unique_ptr<AttributeSelectFilter> _right;
+public:
+    OrFilter(std::unique_ptr<AttributeSelectFilter> left, std::unique_ptr<AttributeSelectFilter> right)
+        : _left(std::move(left)),
+          _right(std::move(right))
+    {}
+    void evaluate(const LidVector &lids, BitVector &result) const override {
+        _left->evaluate(lids, result);
+        if (result.countTrueBits() == lids.size()) {
+            return;
+        }
+        BitVector::UP rhs = BitVector::create(lids.size());
+        _right->evaluate(lids, *rhs);
+        result.orWith(*rhs);
+    }
+};
+
+std::unique_ptr<AttributeSelectFilter>
+createCompareFilter(const Compare &node)
+{
+    const ValueNode *attrNode = &node.getLeft();
+    const ValueNode *constNode = &node.getRight();
+    bool swapped = false;
+    if (dynamic_cast<const AttributeFieldValueNode *>(attrNode) == nullptr) {
+        std::swap(attrNode, constNode);
+        swapped = true;
+    }
+    const auto *attrField = dynamic_cast<const AttributeFieldValueNode *>(attrNode);
+    CompareOp op;
+    if ((attrField == nullptr) || !isConstant(*constNode) || !resolveOperator(node.getOperator(), swapped, op)) {
+        return std::unique_ptr<AttributeSelectFilter>();
+    }
+    const AttributeVector &attribute = *attrField->getAttribute();
+    std::unique_ptr<Value> constant = constNode->getValue(document::select::Context());
+    if (attribute.isIntegerType() && (constant->getType() == Value::Integer)) {
+        return std::make_unique<CompareFilter<int64_t>>(attribute, op,
+                                                        static_cast<const IntegerValue &>(*constant).getValue());
+    }
+    if (attribute.isIntegerType() || attribute.isFloatingPointType()) {
+        if (constant->getType() == Value::Integer) {
+            return std::make_unique<CompareFilter<double>>(attribute, op,
+                                                           static_cast<const IntegerValue &>(*constant).getValue());
+        }
+        if (constant->getType() == Value::Float) {
+            return std::make_unique<CompareFilter<double>>(attribute, op,
+                                                           static_cast<const FloatValue &>(*constant).getValue());
+        }
+    }
+    return std::unique_ptr<AttributeSelectFilter>();
+}
+
+}
+
+std::unique_ptr<AttributeSelectFilter>
+AttributeSelectFilter::create(const Node &selection)
+{
+    if (const auto *andNode = dynamic_cast<const And *>(&selection)) {
+        auto left = create(andNode->getLeft());
+        auto right = create(andNode->getRight());
+        if (!left || !right) {
+            return std::unique_ptr<AttributeSelectFilter>();
+        }
+        return std::make_unique<AndFilter>(std::move(left), std::move(right));
+    }
+    if (const auto *orNode = dynamic_cast<const Or *>(&selection)) {
+        auto left = create(orNode->getLeft());
+        auto right = create(orNode->getRight());
+        if (!left || !right) {
+            return std::unique_ptr<AttributeSelectFilter>();
+        }
+        return std::make_unique<OrFilter>(std::move(left), std::move(right));
+    }
+    if (const auto *constant = dynamic_cast<const Constant *>(&selection)) {
+        return std::make_unique<ConstantFilter>(constant->getConstantValue());
+    }
+    if (const auto *compare = dynamic_cast<const Compare *>(&selection)) {
+        return createCompareFilter(*compare);
+    }
+    return std::unique_ptr<AttributeSelectFilter>();
+}
+
+}
@@ -0,0 +1,49 @@
+// Copyright 2019 Oath Inc. Licensed under the terms of the Apache 2.0 license. See LICENSE in the project root.
+#pragma once
+
+#include <memory>
+#include <vector>
+
+namespace document::select { class Node; }
+namespace search { class BitVector; }
+
+namespace proton {
+
+/**
+ * Evaluates a document selection for many documents at a time, used
+ * when garbage collecting or visiting a bucket.
+ *
+ * The selection is compiled into comparisons between a single value
+ * numeric attribute and a constant (e.g. "test.timestamp < now() - 3600"),
+ * combined with 'and' and 'or'. Each comparison is evaluated for all
+ * the given documents in one loop over the attribute, avoiding the
+ * value allocations and tree walk done per document by
+ * document::select::Node::contains().
+ *
+ * A document is selected if the selection evaluates to true for it,
+ * matching how CachedSelect::Session uses the selection.
+ */
+class AttributeSelectFilter
+{
+public:
+    using LidVector = std::vector<uint32_t>;
+
+    virtual ~AttributeSelectFilter() = default;
+
+    /**
+     * Sets bit i in result if the selection is true for lids[i]. The
+     * result must have size lids.size(). Attribute guards must be held
+     * by the caller.
+     */
+    virtual void evaluate(const LidVector &lids, search::BitVector &result) const = 0;
+
+    /**
+     * Returns a filter for the given selection, or nullptr if it
+     * contains anything not supported. The selection must already be
+     * pruned and have its attribute fields resolved, as done by
+     * CachedSelect for selections only referencing attributes.
+     */
+    static std::unique_ptr<AttributeSelectFilter> create(const document::select::Node &selection);
+};
+
+}
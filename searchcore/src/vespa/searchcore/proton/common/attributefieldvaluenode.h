@@ -16,6 +16,7 @@ public:
                             const vespalib::string& field,
                             const std::shared_ptr<search::AttributeVector> &attribute);
 
+    const std::shared_ptr<search::AttributeVector> &getAttribute() const { return _attribute; }
     std::unique_ptr<document::select::Value> getValue(const Context &context) const override;
     std::unique_ptr<document::select::Value> traceValue(const Context &context, std::ostream& out) const override;
     document::select::ValueNode::UP clone() const override;
@@ -1,5 +1,6 @@
 // Copyright 2017 Yahoo Holdings. Licensed under the terms of the Apache 2.0 license. See LICENSE in the project root.
 
+#include "attribute_select_filter.h"
 #include "attributefieldvaluenode.h"
 #include "cachedselect.h"
 #include "select_utils.h"
@@ -114,10 +115,16 @@ CachedSelect::Session::Session(std::unique_ptr<document::select::Node> docSelect
                                std::unique_ptr<document::select::Node> preDocSelect)
     : _docSelect(std::move(docSelect)),
       _preDocOnlySelect(std::move(preDocOnlySelect)),
-      _preDocSelect(std::move(preDocSelect))
+      _preDocSelect(std::move(preDocSelect)),
+      _attributeFilter()
 {
+    if (_preDocOnlySelect) {
+        _attributeFilter = AttributeSelectFilter::create(*_preDocOnlySelect);
+    }
 }
 
+CachedSelect::Session::~Session() = default;
+
 bool
 CachedSelect::Session::contains(const SelectContext &context) const
 {
@@ -17,6 +17,7 @@ namespace search {
 
 namespace proton {
 
+class AttributeSelectFilter;
 class SelectContext;
 class SelectPruner;
 
@@ -34,14 +35,23 @@ public:
         std::unique_ptr<document::select::Node> _docSelect;
         std::unique_ptr<document::select::Node> _preDocOnlySelect;
         std::unique_ptr<document::select::Node> _preDocSelect;
+        std::unique_ptr<AttributeSelectFilter> _attributeFilter;
 
     public:
         Session(std::unique_ptr<document::select::Node> docSelect,
                 std::unique_ptr<document::select::Node> preDocOnlySelect,
                 std::unique_ptr<document::select::Node> preDocSelect);
+        ~Session();
         bool contains(const SelectContext &context) const;
         bool contains(const document::Document &doc) const;
         const document::select::Node &selectNode() const;
+
+        /**
+         * Returns a filter evaluating the selection for many documents
+         * at a time, or nullptr if the selection does not only reference
+         * single value attributes or cannot be compiled into a filter.
+         */
+        const AttributeSelectFilter *attributeFilter() const { return _attributeFilter.get(); }
     };
 
     using AttributeVectors = std::vector<std::shared_ptr<search::AttributeVector>>;
@@ -7,6 +7,7 @@
 #include <vespa/searchlib/common/location.h>
 #include <vespa/searchlib/common/matching_elements.h>
 #include <vespa/vespalib/data/slime/slime.h>
+#include <vespa/vespalib/data/slime/binary_stream_encoder.h>
 #include <vespa/vespalib/util/stringfmt.h>
 
 #include <vespa/log/log.h>
@@ -15,8 +16,7 @@ LOG_SETUP(".proton.docsummary.docsumcontext");
 using document::PositionDataType;
 using search::common::Location;
 using vespalib::string;
-using vespalib::slime::SymbolTable;
-using vespalib::slime::NIX;
+using vespalib::slime::BinaryStreamEncoder;
 using vespalib::Memory;
 using vespalib::slime::Cursor;
 using vespalib::slime::Symbol;
@@ -68,25 +68,24 @@ DocsumContext::createReply()
     search::RawBuf buf(4096);
     _docsumWriter.InitState(_attrMgr, &_docsumState);
     reply->docsums.resize(_docsumState._docsumcnt);
-    SymbolTable::UP symbols = std::make_unique<SymbolTable>();
     IDocsumWriter::ResolveClassInfo rci = _docsumWriter.resolveClassInfo(_docsumState._args.getResultClassName(), _docsumStore.getSummaryClassId());
+    // Docsums are streamed directly to the buffer, using the field names of the output class as symbol table
+    BinaryStreamEncoder encoder;
     for (uint32_t i = 0; i < _docsumState._docsumcnt; ++i) {
         buf.reset();
         uint32_t docId = _docsumState._docsumbuf[i];
         reply->docsums[i].docid = docId;
         if (docId != search::endDocId && !rci.mustSkip) {
-            Slime slime(Slime::Params(std::move(symbols)));
-            vespalib::slime::SlimeInserter inserter(slime);
+            encoder.reset(&rci.outputClass->getSymbols());
             if (_request.expired()) {
-                inserter.insertString(make_string("Timed out with %" PRId64 "us left.", vespalib::count_us(_request.getTimeLeft())));
+                encoder.writeString(make_string("Timed out with %" PRId64 "us left.", vespalib::count_us(_request.getTimeLeft())));
             } else {
-                _docsumWriter.insertDocsum(rci, docId, &_docsumState, &_docsumStore, slime, inserter);
+                _docsumWriter.writeDocsum(rci, docId, &_docsumState, &_docsumStore, encoder);
             }
-            uint32_t docsumLen = (slime.get().type().getId() != NIX::ID)
-                                   ? IDocsumWriter::slime2RawBuf(slime, buf)
+            uint32_t docsumLen = (!encoder.empty())
+                                   ? IDocsumWriter::encoder2RawBuf(encoder, buf)
                                    : 0;
             reply->docsums[i].setData(buf.GetDrainPos(), docsumLen);
-            symbols = Slime::reclaimSymbols(std::move(slime));
         }
     }
     return reply;
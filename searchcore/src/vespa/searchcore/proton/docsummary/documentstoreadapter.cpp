@@ -2,6 +2,12 @@
 
 #include "documentstoreadapter.h"
 #include <vespa/searchsummary/docsummary/summaryfieldconverter.h>
+#include <vespa/document/fieldvalue/doublefieldvalue.h>
+#include <vespa/document/fieldvalue/floatfieldvalue.h>
+#include <vespa/document/fieldvalue/intfieldvalue.h>
+#include <vespa/document/fieldvalue/longfieldvalue.h>
+#include <vespa/document/fieldvalue/rawfieldvalue.h>
+#include <vespa/document/fieldvalue/shortfieldvalue.h>
 #include <vespa/document/fieldvalue/stringfieldvalue.h>
 #include <vespa/eval/tensor/tensor.h>
 #include <vespa/eval/tensor/serialization/typed_binary_format.h>
@@ -21,6 +27,26 @@ namespace {
 
 const vespalib::string DOCUMENT_ID_FIELD("documentid");
 
+/**
+ * Returns whether the given field value must go through the summary field converter before
+ * being written, or if it can be written directly from the value deserialized from the store.
+ * Plain strings, raw and most numeric values are written as is, avoiding a copy of the value.
+ **/
+bool
+needsConversion(bool markup, const FieldValue &value)
+{
+    uint32_t classId = value.getClass().id();
+    if (classId == StringFieldValue::classId) {
+        return markup;
+    }
+    return ! ((classId == IntFieldValue::classId) ||
+              (classId == LongFieldValue::classId) ||
+              (classId == ShortFieldValue::classId) ||
+              (classId == FloatFieldValue::classId) ||
+              (classId == DoubleFieldValue::classId) ||
+              (classId == RawFieldValue::classId));
+}
+
 }
 
 bool
@@ -106,7 +132,7 @@ DocumentStoreAdapter::convertFromSearchDoc(Document &doc, uint32_t docId)
 {
     for (size_t i = 0; i < _resultClass->GetNumEntries(); ++i) {
         const ResConfigEntry * entry = _resultClass->GetEntry(i);
-        const vespalib::string fieldName(entry->_bindname);
+        const vespalib::string &fieldName(entry->_bindname);
         bool markup = _markupFields.find(fieldName) != _markupFields.end();
         if (fieldName == DOCUMENT_ID_FIELD) {
             StringFieldValue value(doc.getId().toString());
@@ -130,6 +156,12 @@ DocumentStoreAdapter::convertFromSearchDoc(Document &doc, uint32_t docId)
             continue;
         }
         LOG(spam, "writeField(%s): value(%s), type(%d)", fieldName.c_str(), fieldValue->toString().c_str(), entry->_type);
+        if ( ! needsConversion(markup, *fieldValue)) {
+            if (!writeField(*fieldValue, entry->_type)) {
+                LOG(warning, "Error while writing field '%s' for docId %u", fieldName.c_str(), docId);
+            }
+            continue;
+        }
         FieldValue::UP convertedFieldValue = SummaryFieldConverter::convertSummaryField(markup, *fieldValue);
         if (convertedFieldValue) {
             if (!writeField(*convertedFieldValue, entry->_type)) {
@@ -18,4 +18,10 @@ InitializerTask::addDependency(SP dependency)
     _dependencies.emplace_back(std::move(dependency));
 }
 
+uint64_t
+InitializerTask::getEstimatedLoadSize() const
+{
+    return 0u;
+}
+
 }
@@ -1,6 +1,7 @@
 // Copyright 2017 Yahoo Holdings. Licensed under the terms of the Apache 2.0 license. See LICENSE in the project root.
 #pragma once
 
+#include <cstdint>
 #include <memory>
 #include <vector>
 
@@ -31,6 +32,12 @@ public:
     void setDone() { _state = State::DONE; }
     void addDependency(SP dependency);
     virtual void run() = 0;
+    /*
+     * Returns an estimate of the number of bytes read from disk by this task.
+     * Ready tasks are started largest first, to avoid having a large task
+     * started last determine the total initialization time.
+     */
+    virtual uint64_t getEstimatedLoadSize() const;
 };
 
 }
@@ -3,6 +3,7 @@
 #include "task_runner.h"
 #include <vespa/vespalib/util/lambdatask.h>
 #include <vespa/vespalib/util/threadstackexecutor.h>
+#include <algorithm>
 #include <future>
 
 using vespalib::makeLambdaTask;
@@ -110,6 +111,9 @@ TaskRunner::pollTask(Context::SP context)
     TaskList readyTasks;
     TaskSet checked;
     getReadyTasks(context->rootTask(), readyTasks, checked);
+    std::stable_sort(readyTasks.begin(), readyTasks.end(),
+                     [](const auto &lhs, const auto &rhs)
+                     { return lhs->getEstimatedLoadSize() > rhs->getEstimatedLoadSize(); });
     internalRunTasks(readyTasks, context);
 }
 
@@ -118,6 +118,7 @@ Matcher::Matcher(const search::index::Schema &schema, const Properties &props, c
     if (!_rankSetup->compile()) {
         throw vespalib::IllegalArgumentException("failed to compile rank setup", VESPA_STRLOC);
     }
+    _viewResolver.resolveFields(_indexEnv);
 }
 
 MatchingStats
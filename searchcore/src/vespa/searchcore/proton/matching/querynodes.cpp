@@ -41,24 +41,40 @@ ProtonTermData::propagate_document_frequency(uint32_t matching_doc_count, uint32
     }
 }
 
+void
+ProtonTermData::addField(const FieldInfo &info, bool forceFilter)
+{
+    _fields.push_back(FieldEntry(info.name(), info.id()));
+    _fields.back().attribute_field =
+        (info.type() == FieldType::ATTRIBUTE) ||
+        (info.type() == FieldType::HIDDEN_ATTRIBUTE);
+    _fields.back().filter_field = forceFilter ? true : info.isFilter();
+}
+
 void
 ProtonTermData::resolve(const ViewResolver &resolver,
                         const IIndexEnvironment &idxEnv,
                         const string &view,
                         bool forceFilter)
 {
-    std::vector<string> fields;
-    resolver.resolve(((view == "") ? "default" : view), fields);
+    static const string default_view("default");
+    const string &name = view.empty() ? default_view : view;
     _fields.clear();
+    const ViewResolver::FieldInfos *infos = resolver.lookupFields(name, idxEnv);
+    if (infos != nullptr) {
+        _fields.reserve(infos->size());
+        for (const FieldInfo *info : *infos) {
+            addField(*info, forceFilter);
+        }
+        return;
+    }
+    std::vector<string> fields;
+    resolver.resolve(name, fields);
     _fields.reserve(fields.size());
     for (size_t i = 0; i < fields.size(); ++i) {
         const FieldInfo *info = idxEnv.getFieldByName(fields[i]);
         if (info != 0) {
-            _fields.push_back(FieldEntry(fields[i], info->id()));
-            _fields.back().attribute_field =
-                (info->type() == FieldType::ATTRIBUTE) ||
-                (info->type() == FieldType::HIDDEN_ATTRIBUTE);
-            _fields.back().filter_field = forceFilter ? true : info->isFilter();
+            addField(*info, forceFilter);
         } else {
             LOG(debug, "ignoring undefined field: '%s'", fields[i].c_str());
         }
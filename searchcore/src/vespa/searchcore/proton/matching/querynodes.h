@@ -48,6 +48,7 @@ private:
     std::vector<FieldEntry> _fields;
 
     void propagate_document_frequency(uint32_t matching_count_doc, uint32_t total_doc_count);
+    void addField(const search::fef::FieldInfo &info, bool forceFilter);
 
 protected:
     void resolve(const ViewResolver &resolver,
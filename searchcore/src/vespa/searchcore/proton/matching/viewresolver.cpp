@@ -2,6 +2,8 @@
 
 #include "viewresolver.h"
 #include <vespa/searchcommon/common/schema.h>
+#include <vespa/searchlib/fef/fieldinfo.h>
+#include <vespa/searchlib/fef/iindexenvironment.h>
 
 namespace proton::matching {
 
@@ -10,6 +12,8 @@ ViewResolver::add(vespalib::stringref view,
                   vespalib::stringref field)
 {
     _map[view].push_back(field);
+    _resolved.clear();
+    _resolvedEnv = nullptr;
     return *this;
 }
 
@@ -26,6 +30,45 @@ ViewResolver::resolve(vespalib::stringref view,
     return true;
 }
 
+ViewResolver &
+ViewResolver::resolveFields(const search::fef::IIndexEnvironment &indexEnv)
+{
+    std::vector<vespalib::string> views;
+    for (const auto &entry : _map) {
+        views.push_back(entry.first);
+    }
+    for (uint32_t i = 0; i < indexEnv.getNumFields(); ++i) {
+        views.push_back(indexEnv.getField(i)->name());
+    }
+    views.push_back("default");
+    _resolved.clear();
+    for (const auto &view : views) {
+        std::vector<vespalib::string> fields;
+        resolve(view, fields);
+        FieldInfos &infos = _resolved[view];
+        infos.clear();
+        for (const auto &field : fields) {
+            const search::fef::FieldInfo *info = indexEnv.getFieldByName(field);
+            if (info != nullptr) {
+                infos.push_back(info);
+            }
+        }
+    }
+    _resolvedEnv = &indexEnv;
+    return *this;
+}
+
+const ViewResolver::FieldInfos *
+ViewResolver::lookupFields(const vespalib::string &view,
+                           const search::fef::IIndexEnvironment &indexEnv) const
+{
+    if (_resolvedEnv != &indexEnv) {
+        return nullptr;
+    }
+    ResolvedMap::const_iterator pos = _resolved.find(view);
+    return (pos != _resolved.end()) ? &pos->second : nullptr;
+}
+
 ViewResolver
 ViewResolver::createFromSchema(const search::index::Schema &schema)
 {
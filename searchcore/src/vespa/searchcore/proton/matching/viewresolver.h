@@ -7,6 +7,10 @@
 #include <map>
 
 namespace search::index { class Schema; }
+namespace search::fef {
+class FieldInfo;
+class IIndexEnvironment;
+}
 
 namespace proton::matching {
 
@@ -19,9 +23,15 @@ namespace proton::matching {
  **/
 class ViewResolver
 {
+public:
+    typedef std::vector<const search::fef::FieldInfo *> FieldInfos;
+
 private:
     typedef std::map<vespalib::string, std::vector<vespalib::string> > Map;
-    Map _map;
+    typedef std::map<vespalib::string, FieldInfos> ResolvedMap;
+    Map                                    _map;
+    ResolvedMap                            _resolved;
+    const search::fef::IIndexEnvironment * _resolvedEnv = nullptr;
 
 public:
     /**
@@ -50,6 +60,32 @@ public:
     bool resolve(vespalib::stringref view,
                  std::vector<vespalib::string> &fields) const;
 
+    /**
+     * Resolve all views defined in this resolver, all fields in the
+     * given index environment and the default view into the field
+     * infos they refer to. This lets query terms be resolved without
+     * copying the field names of a view and looking up each field by
+     * name for every query. Adding a view afterwards drops the
+     * pre-resolved fields. The index environment must outlive this
+     * object and must not change its fields.
+     *
+     * @return this object, for chaining
+     * @param indexEnv the index environment used to resolve queries
+     **/
+    ViewResolver &resolveFields(const search::fef::IIndexEnvironment &indexEnv);
+
+    /**
+     * Look up the pre-resolved fields of a view. Fields not found in
+     * the index environment are not included.
+     *
+     * @return the fields of the view, or nullptr if the view was not
+     *         pre-resolved against the given index environment
+     * @param view the name of the view
+     * @param indexEnv the index environment used to resolve the query
+     **/
+    const FieldInfos *lookupFields(const vespalib::string &view,
+                                   const search::fef::IIndexEnvironment &indexEnv) const;
+
     /**
      * Create a view resolver based on the field collections defined
      * in the given schema. View definitions should be completely
@@ -1,6 +1,8 @@
 // Copyright 2017 Yahoo Holdings. Licensed under the terms of the Apache 2.0 license. See LICENSE in the project root.
 
 #include "document_iterator.h"
+#include <vespa/searchcore/proton/common/attribute_select_filter.h>
+#include <vespa/searchlib/common/bitvector.h>
 #include <vespa/document/select/gid_filter.h>
 #include <vespa/document/select/node.h>
 #include <vespa/document/fieldvalue/document.h>
@@ -176,6 +178,44 @@ public:
         }
         return _selectSession->contains(*_selectCxt);
     }
+
+    /**
+     * Removes the candidates (indexes into metaData) not matching the
+     * selection. Selections only referencing attributes are evaluated
+     * for all the candidates in one go when possible.
+     */
+    void match(const search::DocumentMetaData::Vector & metaData, std::vector<uint32_t> & candidates) const {
+        const AttributeSelectFilter *filter = _selectSession ? _selectSession->attributeFilter() : nullptr;
+        if ((filter == nullptr) || _dscTrue || _metaOnly) {
+            auto end = std::remove_if(candidates.begin(), candidates.end(),
+                                      [&](uint32_t i) { return !match(metaData[i]); });
+            candidates.erase(end, candidates.end());
+            return;
+        }
+        std::vector<uint32_t> prefiltered;
+        AttributeSelectFilter::LidVector lids;
+        prefiltered.reserve(candidates.size());
+        lids.reserve(candidates.size());
+        for (uint32_t i : candidates) {
+            const search::DocumentMetaData & meta = metaData[i];
+            if ((meta.lid < _docidLimit) && _gidFilter.gid_might_match_selection(meta.gid)) {
+                prefiltered.push_back(i);
+                lids.push_back(meta.lid);
+            }
+        }
+        candidates.clear();
+        if (lids.empty()) {
+            return;
+        }
+        search::BitVector::UP hits = search::BitVector::create(lids.size());
+        filter->evaluate(lids, *hits);
+        for (size_t j(0); j < lids.size(); ++j) {
+            if (hits->testBit(j)) {
+                candidates.push_back(prefiltered[j]);
+            }
+        }
+    }
+
     bool match(const search::DocumentMetaData & meta, const Document * doc) const {
         if (_dscTrue || _metaOnly) {
             return true;
@@ -253,17 +293,22 @@ DocumentIterator::fetchCompleteSource(const IDocumentRetriever & source, Iterate
         return;
     }
 
+    std::vector<uint32_t> candidates;
+    candidates.reserve(metaData.size());
+    for (size_t i(0); i < metaData.size(); i++) {
+        if (checkMeta(metaData[i])) {
+            candidates.push_back(i);
+        }
+    }
+    matcher.match(metaData, candidates);
+
     LidIndexMap lidIndexMap(3*metaData.size());
     IDocumentRetriever::LidVector lidsToFetch;
-    lidsToFetch.reserve(metaData.size());
-    for (size_t i(0); i < metaData.size(); i++) {
+    lidsToFetch.reserve(candidates.size());
+    for (uint32_t i : candidates) {
         const search::DocumentMetaData & meta = metaData[i];
-        if (checkMeta(meta)) {
-            if (matcher.match(meta)) {
-                lidsToFetch.emplace_back(meta.lid);
-                lidIndexMap[meta.lid] = i;
-            }
-        }
+        lidsToFetch.emplace_back(meta.lid);
+        lidIndexMap[meta.lid] = i;
     }
     LOG(debug, "metadata count after filtering: %zu", lidsToFetch.size());
 
@@ -122,7 +122,8 @@ DocumentDB::DocumentDB(const vespalib::string &baseDir,
                        const FileHeaderContext &fileHeaderContext,
                        ConfigStore::UP config_store,
                        InitializeThreads initializeThreads,
-                       const HwInfo &hwInfo)
+                       const HwInfo &hwInfo,
+                       SharedFieldWriterExecutors *sharedFieldWriters)
     : DocumentDBConfigOwner(),
       IReplayConfig(),
       IFeedHandlerOwner(),
@@ -140,7 +141,9 @@ DocumentDB::DocumentDB(const vespalib::string &baseDir,
       _writeService(sharedExecutor,
                     _writeServiceConfig.indexingThreads(),
                     indexing_thread_stack_size,
-                    _writeServiceConfig.defaultTaskLimit()),
+                    _writeServiceConfig.defaultTaskLimit(),
+                    sharedFieldWriters,
+                    _writeServiceConfig.lockFreeFieldWriter()),
       _initializeThreads(std::move(initializeThreads)),
       _initConfigSnapshot(),
       _initConfigSerialNum(0u),
@@ -48,6 +48,7 @@ class IDocumentDBOwner;
 struct MetricsWireService;
 class StatusReport;
 class ExecutorThreadingServiceStats;
+class SharedFieldWriterExecutors;
 
 namespace matching { class SessionManager; }
 
@@ -236,6 +237,8 @@ public:
      * @param protonCfg The global proton config this database is a part of.
      * @param tuneFileDocumentDB file tune config for this database.
      * @param config_store Access to read and write configs.
+     * @param sharedFieldWriters Field writer executors shared with other
+     *                           databases, or nullptr to use separate ones.
      */
     DocumentDB(const vespalib::string &baseDir,
                const DocumentDBConfig::SP &currentSnapshot,
@@ -253,7 +256,8 @@ public:
                const search::common::FileHeaderContext &fileHeaderContext,
                ConfigStore::UP config_store,
                InitializeThreads initializeThreads,
-               const HwInfo &hwInfo);
+               const HwInfo &hwInfo,
+               SharedFieldWriterExecutors *sharedFieldWriters = nullptr);
 
     /**
      * Expose a cost view of the session manager. This is used by the
@@ -1,16 +1,24 @@
 // Copyright 2017 Yahoo Holdings. Licensed under the terms of the Apache 2.0 license. See LICENSE in the project root.
 
 #include "executorthreadingservice.h"
+#include "shared_field_writer_executors.h"
 #include <vespa/searchcore/proton/metrics/executor_threading_service_stats.h>
+#include <vespa/searchlib/common/lockfreesequencedtaskexecutor.h>
 #include <vespa/searchlib/common/sequencedtaskexecutor.h>
+#include <vespa/searchlib/common/sequencedtaskexecutorview.h>
 
 using vespalib::ThreadStackExecutorBase;
+using search::ISequencedTaskExecutor;
+using search::LockFreeSequencedTaskExecutor;
 using search::SequencedTaskExecutor;
+using search::SequencedTaskExecutorView;
 
 namespace proton {
 
 ExecutorThreadingService::ExecutorThreadingService(vespalib::ThreadStackExecutorBase & sharedExecutor,
-                                                   uint32_t threads, uint32_t stackSize, uint32_t taskLimit)
+                                                   uint32_t threads, uint32_t stackSize, uint32_t taskLimit,
+                                                   SharedFieldWriterExecutors *sharedFieldWriters,
+                                                   bool lockFreeFieldWriters)
 
     : _sharedExecutor(sharedExecutor),
       _masterExecutor(1, stackSize),
@@ -19,14 +27,37 @@ ExecutorThreadingService::ExecutorThreadingService(vespalib::ThreadStackExecutor
       _masterService(_masterExecutor),
       _indexService(_indexExecutor),
       _summaryService(_summaryExecutor),
-      _indexFieldInverter(std::make_unique<SequencedTaskExecutor>(threads, taskLimit)),
-      _indexFieldWriter(std::make_unique<SequencedTaskExecutor>(threads, taskLimit)),
-      _attributeFieldWriter(std::make_unique<SequencedTaskExecutor>(threads, taskLimit))
+      _indexFieldInverter(),
+      _indexFieldWriter(),
+      _attributeFieldWriter()
 {
+    if (sharedFieldWriters != nullptr) {
+        uint32_t numExecutors = sharedFieldWriters->getNumExecutors();
+        uint32_t offset = sharedFieldWriters->nextOffset();
+        _indexFieldInverter = std::make_unique<SequencedTaskExecutorView>(sharedFieldWriters->indexFieldInverter(),
+                                                                          numExecutors, offset, taskLimit);
+        _indexFieldWriter = std::make_unique<SequencedTaskExecutorView>(sharedFieldWriters->indexFieldWriter(),
+                                                                        numExecutors, offset, taskLimit);
+        _attributeFieldWriter = std::make_unique<SequencedTaskExecutorView>(sharedFieldWriters->attributeFieldWriter(),
+                                                                            numExecutors, offset, taskLimit);
+    } else {
+        _indexFieldInverter = createFieldWriter(threads, taskLimit, lockFreeFieldWriters);
+        _indexFieldWriter = createFieldWriter(threads, taskLimit, lockFreeFieldWriters);
+        _attributeFieldWriter = createFieldWriter(threads, taskLimit, lockFreeFieldWriters);
+    }
 }
 
 ExecutorThreadingService::~ExecutorThreadingService() = default;
 
+std::unique_ptr<ISequencedTaskExecutor>
+ExecutorThreadingService::createFieldWriter(uint32_t threads, uint32_t taskLimit, bool lockFree)
+{
+    if (lockFree) {
+        return std::make_unique<LockFreeSequencedTaskExecutor>(threads, taskLimit);
+    }
+    return std::make_unique<SequencedTaskExecutor>(threads, taskLimit);
+}
+
 vespalib::Syncable &
 ExecutorThreadingService::sync()
 {
@@ -6,10 +6,11 @@
 #include <vespa/vespalib/util/blockingthreadstackexecutor.h>
 #include <vespa/vespalib/util/threadstackexecutor.h>
 
-namespace search { class SequencedTaskExecutor; }
+namespace search { class ISequencedTaskExecutor; }
 namespace proton {
 
 class ExecutorThreadingServiceStats;
+class SharedFieldWriterExecutors;
 
 /**
  * Implementation of IThreadingService using 2 underlying thread stack executors
@@ -25,9 +26,9 @@ private:
     ExecutorThreadService _masterService;
     ExecutorThreadService _indexService;
     ExecutorThreadService _summaryService;
-    std::unique_ptr<search::SequencedTaskExecutor> _indexFieldInverter;
-    std::unique_ptr<search::SequencedTaskExecutor> _indexFieldWriter;
-    std::unique_ptr<search::SequencedTaskExecutor> _attributeFieldWriter;
+    std::unique_ptr<search::ISequencedTaskExecutor> _indexFieldInverter;
+    std::unique_ptr<search::ISequencedTaskExecutor> _indexFieldWriter;
+    std::unique_ptr<search::ISequencedTaskExecutor> _attributeFieldWriter;
 
 public:
     /**
@@ -35,13 +36,22 @@ public:
      *
      * @stackSize The size of the stack of the underlying executors.
      * @taskLimit The task limit for the index executor.
+     * @sharedFieldWriters If set, the field writers are views of these
+     *                     executors instead of separate executors.
+     * @lockFreeFieldWriters If set, separate field writers use lock free
+     *                       task queues.
      */
     ExecutorThreadingService(vespalib::ThreadStackExecutorBase &sharedExecutor,
                              uint32_t threads = 1,
                              uint32_t stackSize = 128 * 1024,
-                             uint32_t taskLimit = 1000);
+                             uint32_t taskLimit = 1000,
+                             SharedFieldWriterExecutors *sharedFieldWriters = nullptr,
+                             bool lockFreeFieldWriters = false);
     ~ExecutorThreadingService() override;
 
+    static std::unique_ptr<search::ISequencedTaskExecutor>
+    createFieldWriter(uint32_t threads, uint32_t taskLimit, bool lockFree);
+
     /**
      * Implements vespalib::Syncable
      */
@@ -50,11 +50,63 @@ ignoreOperation(const DocumentOperation &op) {
     return (op.getPrevTimestamp() != 0) && (op.getTimestamp() < op.getPrevTimestamp());
 }
 
+/**
+ * Keeps the done callbacks of a batch of operations until the batch
+ * has been committed to the transaction log.
+ */
+struct BatchDoneCallback : public search::IDestructorCallback {
+    std::vector<TlsWriter::DoneCallback> _callbacks;
+    explicit BatchDoneCallback(std::vector<TlsWriter::DoneCallback> callbacks)
+        : _callbacks(std::move(callbacks))
+    { }
+    ~BatchDoneCallback() override;
+};
+
+BatchDoneCallback::~BatchDoneCallback() = default;
+
 }  // namespace
 
+FeedHandler::TlsMgrWriter::TlsMgrWriter(TransactionLogManager &tls_mgr,
+                                        search::transactionlog::Writer * tlsDirectWriter)
+    : _tls_mgr(tls_mgr),
+      _tlsDirectWriter(tlsDirectWriter),
+      _batch(),
+      _batchDone()
+{ }
+
+FeedHandler::TlsMgrWriter::~TlsMgrWriter()
+{
+    assert(_batch.empty());
+}
+
 void FeedHandler::TlsMgrWriter::storeOperation(const FeedOperation &op, DoneCallback onDone) {
+    flush();
     TlcProxy(_tls_mgr.getDomainName(), *_tlsDirectWriter).storeOperation(op, std::move(onDone));
 }
+
+void FeedHandler::TlsMgrWriter::appendOperation(const FeedOperation &op, DoneCallback onDone) {
+    if (!TlcProxy::addOperation(_batch, op)) {
+        flush();
+        bool added = TlcProxy::addOperation(_batch, op);
+        assert(added);
+        (void) added;
+    }
+    if (onDone) {
+        _batchDone.push_back(std::move(onDone));
+    }
+}
+
+void FeedHandler::TlsMgrWriter::flush() {
+    if (_batch.empty()) {
+        return;
+    }
+    LOG(spam, "flush(): committing %zu operations, serial range [%" PRIu64 ", %" PRIu64 "]",
+        _batch.size(), _batch.range().from(), _batch.range().to());
+    _batch.close();
+    TlcProxy(_tls_mgr.getDomainName(), *_tlsDirectWriter).commit(_batch, std::make_shared<BatchDoneCallback>(std::move(_batchDone)));
+    _batch.clear();
+    _batchDone.clear();
+}
 bool FeedHandler::TlsMgrWriter::erase(SerialNum oldest_to_keep) {
     return _tls_mgr.getSession()->erase(oldest_to_keep);
 }
@@ -107,7 +159,7 @@ void FeedHandler::performPut(FeedToken token, PutOperation &op) {
     if (_repo != op.getDocument()->getRepo()) {
         op.deserializeDocument(*_repo);
     }
-    storeOperation(op, token);
+    appendOperation(op, token);
     if (token) {
         token->setResult(make_unique<Result>(), false);
     }
@@ -140,7 +192,7 @@ FeedHandler::performUpdate(FeedToken token, UpdateOperation &op)
 void
 FeedHandler::performInternalUpdate(FeedToken token, UpdateOperation &op)
 {
-    storeOperation(op, token);
+    appendOperation(op, token);
     if (token) {
         token->setResult(make_unique<UpdateResult>(op.getPrevTimestamp()), true);
     }
@@ -156,7 +208,7 @@ FeedHandler::createNonExistingDocument(FeedToken token, const UpdateOperation &o
     op.getUpdate()->applyTo(*doc);
     PutOperation putOp(op.getBucketId(), op.getTimestamp(), doc);
     _activeFeedView->preparePut(putOp);
-    storeOperation(putOp, token);
+    appendOperation(putOp, token);
     if (token) {
         token->setResult(make_unique<UpdateResult>(putOp.getTimestamp()), true);
     }
@@ -179,7 +231,7 @@ void FeedHandler::performRemove(FeedToken token, RemoveOperation &op) {
     if (op.getPrevDbDocumentId().valid()) {
         assert(op.getValidNewOrPrevDbdId());
         assert(op.notMovingLidInSameSubDb());
-        storeOperation(op, token);
+        appendOperation(op, token);
         if (token) {
             bool documentWasFound = !op.getPrevMarkedAsRemoved();
             token->setResult(make_unique<RemoveResult>(documentWasFound), documentWasFound);
@@ -187,7 +239,7 @@ void FeedHandler::performRemove(FeedToken token, RemoveOperation &op) {
         _activeFeedView->handleRemove(std::move(token), op);
     } else if (op.hasDocType()) {
         assert(op.getDocType() == _docTypeName.getName());
-        storeOperation(op, token);
+        appendOperation(op, token);
         if (token) {
             token->setResult(make_unique<RemoveResult>(false), false);
         }
@@ -208,13 +260,13 @@ FeedHandler::performGarbageCollect(FeedToken token)
 void
 FeedHandler::performCreateBucket(FeedToken token, CreateBucketOperation &op)
 {
-    storeOperation(op, token);
+    appendOperation(op, token);
     _bucketDBHandler->handleCreateBucket(op.getBucketId());
 }
 
 void FeedHandler::performDeleteBucket(FeedToken token, DeleteBucketOperation &op) {
     _activeFeedView->prepareDeleteBucket(op);
-    storeOperation(op, token);
+    appendOperation(op, token);
     // Delete documents in bucket
     _activeFeedView->handleDeleteBucket(op);
     // Delete bucket itself, should no longer have documents.
@@ -223,12 +275,12 @@ void FeedHandler::performDeleteBucket(FeedToken token, DeleteBucketOperation &op
 }
 
 void FeedHandler::performSplit(FeedToken token, SplitBucketOperation &op) {
-    storeOperation(op, token);
+    appendOperation(op, token);
     _bucketDBHandler->handleSplit(op.getSerialNum(), op.getSource(), op.getTarget1(), op.getTarget2());
 }
 
 void FeedHandler::performJoin(FeedToken token, JoinBucketsOperation &op) {
-    storeOperation(op, token);
+    appendOperation(op, token);
     _bucketDBHandler->handleJoin(op.getSerialNum(), op.getSource1(), op.getSource2(), op.getTarget());
 }
 
@@ -359,7 +411,8 @@ FeedHandler::FeedHandler(IThreadingService &writeService,
       _bucketDBHandler(nullptr),
       _syncLock(),
       _syncedSerialNum(0),
-      _allowSync(false)
+      _allowSync(false),
+      _tlsFlushPending(false)
 { }
 
 
@@ -446,6 +499,24 @@ FeedHandler::storeOperation(const FeedOperation &op, TlsWriter::DoneCallback onD
     _tlsWriter.storeOperation(op, std::move(onDone));
 }
 
+void
+FeedHandler::appendOperation(const FeedOperation &op, TlsWriter::DoneCallback onDone) {
+    if (!op.getSerialNum()) {
+        const_cast<FeedOperation &>(op).setSerialNum(incSerialNum());
+    }
+    _tlsWriter.appendOperation(op, std::move(onDone));
+    if (!_tlsFlushPending) {
+        _tlsFlushPending = true;
+        _writeService.master().execute(makeLambdaTask([this]() { performTlsFlush(); }));
+    }
+}
+
+void
+FeedHandler::performTlsFlush() {
+    _tlsFlushPending = false;
+    _tlsWriter.flush();
+}
+
 void
 FeedHandler::storeOperationSync(const FeedOperation &op) {
     vespalib::Gate gate;
@@ -666,6 +737,10 @@ FeedHandler::syncTls(SerialNum syncTo)
     if (!_allowSync) {
         throw IllegalStateException(make_string("Attempted to sync TLS to token %" PRIu64 " at wrong time.", syncTo));
     }
+    if (_writeService.master().isCurrentThread()) {
+        // The pending batch is otherwise flushed by a task queued behind this one.
+        _tlsWriter.flush();
+    }
     SerialNum syncedTo(_tlsWriter.sync(syncTo));
     {
         std::lock_guard<std::mutex> guard(_syncLock);
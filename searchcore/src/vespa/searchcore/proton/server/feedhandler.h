@@ -14,6 +14,7 @@
 #include <vespa/searchcore/proton/common/feedtoken.h>
 #include <vespa/searchlib/transactionlog/translogclient.h>
 #include <mutex>
+#include <vector>
 
 namespace searchcorespi { namespace index { struct IThreadingService; } }
 
@@ -60,13 +61,15 @@ private:
     class TlsMgrWriter : public TlsWriter {
         TransactionLogManager &_tls_mgr;
         search::transactionlog::Writer *_tlsDirectWriter;
+        Packet                          _batch;
+        std::vector<DoneCallback>       _batchDone;
     public:
         TlsMgrWriter(TransactionLogManager &tls_mgr,
-                     search::transactionlog::Writer * tlsDirectWriter) :
-            _tls_mgr(tls_mgr),
-            _tlsDirectWriter(tlsDirectWriter)
-        { }
+                     search::transactionlog::Writer * tlsDirectWriter);
+        ~TlsMgrWriter() override;
         void storeOperation(const FeedOperation &op, DoneCallback onDone) override;
+        void appendOperation(const FeedOperation &op, DoneCallback onDone) override;
+        void flush() override;
         bool erase(SerialNum oldest_to_keep) override;
         SerialNum sync(SerialNum syncTo) override;
     };
@@ -95,6 +98,7 @@ private:
     std::mutex                             _syncLock;
     SerialNum                              _syncedSerialNum; 
     bool                                   _allowSync; // Sanity check
+    bool                                   _tlsFlushPending; // used by master write thread tasks
 
     /**
      * Delayed handling of feed operations, in master write thread.
@@ -102,6 +106,15 @@ private:
      */
     void doHandleOperation(FeedToken token, FeedOperationUP op);
 
+    /**
+     * Store a feed operation in the current transaction log batch, in
+     * master write thread. The batch is flushed by a master write thread
+     * task scheduled behind the tasks already queued, so operations that
+     * arrive back to back are written to the transaction log together.
+     */
+    void appendOperation(const FeedOperation &op, DoneCallback onDone);
+    void performTlsFlush();
+
     bool considerWriteOperationForRejection(FeedToken & token, const FeedOperation &op);
     bool considerUpdateOperationForRejection(FeedToken &token, UpdateOperation &op);
 
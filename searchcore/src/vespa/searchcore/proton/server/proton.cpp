@@ -12,6 +12,7 @@
 #include "proton_disk_layout.h"
 #include "resource_usage_explorer.h"
 #include "searchhandlerproxy.h"
+#include "shared_field_writer_executors.h"
 #include "simpleflush.h"
 
 #include <vespa/searchcore/proton/flushengine/flushengine.h>
@@ -211,6 +212,7 @@ Proton::Proton(const config::ConfigUri & configUri,
       _protonConfigFetcher(configUri, _protonConfigurer, subscribeTimeout),
       _warmupExecutor(),
       _sharedExecutor(),
+      _sharedFieldWriters(),
       _queryLimiter(),
       _clock(0.001),
       _threadPool(128 * 1024),
@@ -301,6 +303,14 @@ Proton::init(const BootstrapConfig::SP & configSnapshot)
 
     const size_t sharedThreads = deriveCompactionCompressionThreads(protonConfig, hwInfo.cpu());
     _sharedExecutor = std::make_unique<vespalib::BlockingThreadStackExecutor>(sharedThreads, 128*1024, sharedThreads*16, proton_shared_executor);
+    if (protonConfig.indexing.sharedfieldwriter) {
+        // Document dbs limit their own pending tasks, the shared limit only guards against unbounded growth.
+        uint32_t fieldWriterThreads = std::max((uint32_t)std::ceil(hwInfo.cpu().cores() * protonConfig.feeding.concurrency),
+                                               (uint32_t)std::max(protonConfig.indexing.threads, 1));
+        _sharedFieldWriters = std::make_unique<SharedFieldWriterExecutors>(fieldWriterThreads,
+                                                                           std::max(protonConfig.indexing.semiunboundtasklimit, 1),
+                                                                           protonConfig.indexing.lockfreefieldwriter);
+    }
     InitializeThreads initializeThreads;
     if (protonConfig.initialize.threads > 0) {
         initializeThreads = std::make_shared<vespalib::ThreadStackExecutor>(protonConfig.initialize.threads, 128 * 1024, initialize_executor);
@@ -312,6 +322,9 @@ Proton::init(const BootstrapConfig::SP & configSnapshot)
     _prepareRestartHandler = std::make_unique<PrepareRestartHandler>(*_flushEngine);
     RPCHooks::Params rpcParams(*this, protonConfig.rpcport, _configUri.getConfigId());
     rpcParams.slobrok_config = _configUri.createWithNewId(protonConfig.slobrokconfigid);
+    rpcParams.searchCaptureFile = protonConfig.search.capture.file;
+    rpcParams.searchCaptureSampleEvery = std::max(protonConfig.search.capture.sampleevery, 0);
+    rpcParams.searchCaptureMaxFileSize = std::max(protonConfig.search.capture.maxfilesize, int64_t(0));
     _rpcHooks = std::make_unique<RPCHooks>(rpcParams);
     _metricsEngine->addExternalMetrics(_rpcHooks->proto_rpc_adapter_metrics());
 
@@ -453,6 +466,7 @@ Proton::~Proton()
     _persistenceEngine.reset();
     _tls.reset();
     _warmupExecutor.reset();
+    _sharedFieldWriters.reset();
     _sharedExecutor.reset();
     _clock.stop();
     LOG(debug, "Explicit destructor done");
@@ -572,7 +586,7 @@ Proton::addDocumentDB(const document::DocumentType &docType,
                                             _queryLimiter, _clock, docTypeName, bucketSpace, config, *this,
                                             *_warmupExecutor, *_sharedExecutor, *_tls->getTransLogServer(),
                                             *_metricsEngine, _fileHeaderContext, std::move(config_store),
-                                            initializeThreads, bootstrapConfig->getHwInfo());
+                                            initializeThreads, bootstrapConfig->getHwInfo(), _sharedFieldWriters.get());
     try {
         ret->start();
     } catch (vespalib::Exception &e) {
@@ -37,6 +37,7 @@ class DiskMemUsageSampler;
 class IDocumentDBReferenceRegistry;
 class IProtonDiskLayout;
 class PrepareRestartHandler;
+class SharedFieldWriterExecutors;
 class SummaryEngine;
 class DocsumBySlime;
 class FlushEngine;
@@ -112,6 +113,7 @@ private:
     ProtonConfigFetcher             _protonConfigFetcher;
     std::unique_ptr<vespalib::ThreadStackExecutorBase> _warmupExecutor;
     std::unique_ptr<vespalib::ThreadStackExecutorBase> _sharedExecutor;
+    std::unique_ptr<SharedFieldWriterExecutors> _sharedFieldWriters;
     matching::QueryLimiter          _queryLimiter;
     vespalib::Clock                 _clock;
     FastOS_ThreadPool               _threadPool;
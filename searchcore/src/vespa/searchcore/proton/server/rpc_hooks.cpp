@@ -186,7 +186,10 @@ RPCHooksBase::Params::Params(Proton &parent, uint32_t port, const vespalib::stri
     : proton(parent),
       slobrok_config(config::ConfigUri("admin/slobrok.0")),
       identity(ident),
-      rtcPort(port)
+      rtcPort(port),
+      searchCaptureFile(),
+      searchCaptureSampleEvery(0),
+      searchCaptureMaxFileSize(0)
 { }
 
 RPCHooksBase::Params::~Params() = default;
@@ -204,7 +207,16 @@ RPCHooksBase::RPCHooksBase(Params &params)
       _stateLock(),
       _stateCond(),
       _executor(48, 128 * 1024)
-{ }
+{
+    if (!params.searchCaptureFile.empty() && (params.searchCaptureSampleEvery > 0)) {
+        LOG(info, "Capturing every %u'th search request to '%s'",
+            params.searchCaptureSampleEvery, params.searchCaptureFile.c_str());
+        _proto_rpc_adapter->set_search_capture(
+                std::make_unique<search::engine::SearchRequestCapture>(params.searchCaptureFile,
+                                                                       params.searchCaptureSampleEvery,
+                                                                       params.searchCaptureMaxFileSize));
+    }
+}
 
 void
 RPCHooksBase::open(Params & params)
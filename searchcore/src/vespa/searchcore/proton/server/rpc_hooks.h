@@ -87,6 +87,9 @@ public:
         config::ConfigUri slobrok_config;
         vespalib::string  identity;
         uint32_t          rtcPort;
+        vespalib::string  searchCaptureFile;
+        uint32_t          searchCaptureSampleEvery;
+        uint64_t          searchCaptureMaxFileSize;
 
         Params(Proton &parent, uint32_t port, const vespalib::string &ident);
         ~Params();
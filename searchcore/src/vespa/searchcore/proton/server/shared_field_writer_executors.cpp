@@ -0,0 +1,42 @@
+// Copyright 2019 Oath Inc. Licensed under the terms of the Apache 2.0 license. See LICENSE in the project root.
+
+#include "shared_field_writer_executors.h"
+#include "executorthreadingservice.h"
+#include <vespa/searchlib/common/isequencedtaskexecutor.h>
+
+namespace proton {
+
+SharedFieldWriterExecutors::SharedFieldWriterExecutors(uint32_t threads, uint32_t taskLimit, bool lockFree)
+    : _indexFieldInverter(ExecutorThreadingService::createFieldWriter(threads, taskLimit, lockFree)),
+      _indexFieldWriter(ExecutorThreadingService::createFieldWriter(threads, taskLimit, lockFree)),
+      _attributeFieldWriter(ExecutorThreadingService::createFieldWriter(threads, taskLimit, lockFree)),
+      _nextOffset(0)
+{
+}
+
+SharedFieldWriterExecutors::~SharedFieldWriterExecutors()
+{
+    sync();
+}
+
+uint32_t
+SharedFieldWriterExecutors::getNumExecutors() const
+{
+    return _attributeFieldWriter->getNumExecutors();
+}
+
+uint32_t
+SharedFieldWriterExecutors::nextOffset()
+{
+    return _nextOffset++ % getNumExecutors();
+}
+
+void
+SharedFieldWriterExecutors::sync()
+{
+    _attributeFieldWriter->sync();
+    _indexFieldInverter->sync();
+    _indexFieldWriter->sync();
+}
+
+}
@@ -0,0 +1,46 @@
+// Copyright 2019 Oath Inc. Licensed under the terms of the Apache 2.0 license. See LICENSE in the project root.
+
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <memory>
+
+namespace search { class ISequencedTaskExecutor; }
+
+namespace proton {
+
+/**
+ * Field writer executors shared by all document dbs in proton, used
+ * instead of separate executors per document db when
+ * indexing.sharedfieldwriter is set.
+ *
+ * Each document db uses views of these executors (see
+ * search::SequencedTaskExecutorView), covering all threads but starting
+ * at different offsets, so a busy document db can use all threads
+ * while the low executor ids of the document dbs are spread out.
+ */
+class SharedFieldWriterExecutors {
+    std::unique_ptr<search::ISequencedTaskExecutor> _indexFieldInverter;
+    std::unique_ptr<search::ISequencedTaskExecutor> _indexFieldWriter;
+    std::unique_ptr<search::ISequencedTaskExecutor> _attributeFieldWriter;
+    std::atomic<uint32_t>                           _nextOffset;
+
+public:
+    SharedFieldWriterExecutors(uint32_t threads, uint32_t taskLimit, bool lockFree);
+    ~SharedFieldWriterExecutors();
+
+    uint32_t getNumExecutors() const;
+
+    /**
+     * Returns the offset to use for the views of the next document db.
+     */
+    uint32_t nextOffset();
+
+    search::ISequencedTaskExecutor &indexFieldInverter() { return *_indexFieldInverter; }
+    search::ISequencedTaskExecutor &indexFieldWriter() { return *_indexFieldWriter; }
+    search::ISequencedTaskExecutor &attributeFieldWriter() { return *_attributeFieldWriter; }
+    void sync();
+};
+
+}
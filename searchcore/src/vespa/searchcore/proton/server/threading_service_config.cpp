@@ -10,10 +10,12 @@ using ProtonConfig = ThreadingServiceConfig::ProtonConfig;
 
 ThreadingServiceConfig::ThreadingServiceConfig(uint32_t indexingThreads_,
                                                uint32_t defaultTaskLimit_,
-                                               uint32_t semiUnboundTaskLimit_)
+                                               uint32_t semiUnboundTaskLimit_,
+                                               bool lockFreeFieldWriter_)
     : _indexingThreads(indexingThreads_),
       _defaultTaskLimit(defaultTaskLimit_),
-      _semiUnboundTaskLimit(semiUnboundTaskLimit_)
+      _semiUnboundTaskLimit(semiUnboundTaskLimit_),
+      _lockFreeFieldWriter(lockFreeFieldWriter_)
 {
 }
 
@@ -34,7 +36,8 @@ ThreadingServiceConfig::make(const ProtonConfig &cfg, double concurrency, const
 {
     uint32_t indexingThreads = calculateIndexingThreads(cfg.indexing.threads, concurrency, cpuInfo);
     return ThreadingServiceConfig(indexingThreads, cfg.indexing.tasklimit,
-                                  (cfg.indexing.semiunboundtasklimit / indexingThreads));
+                                  (cfg.indexing.semiunboundtasklimit / indexingThreads),
+                                  cfg.indexing.lockfreefieldwriter);
 }
 
 }
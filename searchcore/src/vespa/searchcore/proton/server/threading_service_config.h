@@ -18,9 +18,11 @@ private:
     uint32_t _indexingThreads;
     uint32_t _defaultTaskLimit;
     uint32_t _semiUnboundTaskLimit;
+    bool     _lockFreeFieldWriter;
 
 private:
-    ThreadingServiceConfig(uint32_t indexingThreads_, uint32_t defaultTaskLimit_, uint32_t semiUnboundTaskLimit_);
+    ThreadingServiceConfig(uint32_t indexingThreads_, uint32_t defaultTaskLimit_, uint32_t semiUnboundTaskLimit_,
+                           bool lockFreeFieldWriter_);
 
 public:
     static ThreadingServiceConfig make(const ProtonConfig &cfg, double concurrency, const HwInfo::Cpu &cpuInfo);
@@ -28,6 +30,7 @@ public:
     uint32_t indexingThreads() const { return _indexingThreads; }
     uint32_t defaultTaskLimit() const { return _defaultTaskLimit; }
     uint32_t semiUnboundTaskLimit() const { return _semiUnboundTaskLimit; }
+    bool lockFreeFieldWriter() const { return _lockFreeFieldWriter; }
 };
 
 }
@@ -2,6 +2,7 @@
 
 #include "tlcproxy.h"
 #include <vespa/searchcore/proton/feedoperation/feedoperation.h>
+#include <cassert>
 
 #include <vespa/log/log.h>
 LOG_SETUP(".proton.server.tlcproxy");
@@ -11,24 +12,31 @@ using search::transactionlog::Packet;
 
 namespace proton {
 
-void TlcProxy::commit(search::SerialNum serialNum, search::transactionlog::Type type,
-                      const vespalib::nbostream &buf, DoneCallback onDone)
+void TlcProxy::commit(const Packet &packet, DoneCallback onDone)
 {
-    Packet::Entry entry(serialNum, type, vespalib::ConstBufferRef(buf.c_str(), buf.size()));
-    Packet packet;
-    packet.add(entry);
-    packet.close();
     _tlsDirectWriter.commit(_domain, packet, std::move(onDone));
 }
 
-void
-TlcProxy::storeOperation(const FeedOperation &op, DoneCallback onDone)
+bool
+TlcProxy::addOperation(Packet &packet, const FeedOperation &op)
 {
     nbostream stream;
     op.serialize(stream);
-    LOG(debug, "storeOperation(): serialNum(%" PRIu64 "), type(%u), size(%zu)",
+    LOG(debug, "addOperation(): serialNum(%" PRIu64 "), type(%u), size(%zu)",
         op.getSerialNum(), (uint32_t)op.getType(), stream.size());
-    commit(op.getSerialNum(), (uint32_t)op.getType(), stream, std::move(onDone));
+    Packet::Entry entry(op.getSerialNum(), (uint32_t)op.getType(), vespalib::ConstBufferRef(stream.c_str(), stream.size()));
+    return packet.add(entry);
+}
+
+void
+TlcProxy::storeOperation(const FeedOperation &op, DoneCallback onDone)
+{
+    Packet packet;
+    bool added = addOperation(packet, op);
+    assert(added);
+    (void) added;
+    packet.close();
+    commit(packet, std::move(onDone));
 }
 
 }  // namespace proton
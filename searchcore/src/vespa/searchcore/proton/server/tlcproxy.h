@@ -10,11 +10,10 @@ class FeedOperation;
 class TlcProxy {
     using DoneCallback = search::transactionlog::Writer::DoneCallback;
     using Writer = search::transactionlog::Writer;
+    using Packet = search::transactionlog::Packet;
     vespalib::string    _domain;
     Writer            & _tlsDirectWriter;
 
-    void commit(search::SerialNum serialNum, search::transactionlog::Type type,
-                const vespalib::nbostream &buf, DoneCallback onDone);
 public:
     typedef std::unique_ptr<TlcProxy> UP;
 
@@ -22,6 +21,13 @@ public:
         : _domain(domain), _tlsDirectWriter(writer) {}
 
     void storeOperation(const FeedOperation &op, DoneCallback onDone);
+    void commit(const Packet &packet, DoneCallback onDone);
+
+    /**
+     * Serialize the given operation and add it to the packet. Returns
+     * false, leaving the packet unchanged, if the packet is full.
+     */
+    static bool addOperation(Packet &packet, const FeedOperation &op);
 };
 
 } // namespace proton
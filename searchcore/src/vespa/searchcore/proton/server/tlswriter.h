@@ -13,6 +13,14 @@ namespace proton {
 struct TlsWriter : public IOperationStorer {
     virtual ~TlsWriter() = default;
 
+    /**
+     * Store the given operation as part of the current batch. The batch
+     * is committed as a single packet when flush() is called, or before
+     * an operation is stored with storeOperation().
+     */
+    virtual void appendOperation(const FeedOperation &op, DoneCallback onDone) = 0;
+    virtual void flush() = 0;
+
     virtual bool erase(search::SerialNum oldest_to_keep) = 0;
     virtual search::SerialNum sync(search::SerialNum syncTo) = 0;
 };
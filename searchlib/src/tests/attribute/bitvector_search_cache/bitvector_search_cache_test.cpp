@@ -12,9 +12,9 @@ using BitVectorSP = BitVectorSearchCache::BitVectorSP;
 using Entry = BitVectorSearchCache::Entry;
 
 Entry::SP
-makeEntry()
+makeEntry(uint64_t changeCount = 0)
 {
-    return std::make_shared<Entry>(IDocumentMetaStoreContext::IReadGuard::UP(), BitVector::create(5), 10);
+    return std::make_shared<Entry>(IDocumentMetaStoreContext::IReadGuard::UP(), BitVector::create(5), 10, changeCount);
 }
 
 struct Fixture {
@@ -60,4 +60,135 @@ TEST_F("require that cache can be cleared", Fixture)
     EXPECT_TRUE(f.cache.find("bar").get() == nullptr);
 }
 
+TEST_F("require that lookups are counted", Fixture)
+{
+    f.cache.insert("foo", f.entry1);
+    EXPECT_EQUAL(f.entry1, f.cache.find("foo"));
+    EXPECT_TRUE(f.cache.find("bar").get() == nullptr);
+    EXPECT_EQUAL(f.entry1, f.cache.find("foo"));
+    CacheStats stats = f.cache.getStats();
+    EXPECT_EQUAL(2u, stats.hits);
+    EXPECT_EQUAL(1u, stats.misses);
+    EXPECT_EQUAL(1u, stats.elements);
+    EXPECT_EQUAL(f.entry1->memoryUsage(), stats.memory_used);
+}
+
+TEST_F("require that memory usage is tracked", Fixture)
+{
+    f.cache.insert("foo", f.entry1);
+    f.cache.insert("bar", f.entry2);
+    f.cache.insert("bar", f.entry1);
+    EXPECT_EQUAL(f.entry1->memoryUsage() + f.entry2->memoryUsage(), f.cache.getMemoryUsage().allocatedBytes());
+    EXPECT_TRUE(f.cache.find("foo", 0, 11).get() == nullptr);
+    EXPECT_EQUAL(f.entry2->memoryUsage(), f.cache.getMemoryUsage().allocatedBytes());
+    f.cache.clear();
+    EXPECT_EQUAL(0u, f.cache.getMemoryUsage().allocatedBytes());
+}
+
+TEST("require that entry for other doc id limit is removed on lookup")
+{
+    BitVectorSearchCache cache;
+    Entry::SP entry = makeEntry(2);
+    cache.insert("foo", entry);
+    EXPECT_EQUAL(entry, cache.find("foo", 2, 10));
+    EXPECT_TRUE(cache.find("foo", 2, 11).get() == nullptr);
+    EXPECT_EQUAL(0u, cache.size());
+    EXPECT_EQUAL(1u, cache.getStats().invalidations);
+}
+
+TEST("require that all entries are removed when newer change count is seen")
+{
+    BitVectorSearchCache cache;
+    cache.insert("foo", makeEntry(2));
+    cache.insert("bar", makeEntry(2));
+    EXPECT_TRUE(cache.find("foo", 4, 10).get() == nullptr);
+    EXPECT_EQUAL(0u, cache.size());
+    EXPECT_EQUAL(0u, cache.getMemoryUsage().allocatedBytes());
+    Entry::SP newEntry = makeEntry(4);
+    cache.insert("foo", newEntry);
+    EXPECT_EQUAL(newEntry, cache.find("foo", 4, 10));
+    CacheStats stats = cache.getStats();
+    EXPECT_EQUAL(1u, stats.hits);
+    EXPECT_EQUAL(1u, stats.misses);
+    EXPECT_EQUAL(2u, stats.invalidations);
+}
+
+TEST("require that entries for older change count are neither inserted nor found")
+{
+    BitVectorSearchCache cache;
+    Entry::SP entry = makeEntry(4);
+    cache.insert("foo", entry);
+    cache.insert("bar", makeEntry(2));
+    EXPECT_EQUAL(1u, cache.size());
+    EXPECT_TRUE(cache.find("foo", 2, 10).get() == nullptr);
+    EXPECT_EQUAL(entry, cache.find("foo", 4, 10));
+    EXPECT_EQUAL(0u, cache.getStats().invalidations);
+}
+
+TEST("require that memory usage is limited by byte budget")
+{
+    size_t entryBytes = makeEntry()->memoryUsage();
+    BitVectorSearchCache cache(2 * entryBytes);
+    cache.insert("foo", makeEntry(2));
+    cache.insert("bar", makeEntry(2));
+    cache.insert("baz", makeEntry(2));
+    EXPECT_EQUAL(2u, cache.size());
+    EXPECT_EQUAL(2 * entryBytes, cache.getMemoryUsage().allocatedBytes());
+    EXPECT_TRUE(cache.find("baz", 2, 10).get() == nullptr);
+    // Entries for an older change count are dropped when a newer one is inserted
+    cache.insert("baz", makeEntry(4));
+    EXPECT_EQUAL(1u, cache.size());
+    EXPECT_TRUE(cache.find("baz", 4, 10).get() != nullptr);
+    EXPECT_EQUAL(2u, cache.getStats().invalidations);
+}
+
+TEST("require that entry larger than byte budget is not inserted")
+{
+    BitVectorSearchCache cache(makeEntry()->memoryUsage() - 1);
+    cache.insert("foo", makeEntry(2));
+    EXPECT_EQUAL(0u, cache.size());
+    EXPECT_EQUAL(0u, cache.getMemoryUsage().allocatedBytes());
+}
+
+TEST("require that full cache only admits terms looked up more often than evicted terms")
+{
+    BitVectorSearchCache cache(2 * makeEntry()->memoryUsage());
+    EXPECT_TRUE(cache.find("foo", 2, 10).get() == nullptr);
+    EXPECT_TRUE(cache.find("foo", 2, 10).get() == nullptr);
+    cache.insert("foo", makeEntry(2));
+    EXPECT_TRUE(cache.find("bar", 2, 10).get() == nullptr);
+    cache.insert("bar", makeEntry(2));
+    EXPECT_EQUAL(2u, cache.size());
+
+    // Looked up as often as the least frequent cached term, not admitted
+    EXPECT_TRUE(cache.find("baz", 2, 10).get() == nullptr);
+    cache.insert("baz", makeEntry(2));
+    EXPECT_EQUAL(2u, cache.size());
+
+    // Looked up more often than "bar" (3 vs 1), which is evicted to make room
+    EXPECT_TRUE(cache.find("baz", 2, 10).get() == nullptr);
+    EXPECT_TRUE(cache.find("baz", 2, 10).get() == nullptr);
+    Entry::SP entry = makeEntry(2);
+    cache.insert("baz", entry);
+    EXPECT_EQUAL(2u, cache.size());
+    EXPECT_EQUAL(entry, cache.find("baz", 2, 10));
+    EXPECT_TRUE(cache.find("foo", 2, 10).get() != nullptr);
+    EXPECT_TRUE(cache.find("bar", 2, 10).get() == nullptr);
+    EXPECT_EQUAL(2 * entry->memoryUsage(), cache.getMemoryUsage().allocatedBytes());
+}
+
+TEST("require that lookup counts survive entries dropped for newer change count")
+{
+    BitVectorSearchCache cache(makeEntry()->memoryUsage());
+    EXPECT_TRUE(cache.find("foo", 2, 10).get() == nullptr);
+    cache.insert("bar", makeEntry(2));
+    EXPECT_TRUE(cache.find("bar", 4, 10).get() == nullptr);
+    EXPECT_TRUE(cache.find("foo", 4, 10).get() == nullptr);
+    // "bar" was cached first and is looked up once, "foo" is looked up twice
+    cache.insert("bar", makeEntry(4));
+    cache.insert("foo", makeEntry(4));
+    EXPECT_EQUAL(1u, cache.size());
+    EXPECT_TRUE(cache.find("foo", 4, 10).get() != nullptr);
+}
+
 TEST_MAIN() { TEST_RUN_ALL(); }
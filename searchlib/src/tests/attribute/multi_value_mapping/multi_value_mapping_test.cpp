@@ -4,6 +4,7 @@
 #include <vespa/searchlib/attribute/multi_value_mapping.hpp>
 #include <vespa/searchlib/attribute/not_implemented_attribute.h>
 #include <vespa/searchlib/util/rand48.h>
+#include <vespa/searchcommon/common/compaction_strategy.h>
 #include <vespa/vespalib/gtest/gtest.h>
 #include <vespa/vespalib/stllike/hash_set.h>
 #include <vespa/vespalib/test/insertion_operators.h>
@@ -208,6 +209,23 @@ public:
         set(docId, {});
         _refMapping.erase(docId);
     }
+
+    void setRandomDocs(uint32_t count) {
+        for (uint32_t i = 0; i < count; ++i) {
+            uint32_t docId = _rnd.lrand48() % size();
+            std::vector<int> values = makeValues();
+            _refMapping[docId] = values;
+            set(docId, values);
+        }
+    }
+
+    bool considerCompact() {
+        _mvMapping->updateStat();
+        bool compacted = _mvMapping->considerCompact(search::CompactionStrategy());
+        _attr->commit();
+        _attr->incGeneration();
+        return compacted;
+    }
 };
 
 TEST_F(IntMappingTest, test_that_set_and_get_works)
@@ -348,4 +366,33 @@ TEST_F(CompactionIntMappingTest, test_that_compaction_works)
     EXPECT_LT(bufferCountAfter, bufferCountBefore);
 }
 
+TEST_F(CompactionIntMappingTest, test_that_compaction_is_done_in_slices_interleaved_with_writes)
+{
+    setup(3, 64, 512, 129);
+    addRandomDocs(40000);
+    uint32_t docIdLimit = size();
+    for (uint32_t docId = 0; docId < docIdLimit / 2; ++docId) {
+        clearDoc(docId);
+    }
+    _attr->commit();
+    _attr->incGeneration();
+    _mvMapping->setCompactionSliceSize(1000);
+    EXPECT_TRUE(considerCompact());
+    EXPECT_TRUE(_mvMapping->compactionInProgress());
+    uint32_t slices = 1;
+    while (_mvMapping->compactionInProgress()) {
+        setRandomDocs(10);
+        EXPECT_TRUE(considerCompact());
+        ++slices;
+        checkRefMapping();
+    }
+    EXPECT_EQ((docIdLimit + 999) / 1000, slices);
+    const auto &stats = _mvMapping->getCompactionStats();
+    EXPECT_EQ(1u, stats.compactions);
+    EXPECT_EQ(slices, stats.slices);
+    EXPECT_EQ(docIdLimit, stats.refs);
+    LOG(info, "Compacted %u docs in %u slices, max slice time %" PRId64 " us",
+        docIdLimit, slices, vespalib::count_us(stats.maxSliceTime));
+}
+
 GTEST_MAIN_RUN_ALL_TESTS()
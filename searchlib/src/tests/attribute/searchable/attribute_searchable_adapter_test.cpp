@@ -27,6 +27,7 @@
 #include <vespa/searchlib/queryeval/field_spec.h>
 #include <vespa/searchlib/queryeval/searchiterator.h>
 #include <vespa/searchlib/queryeval/wand/parallel_weak_and_search.h>
+#include <vespa/vespalib/geo/zcurve.h>
 #include <memory>
 
 #include <vespa/log/log.h>
@@ -131,8 +132,9 @@ struct Result {
         uint32_t docid;
         double raw_score;
         int32_t match_weight;
-        Hit(uint32_t id, double raw, int32_t match_weight_in)
-            : docid(id), raw_score(raw), match_weight(match_weight_in) {}
+        uint32_t unpacked_docid;
+        Hit(uint32_t id, double raw, int32_t match_weight_in, uint32_t unpacked_docid_in)
+            : docid(id), raw_score(raw), match_weight(match_weight_in), unpacked_docid(unpacked_docid_in) {}
     };
     size_t est_hits;
     bool est_empty;
@@ -225,7 +227,8 @@ Result do_search(IAttributeManager &attribute_manager, const Node &node, bool st
             iterator->unpack(docid);
             result.hits.emplace_back(docid,
                                      match_data->resolveTermField(handle)->getRawScore(),
-                                     match_data->resolveTermField(handle)->getWeight());
+                                     match_data->resolveTermField(handle)->getWeight(),
+                                     match_data->resolveTermField(handle)->getDocId());
         }
     }
     return result;
@@ -372,6 +375,55 @@ TEST("require that optimized location search works with wrapped bounding box (no
     EXPECT_TRUE(result3.iterator_dump.find("EmptySearch") != vespalib::string::npos);
 }
 
+MyAttributeManager makeGeoAttributeManager(bool fast_search, int32_t step) {
+    Config cfg(BasicType::INT64, CollectionType::SINGLE);
+    cfg.setFastSearch(fast_search);
+    AttributeVector::SP attr_ptr = AttributeFactory::createAttribute(field, cfg);
+    IntegerAttribute *attr = static_cast<IntegerAttribute *>(attr_ptr.get());
+    add_docs(attr, num_docs);
+    for (uint32_t docid = 1; docid < num_docs; ++docid) {
+        attr->update(docid, vespalib::geo::ZCurve::encode(docid * step, 0));
+    }
+    attr->commit();
+    return MyAttributeManager(attr_ptr);
+}
+
+string nearest_hits(IAttributeManager &attribute_manager, const string &location) {
+    SimpleLocationTerm term(Location(location), field, 0, Weight(0));
+    Result result = do_search(attribute_manager, term, true);
+    EXPECT_EQUAL(result.hits.size(), result.est_hits);
+    EXPECT_TRUE(result.iterator_dump.find("GeoNearestIterator") != vespalib::string::npos);
+    string hits;
+    for (const auto &hit : result.hits) {
+        EXPECT_EQUAL(hit.docid, hit.unpacked_docid);
+        hits += make_string("%s%u", hits.empty() ? "" : ",", hit.docid);
+    }
+    return hits;
+}
+
+TEST("require that location terms with target hits give nearest documents") {
+    for (bool fast_search : {false, true}) {
+        TEST_STATE(fast_search ? "fast-search" : "no fast-search");
+        MyAttributeManager attribute_manager = makeGeoAttributeManager(fast_search, 100);
+        EXPECT_EQUAL("49,50,51", nearest_hits(attribute_manager, "(2,5000,0,1000000,0,1,0){3}"));
+        EXPECT_EQUAL("48,49,50,51,52", nearest_hits(attribute_manager, "(2,5000,0,1000000,0,1,0){5}"));
+        // the radius still applies
+        EXPECT_EQUAL("49,50,51", nearest_hits(attribute_manager, "(2,5000,0,150,0,1,0){5}"));
+        // as does the bounding box
+        EXPECT_EQUAL("50,51,52", nearest_hits(attribute_manager, "(2,5000,0,1000000,0,1,0){3}[2,5000,0,6000,0]"));
+    }
+}
+
+TEST("require that nearest search expands until target hits are found") {
+    for (bool fast_search : {false, true}) {
+        TEST_STATE(fast_search ? "fast-search" : "no fast-search");
+        MyAttributeManager attribute_manager = makeGeoAttributeManager(fast_search, 10000);
+        EXPECT_EQUAL("49,50,51", nearest_hits(attribute_manager, "(2,500000,0,100000000,0,1,0){3}"));
+        EXPECT_EQUAL("1,2", nearest_hits(attribute_manager, "(2,-1000000,0,100000000,0,1,0){2}"));
+        EXPECT_EQUAL("998,999", nearest_hits(attribute_manager, "(2,20000000,0,100000000,0,1,0){2}"));
+    }
+}
+
 void set_weights(StringAttribute *attr, uint32_t docid,
                  int32_t foo_weight, int32_t bar_weight, int32_t baz_weight)
 {
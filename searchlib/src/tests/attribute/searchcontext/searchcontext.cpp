@@ -7,6 +7,7 @@
 #include <vespa/searchlib/attribute/singlestringattribute.h>
 #include <vespa/searchlib/attribute/multistringattribute.h>
 #include <vespa/searchlib/attribute/elementiterator.h>
+#include <vespa/searchlib/attribute/ipostinglistattributebase.h>
 #include <vespa/searchlib/common/bitvectoriterator.h>
 #include <vespa/searchlib/fef/matchdata.h>
 #include <vespa/searchlib/fef/termfieldmatchdataarray.h>
@@ -266,6 +267,11 @@ private:
     void requireThatOutOfBoundsSearchTermGivesZeroHits(const vespalib::string &name, const Config &cfg, int64_t maxValue);
     void requireThatOutOfBoundsSearchTermGivesZeroHits();
 
+    template <typename VectorType>
+    void requireThatZoneMapSkippingGivesCorrectHits(const vespalib::string & name, const Config & cfg);
+    void requireThatZoneMapSkippingGivesCorrectHits();
+    void requireThatMergedPostingsAreCachedForFilterAttributes();
+
     // init maps with config objects
     void initIntegerConfig();
     void initFloatConfig();
@@ -1824,6 +1830,154 @@ SearchContextTest::requireThatOutOfBoundsSearchTermGivesZeroHits()
     }
 }
 
+template <typename VectorType>
+void
+SearchContextTest::requireThatZoneMapSkippingGivesCorrectHits(const vespalib::string & name, const Config & cfg)
+{
+    LOG(info, "requireThatZoneMapSkippingGivesCorrectHits: vector '%s'", name.c_str());
+    uint32_t numDocs = 5000;
+    AttributePtr a = AttributeFactory::createAttribute(name, cfg);
+    auto & va = dynamic_cast<VectorType &>(*a);
+    addDocs(va, numDocs);
+    for (uint32_t doc = 1; doc <= numDocs; ++doc) {
+        va.update(doc, doc);
+    }
+    va.commit(true);
+    auto makeRange = [](uint32_t low, uint32_t high) {
+        DocSet docs;
+        for (uint32_t doc = low; doc <= high; ++doc) {
+            docs.insert(doc);
+        }
+        return docs;
+    };
+    performSearch(va, "[2500;2600]", makeRange(2500, 2600), QueryTermSimple::WORD);
+    performSearch(va, "[1020;1030]", makeRange(1020, 1030), QueryTermSimple::WORD);
+    performSearch(va, ">4990", makeRange(4991, 5000), QueryTermSimple::WORD);
+    performSearch(va, "3000", DocSet().put(3000), QueryTermSimple::WORD);
+    performSearch(va, "[6000;7000]", DocSet(), QueryTermSimple::WORD);
+
+    // Blocks are widened when values are updated, so docs moved into a
+    // range from another block must be found.
+    va.update(10, 3000);
+    va.commit(true);
+    performSearch(va, "3000", DocSet().put(10).put(3000), QueryTermSimple::WORD);
+    va.clearDoc(3000);
+    va.commit(true);
+    performSearch(va, "3000", DocSet().put(10), QueryTermSimple::WORD);
+
+    // Undefined values are not part of the block ranges, but are still
+    // found by terms matching them (never for NaN).
+    performSearch(va, "[2999;3001]", DocSet().put(2999).put(3001), QueryTermSimple::WORD);
+    bool isFloat = (cfg.basicType() == BasicType::DOUBLE);
+    performSearch(va, "<1", isFloat ? DocSet() : DocSet().put(3000), QueryTermSimple::WORD);
+
+    // Docs added after the zone map was built are searched as well.
+    uint32_t docId;
+    EXPECT_TRUE(va.addDoc(docId));
+    va.update(docId, 3000);
+    va.commit(true);
+    performSearch(va, "3000", DocSet().put(10).put(docId), QueryTermSimple::WORD);
+}
+
+void
+SearchContextTest::requireThatZoneMapSkippingGivesCorrectHits()
+{
+    requireThatZoneMapSkippingGivesCorrectHits<IntegerAttribute>("s-int64", Config(BasicType::INT64, CollectionType::SINGLE));
+    requireThatZoneMapSkippingGivesCorrectHits<IntegerAttribute>("s-int32", Config(BasicType::INT32, CollectionType::SINGLE));
+    requireThatZoneMapSkippingGivesCorrectHits<FloatingPointAttribute>("s-double", Config(BasicType::DOUBLE, CollectionType::SINGLE));
+}
+
+void
+SearchContextTest::requireThatMergedPostingsAreCachedForFilterAttributes()
+{
+    uint32_t numDocs = 1000;
+    auto searchCacheStats = [](const AttributeVector &attr) {
+        return attr.getIPostingListAttributeBase()->getSearchCacheStats();
+    };
+    auto expectedDocs = [numDocs](uint32_t low, uint32_t high) {
+        DocSet docs;
+        for (uint32_t doc = 1; doc <= numDocs; ++doc) {
+            if ((doc % 100) >= low && (doc % 100) <= high) {
+                docs.insert(doc);
+            }
+        }
+        return docs;
+    };
+    { // IntegerAttribute
+        Config cfg(BasicType::INT32, CollectionType::SINGLE);
+        cfg.setFastSearch(true);
+        cfg.setIsFilter(true);
+        cfg.setSearchCacheMaxBytes(1024 * 1024);
+        AttributePtr a = AttributeFactory::createAttribute("s-fs-filter-int32", cfg);
+        auto & va = dynamic_cast<IntegerAttribute &>(*a);
+        addDocs(va, numDocs);
+        for (uint32_t doc = 1; doc <= numDocs; ++doc) {
+            va.update(doc, doc % 100);
+        }
+        va.commit(true);
+        DocSet expected = expectedDocs(0, 49);
+        performSearch(va, "[0;49]", expected, QueryTermSimple::WORD);
+        EXPECT_EQUAL(0u, searchCacheStats(va).hits);
+        EXPECT_EQUAL(1u, searchCacheStats(va).elements);
+        performSearch(va, "[0;49]", expected, QueryTermSimple::WORD);
+        // Same dictionary range, same cache entry
+        performSearch(va, "[-10;49]", expected, QueryTermSimple::WORD);
+        EXPECT_EQUAL(2u, searchCacheStats(va).hits);
+        EXPECT_EQUAL(1u, searchCacheStats(va).elements);
+        EXPECT_LESS(0u, searchCacheStats(va).memory_used);
+
+        // A commit without value changes keeps the cached entry
+        va.commit(true);
+        performSearch(va, "[0;49]", expected, QueryTermSimple::WORD);
+        EXPECT_EQUAL(3u, searchCacheStats(va).hits);
+        EXPECT_EQUAL(0u, searchCacheStats(va).invalidations);
+
+        // The cached entry is not used after the posting lists have changed
+        va.update(1, 60);
+        va.commit(true);
+        expected.erase(1);
+        performSearch(va, "[0;49]", expected, QueryTermSimple::WORD);
+        EXPECT_EQUAL(3u, searchCacheStats(va).hits);
+        EXPECT_EQUAL(1u, searchCacheStats(va).invalidations);
+        performSearch(va, "[0;49]", expected, QueryTermSimple::WORD);
+        EXPECT_EQUAL(4u, searchCacheStats(va).hits);
+    }
+    { // StringAttribute
+        Config cfg(BasicType::STRING, CollectionType::SINGLE);
+        cfg.setFastSearch(true);
+        cfg.setIsFilter(true);
+        cfg.setSearchCacheMaxBytes(1024 * 1024);
+        AttributePtr a = AttributeFactory::createAttribute("s-fs-filter-str", cfg);
+        auto & va = dynamic_cast<StringAttribute &>(*a);
+        addDocs(va, numDocs);
+        for (uint32_t doc = 1; doc <= numDocs; ++doc) {
+            va.update(doc, vespalib::make_string("%s%u", ((doc % 100) < 50) ? "foo" : "bar", doc % 100));
+        }
+        va.commit(true);
+        DocSet expected = expectedDocs(0, 49);
+        performSearch(va, "foo", expected, QueryTermSimple::PREFIXTERM);
+        performSearch(va, "foo", expected, QueryTermSimple::PREFIXTERM);
+        EXPECT_EQUAL(1u, searchCacheStats(va).hits);
+    }
+    for (bool isFilter : {false, true}) { // Not a filter attribute, or a filter attribute without cache
+        Config cfg(BasicType::INT32, CollectionType::SINGLE);
+        cfg.setFastSearch(true);
+        cfg.setIsFilter(isFilter);
+        cfg.setSearchCacheMaxBytes(isFilter ? 0 : 1024 * 1024);
+        AttributePtr a = AttributeFactory::createAttribute("s-fs-int32", cfg);
+        auto & va = dynamic_cast<IntegerAttribute &>(*a);
+        addDocs(va, numDocs);
+        for (uint32_t doc = 1; doc <= numDocs; ++doc) {
+            va.update(doc, doc % 100);
+        }
+        va.commit(true);
+        performSearch(va, "[0;49]", expectedDocs(0, 49), QueryTermSimple::WORD);
+        performSearch(va, "[0;49]", expectedDocs(0, 49), QueryTermSimple::WORD);
+        EXPECT_EQUAL(0u, searchCacheStats(va).lookups());
+        EXPECT_EQUAL(0u, searchCacheStats(va).elements);
+    }
+}
+
 void
 SearchContextTest::initIntegerConfig()
 {
@@ -1954,6 +2108,8 @@ SearchContextTest::Main()
     TEST_DO(requireThatInvalidSearchTermGivesZeroHits());
     TEST_DO(requireThatFlagAttributeHandlesTheByteRange());
     TEST_DO(requireThatOutOfBoundsSearchTermGivesZeroHits());
+    TEST_DO(requireThatZoneMapSkippingGivesCorrectHits());
+    TEST_DO(requireThatMergedPostingsAreCachedForFilterAttributes());
 
     TEST_DONE();
 }
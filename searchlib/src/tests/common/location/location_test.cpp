@@ -112,6 +112,23 @@ TEST("require that circles can be specified after bounding box") {
     EXPECT_EQUAL(25, loc.getMaxY());    
 }
 
+TEST("require that nearest target hits can be parsed") {
+    Location loc = parse("(2,10,20,5,0,0,0){100}");
+    EXPECT_EQUAL(true, loc.getRankOnDistance());
+    EXPECT_EQUAL(100u, loc.getTargetHits());
+    EXPECT_EQUAL(5u, loc.getRadius());
+    EXPECT_EQUAL(0u, parse("(2,10,20,5,0,0,0)").getTargetHits());
+    EXPECT_EQUAL(7u, parse("{7}(2,10,20,5,0,0,0)[2,10,20,30,40]").getTargetHits());
+}
+
+TEST("require that malformed nearest target hits are not parseable") {
+    EXPECT_FALSE(is_parseable("(2,10,20,5,0,0,0){100}{100}"));
+    EXPECT_FALSE(is_parseable("(2,10,20,5,0,0,0){0}"));
+    EXPECT_FALSE(is_parseable("(2,10,20,5,0,0,0){-5}"));
+    EXPECT_FALSE(is_parseable("(2,10,20,5,0,0,0){100"));
+    EXPECT_FALSE(is_parseable("[2,10,20,30,40]{100}"));
+}
+
 TEST("require that santa search gives non-wrapped bounding box") {
     Location loc = parse("(2,122163600,89998536,290112,4,2000,0,109704)");
     EXPECT_GREATER_EQUAL(loc.getMaxX(), loc.getMinX());
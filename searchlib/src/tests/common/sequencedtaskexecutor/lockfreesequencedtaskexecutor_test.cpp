@@ -0,0 +1,141 @@
+// Copyright 2019 Oath Inc. Licensed under the terms of the Apache 2.0 license. See LICENSE in the project root.
+
+#include <vespa/searchlib/common/lockfreesequencedtaskexecutor.h>
+#include <vespa/vespalib/testkit/testapp.h>
+#include <vespa/vespalib/util/executor_stats.h>
+#include <vespa/vespalib/util/gate.h>
+#include <atomic>
+#include <thread>
+
+#include <vespa/log/log.h>
+LOG_SETUP("lockfreesequencedtaskexecutor_test");
+
+namespace search::common {
+
+using ExecutorId = ISequencedTaskExecutor::ExecutorId;
+
+TEST("require that tasks with same executor id are run in order")
+{
+    LockFreeSequencedTaskExecutor threads(2);
+    std::vector<int> res;
+    for (int i = 0; i < 10000; ++i) {
+        threads.execute(ExecutorId(1), [&res, i]() { res.push_back(i); });
+    }
+    threads.sync();
+    ASSERT_EQUAL(10000u, res.size());
+    bool inOrder = true;
+    for (int i = 0; i < 10000; ++i) {
+        inOrder = inOrder && (res[i] == i);
+    }
+    EXPECT_TRUE(inOrder);
+}
+
+TEST("require that tasks with different executor ids are not serialized")
+{
+    LockFreeSequencedTaskExecutor threads(2);
+    vespalib::Gate gate;
+    std::atomic<bool> done(false);
+    threads.execute(ExecutorId(0), [&gate]() { gate.await(); });
+    threads.execute(ExecutorId(1), [&done]() { done = true; });
+    while (!done) {
+        std::this_thread::sleep_for(1ms);
+    }
+    gate.countDown();
+    threads.sync();
+}
+
+TEST("require that sync waits for tasks from all producers")
+{
+    LockFreeSequencedTaskExecutor threads(3, 10);
+    std::atomic<uint32_t> count(0);
+    std::vector<std::thread> producers;
+    for (uint32_t p = 0; p < 4; ++p) {
+        producers.emplace_back([&threads, &count, p]() {
+                                   for (uint32_t i = 0; i < 10000; ++i) {
+                                       threads.execute(ExecutorId((p + i) % 3), [&count]() { ++count; });
+                                   }
+                               });
+    }
+    for (auto &producer : producers) {
+        producer.join();
+    }
+    threads.sync();
+    EXPECT_EQUAL(40000u, count.load());
+}
+
+TEST("require that producer is blocked when task limit is reached")
+{
+    LockFreeSequencedTaskExecutor threads(1, 2);
+    vespalib::Gate gate;
+    std::atomic<bool> accepted(false);
+    threads.execute(ExecutorId(0), [&gate]() { gate.await(); });
+    threads.execute(ExecutorId(0), []() { });
+    std::thread producer([&threads, &accepted]() {
+                             threads.execute(ExecutorId(0), []() { });
+                             accepted = true;
+                         });
+    std::this_thread::sleep_for(20ms);
+    EXPECT_FALSE(accepted);
+    gate.countDown();
+    producer.join();
+    EXPECT_TRUE(accepted);
+    threads.sync();
+    auto stats = threads.getStats();
+    EXPECT_EQUAL(3u, stats.acceptedTasks);
+    EXPECT_EQUAL(2u, stats.maxPendingTasks);
+}
+
+TEST("require that raising task limit releases blocked producer")
+{
+    LockFreeSequencedTaskExecutor threads(1, 1);
+    vespalib::Gate gate;
+    threads.execute(ExecutorId(0), [&gate]() { gate.await(); });
+    std::thread producer([&threads]() { threads.execute(ExecutorId(0), []() { }); });
+    std::this_thread::sleep_for(10ms);
+    threads.setTaskLimit(10);
+    producer.join();
+    gate.countDown();
+    threads.sync();
+}
+
+TEST("require that blocked worker is woken up by new tasks")
+{
+    LockFreeSequencedTaskExecutor threads(1);
+    std::atomic<uint32_t> count(0);
+    for (uint32_t i = 0; i < 5; ++i) {
+        threads.execute(ExecutorId(0), [&count]() { ++count; });
+        std::this_thread::sleep_for(5ms);
+        EXPECT_EQUAL(i + 1, count.load());
+    }
+    threads.sync();
+}
+
+TEST("require that tasks are rejected after shutdown")
+{
+    LockFreeSequencedTaskExecutor threads(2);
+    std::atomic<uint32_t> count(0);
+    threads.execute(ExecutorId(0), [&count]() { ++count; });
+    threads.shutdown();
+    threads.execute(ExecutorId(0), [&count]() { ++count; });
+    threads.execute(ExecutorId(1), [&count]() { ++count; });
+    threads.sync();
+    EXPECT_EQUAL(1u, count.load());
+    auto stats = threads.getStats();
+    EXPECT_EQUAL(1u, stats.acceptedTasks);
+    EXPECT_EQUAL(2u, stats.rejectedTasks);
+}
+
+TEST("require that executor ids are assigned round robin")
+{
+    LockFreeSequencedTaskExecutor threads(3);
+    EXPECT_EQUAL(3u, threads.getNumExecutors());
+    EXPECT_EQUAL(0u, threads.getExecutorId(17).getId());
+    EXPECT_EQUAL(1u, threads.getExecutorId(5).getId());
+    EXPECT_EQUAL(2u, threads.getExecutorId(9).getId());
+    EXPECT_EQUAL(0u, threads.getExecutorId(1).getId());
+    EXPECT_EQUAL(1u, threads.getExecutorId(5).getId());
+}
+
+}
+
+TEST_MAIN() { TEST_RUN_ALL(); }
@@ -0,0 +1,95 @@
+// Copyright 2019 Oath Inc. Licensed under the terms of the Apache 2.0 license. See LICENSE in the project root.
+
+#include <vespa/searchlib/common/lockfreesequencedtaskexecutor.h>
+#include <vespa/searchlib/common/sequencedtaskexecutor.h>
+#include <vespa/vespalib/testkit/testapp.h>
+#include <vespa/vespalib/util/executor_stats.h>
+#include <vespa/vespalib/util/time.h>
+#include <memory>
+#include <vector>
+
+#include <vespa/log/log.h>
+LOG_SETUP("sequencedtaskexecutor_benchmark");
+
+using namespace search;
+using ExecutorId = ISequencedTaskExecutor::ExecutorId;
+
+namespace {
+
+constexpr uint32_t numThreads = 4;
+constexpr uint32_t numAttributes = 16;
+constexpr uint32_t numPuts = 500000;
+constexpr uint32_t commitInterval = 100;
+constexpr uint32_t docIdLimit = 65536;
+
+/*
+ * Mimics the task pattern of AttributeWriter: for each put, one task per
+ * field writer executor applies the values of the attributes assigned
+ * to it, keeping a shared completion token alive. A commit task is
+ * scheduled per executor at regular intervals.
+ */
+struct AttributePutFixture {
+    std::vector<std::vector<int64_t>> _attributes;
+    std::vector<std::vector<uint32_t>> _writeContexts;
+    std::vector<uint64_t> _commits;
+
+    AttributePutFixture()
+        : _attributes(numAttributes, std::vector<int64_t>(docIdLimit)),
+          _writeContexts(numThreads),
+          _commits(numThreads)
+    {
+        for (uint32_t i = 0; i < numAttributes; ++i) {
+            _writeContexts[i % numThreads].push_back(i);
+        }
+    }
+
+    template <typename ExecutorType>
+    double run(ExecutorType &executor) {
+        vespalib::Timer timer;
+        for (uint32_t put = 0; put < numPuts; ++put) {
+            uint32_t lid = put % docIdLimit;
+            auto onWriteDone = std::make_shared<uint32_t>(put);
+            for (uint32_t id = 0; id < numThreads; ++id) {
+                executor.execute(ExecutorId(id), [this, id, lid, onWriteDone]() {
+                                     for (uint32_t attr : _writeContexts[id]) {
+                                         _attributes[attr][lid] = *onWriteDone;
+                                     }
+                                 });
+            }
+            if ((put % commitInterval) == 0) {
+                for (uint32_t id = 0; id < numThreads; ++id) {
+                    executor.execute(ExecutorId(id), [this, id]() { ++_commits[id]; });
+                }
+            }
+        }
+        executor.sync();
+        return numPuts / vespalib::to_s(timer.elapsed());
+    }
+};
+
+template <typename ExecutorType>
+void
+benchmark(const char *name, uint32_t taskLimit)
+{
+    AttributePutFixture f;
+    ExecutorType executor(numThreads, taskLimit);
+    double putsPerSecond = f.run(executor);
+    auto stats = executor.getStats();
+    LOG(info, "%s (task limit %u): %.0f puts/s, %zu tasks, max pending %zu",
+        name, taskLimit, putsPerSecond, stats.acceptedTasks, stats.maxPendingTasks);
+    EXPECT_EQUAL(numPuts * numThreads + ((numPuts + commitInterval - 1) / commitInterval) * numThreads, stats.acceptedTasks);
+}
+
+}
+
+TEST("benchmark attribute writer put pattern")
+{
+    for (uint32_t taskLimit : {100u, 1000u}) {
+        for (uint32_t rep = 0; rep < 3; ++rep) {
+            benchmark<SequencedTaskExecutor>("SequencedTaskExecutor", taskLimit);
+            benchmark<LockFreeSequencedTaskExecutor>("LockFreeSequencedTaskExecutor", taskLimit);
+        }
+    }
+}
+
+TEST_MAIN() { TEST_RUN_ALL(); }
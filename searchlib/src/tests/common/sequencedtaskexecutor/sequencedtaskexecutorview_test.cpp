@@ -0,0 +1,114 @@
+// Copyright 2019 Oath Inc. Licensed under the terms of the Apache 2.0 license. See LICENSE in the project root.
+
+#include <vespa/searchlib/common/sequencedtaskexecutor.h>
+#include <vespa/searchlib/common/sequencedtaskexecutorobserver.h>
+#include <vespa/searchlib/common/sequencedtaskexecutorview.h>
+#include <vespa/vespalib/testkit/testapp.h>
+#include <vespa/vespalib/test/insertion_operators.h>
+#include <vespa/vespalib/util/gate.h>
+#include <atomic>
+#include <thread>
+
+#include <vespa/log/log.h>
+LOG_SETUP("sequencedtaskexecutorview_test");
+
+namespace search::common {
+
+using ExecutorId = ISequencedTaskExecutor::ExecutorId;
+
+class Fixture
+{
+public:
+    SequencedTaskExecutor         _threads;
+    SequencedTaskExecutorObserver _observer;
+    SequencedTaskExecutorView     _a;
+    SequencedTaskExecutorView     _b;
+
+    Fixture()
+        : _threads(3),
+          _observer(_threads),
+          _a(_observer, 3, 0, 10),
+          _b(_observer, 2, 2, 10)
+    {
+    }
+};
+
+TEST_F("require that view executor ids are mapped from offset", Fixture)
+{
+    EXPECT_EQUAL(3u, f._a.getNumExecutors());
+    EXPECT_EQUAL(2u, f._b.getNumExecutors());
+    for (uint32_t id = 0; id < 3; ++id) {
+        f._a.execute(ExecutorId(id), []() { });
+    }
+    for (uint32_t id = 0; id < 2; ++id) {
+        f._b.execute(ExecutorId(id), []() { });
+    }
+    f._a.sync();
+    f._b.sync();
+    std::vector<uint32_t> exp({0, 1, 2, 2, 0});
+    EXPECT_EQUAL(exp, f._observer.getExecuteHistory());
+}
+
+TEST_F("require that component ids are mapped per view", Fixture)
+{
+    EXPECT_EQUAL(0u, f._a.getExecutorId(7).getId());
+    EXPECT_EQUAL(1u, f._a.getExecutorId(8).getId());
+    EXPECT_EQUAL(0u, f._b.getExecutorId(8).getId());
+    EXPECT_EQUAL(1u, f._b.getExecutorId(7).getId());
+    EXPECT_EQUAL(1u, f._a.getExecutorId(8).getId());
+}
+
+TEST_F("require that sync only waits for tasks in same view", Fixture)
+{
+    vespalib::Gate gate;
+    std::atomic<bool> done(false);
+    f._a.execute(ExecutorId(0), [&gate]() { gate.await(); });
+    f._b.execute(ExecutorId(0), [&done]() { done = true; });
+    f._b.sync();
+    EXPECT_TRUE(done);
+    gate.countDown();
+    f._a.sync();
+}
+
+TEST_F("require that producer is blocked when task limit for view is reached", Fixture)
+{
+    SequencedTaskExecutorView view(f._threads, 1, 1, 2);
+    vespalib::Gate gate;
+    std::atomic<bool> accepted(false);
+    view.execute(ExecutorId(0), [&gate]() { gate.await(); });
+    view.execute(ExecutorId(0), []() { });
+    std::thread producer([&view, &accepted]() {
+                             view.execute(ExecutorId(0), []() { });
+                             accepted = true;
+                         });
+    std::this_thread::sleep_for(20ms);
+    EXPECT_FALSE(accepted);
+    f._b.execute(ExecutorId(0), []() { });
+    f._b.sync();
+    gate.countDown();
+    producer.join();
+    EXPECT_TRUE(accepted);
+    view.sync();
+    auto stats = view.getStats();
+    EXPECT_EQUAL(3u, stats.acceptedTasks);
+    EXPECT_EQUAL(2u, stats.maxPendingTasks);
+}
+
+TEST("require that view can be destroyed right after a burst of tasks")
+{
+    SequencedTaskExecutor threads(4);
+    std::atomic<uint32_t> count(0);
+    for (uint32_t round = 0; round < 200; ++round) {
+        auto view = std::make_unique<SequencedTaskExecutorView>(threads, 4, round % 4, 100);
+        for (uint32_t i = 0; i < 100; ++i) {
+            view->execute(ExecutorId(i % 4), [&count]() { ++count; });
+        }
+        view.reset();
+        EXPECT_EQUAL((round + 1) * 100, count.load());
+    }
+    threads.sync();
+}
+
+}
+
+TEST_MAIN() { TEST_RUN_ALL(); }
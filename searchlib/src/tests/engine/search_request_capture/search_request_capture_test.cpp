@@ -0,0 +1,121 @@
+// Copyright 2019 Oath Inc. Licensed under the terms of the Apache 2.0 license. See LICENSE in the project root.
+
+#include <vespa/vespalib/gtest/gtest.h>
+#include <vespa/searchlib/engine/search_protocol_proto.h>
+#include <vespa/searchlib/engine/search_request_capture.h>
+#include <vector>
+#include <unistd.h>
+
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Winline"
+
+using search::engine::SearchRequestCapture;
+using ProtoSearchRequest = SearchRequestCapture::ProtoSearchRequest;
+
+const vespalib::string capture_file("capture.bin");
+const vespalib::string rotated_file("capture.bin.1");
+
+struct SearchRequestCaptureTest : ::testing::Test {
+    SearchRequestCaptureTest() { cleanup(); }
+    ~SearchRequestCaptureTest() { cleanup(); }
+    static void cleanup() {
+        unlink(capture_file.c_str());
+        unlink(rotated_file.c_str());
+    }
+    static ProtoSearchRequest make_request(int offset) {
+        ProtoSearchRequest req;
+        req.set_offset(offset);
+        req.set_hits(10);
+        req.set_query_tree_blob("query blob");
+        return req;
+    }
+    static std::vector<int> read_offsets(const vespalib::string &file_name) {
+        std::vector<int> offsets;
+        SearchRequestCapture::read_file(file_name, [&offsets](ProtoSearchRequest &req)
+                                        {
+                                            EXPECT_EQ(req.hits(), 10);
+                                            EXPECT_EQ(req.query_tree_blob(), "query blob");
+                                            offsets.push_back(req.offset());
+                                        });
+        return offsets;
+    }
+};
+
+TEST_F(SearchRequestCaptureTest, all_requests_are_captured_when_sampling_every_request) {
+    {
+        SearchRequestCapture capture(capture_file, 1, 1000000);
+        for (int i = 0; i < 5; ++i) {
+            capture.sample(make_request(i));
+        }
+        capture.sync();
+        EXPECT_EQ(capture.captured(), 5u);
+        EXPECT_EQ(capture.dropped(), 0u);
+    }
+    EXPECT_EQ(read_offsets(capture_file), std::vector<int>({0, 1, 2, 3, 4}));
+}
+
+TEST_F(SearchRequestCaptureTest, every_nth_request_is_captured) {
+    {
+        SearchRequestCapture capture(capture_file, 3, 1000000);
+        for (int i = 0; i < 10; ++i) {
+            capture.sample(make_request(i));
+        }
+        capture.sync();
+        EXPECT_EQ(capture.captured(), 4u);
+    }
+    EXPECT_EQ(read_offsets(capture_file), std::vector<int>({0, 3, 6, 9}));
+}
+
+TEST_F(SearchRequestCaptureTest, queued_requests_are_written_by_sync) {
+    SearchRequestCapture capture(capture_file, 1, 1000000);
+    capture.sample(make_request(1));
+    capture.sample(make_request(2));
+    capture.sync();
+    EXPECT_EQ(read_offsets(capture_file), std::vector<int>({1, 2}));
+    capture.sample(make_request(3));
+    capture.sync();
+    EXPECT_EQ(read_offsets(capture_file), std::vector<int>({1, 2, 3}));
+}
+
+TEST_F(SearchRequestCaptureTest, capture_file_is_rotated_when_full) {
+    size_t record_size = 4 + make_request(0).ByteSizeLong();
+    {
+        SearchRequestCapture capture(capture_file, 1, 3 * record_size);
+        for (int i = 0; i < 5; ++i) {
+            capture.sample(make_request(i));
+        }
+    }
+    EXPECT_EQ(read_offsets(rotated_file), std::vector<int>({0, 1, 2}));
+    EXPECT_EQ(read_offsets(capture_file), std::vector<int>({3, 4}));
+}
+
+TEST_F(SearchRequestCaptureTest, capture_is_appended_to_existing_file) {
+    {
+        SearchRequestCapture capture(capture_file, 1, 1000000);
+        capture.sample(make_request(1));
+    }
+    {
+        SearchRequestCapture capture(capture_file, 1, 1000000);
+        capture.sample(make_request(2));
+    }
+    EXPECT_EQ(read_offsets(capture_file), std::vector<int>({1, 2}));
+}
+
+TEST_F(SearchRequestCaptureTest, truncated_record_at_end_of_file_is_ignored) {
+    {
+        SearchRequestCapture capture(capture_file, 1, 1000000);
+        capture.sample(make_request(1));
+        capture.sample(make_request(2));
+    }
+    size_t record_size = 4 + make_request(0).ByteSizeLong();
+    ASSERT_EQ(truncate(capture_file.c_str(), 2 * record_size - 3), 0);
+    EXPECT_EQ(read_offsets(capture_file), std::vector<int>({1}));
+}
+
+TEST_F(SearchRequestCaptureTest, missing_file_gives_no_requests) {
+    EXPECT_TRUE(read_offsets(capture_file).empty());
+}
+
+GTEST_MAIN_RUN_ALL_TESTS()
+
+#pragma GCC diagnostic pop
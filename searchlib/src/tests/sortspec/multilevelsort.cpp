@@ -362,6 +362,21 @@ void MultilevelSortTest::testSortMethod(int method)
         srand(time(NULL));
         sortAndCheck(spec, 5000, 8, strValues);
     }
+    {
+        // Only fixed width sort levels
+        std::vector<Spec> spec;
+        spec.push_back(Spec("int8", INT8));
+        spec.push_back(Spec("int64", INT64, false));
+        spec.push_back(Spec("double", DOUBLE));
+        spec.push_back(Spec("rank", RANK, false));
+        spec.push_back(Spec("docid", DOCID));
+
+        std::vector<std::string> none;
+        srand(12345);
+        sortAndCheck(spec, 5000, 4, none);
+        srand(time(NULL));
+        sortAndCheck(spec, 5000, 8, none);
+    }
     {
         std::vector<std::string> none;
         uint32_t num = 50;
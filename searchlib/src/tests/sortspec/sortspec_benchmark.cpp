@@ -0,0 +1,88 @@
+// Copyright 2019 Oath Inc. Licensed under the terms of the Apache 2.0 license. See LICENSE in the project root.
+
+#include <vespa/searchlib/common/sortresults.h>
+#include <vespa/searchlib/attribute/attributecontext.h>
+#include <vespa/searchlib/attribute/attributefactory.h>
+#include <vespa/searchlib/attribute/attributemanager.h>
+#include <vespa/searchlib/attribute/floatbase.h>
+#include <vespa/searchlib/attribute/integerbase.h>
+#include <vespa/searchlib/uca/ucaconverter.h>
+#include <vespa/vespalib/testkit/test_kit.h>
+#include <vespa/vespalib/util/benchmark_timer.h>
+#include <random>
+
+using namespace search;
+using search::attribute::BasicType;
+using search::attribute::CollectionType;
+using search::attribute::Config;
+using vespalib::BenchmarkTimer;
+
+namespace {
+
+constexpr uint32_t NUM_DOCS = 1000000;
+
+/**
+ * Models "sort by price, then date" over a large result set, with few enough
+ * distinct prices that many hits tie on the first sort level.
+ **/
+struct Fixture {
+    AttributeManager mgr;
+    std::vector<RankedHit> hits;
+    vespalib::Clock clock;
+    vespalib::Doom doom;
+    search::uca::UcaConverterFactory ucaFactory;
+
+    Fixture()
+        : mgr(),
+          hits(),
+          clock(),
+          doom(clock, vespalib::steady_time::max()),
+          ucaFactory()
+    {
+        std::mt19937 rnd(42);
+        AttributeVector::SP price = AttributeFactory::createAttribute("price", Config(BasicType::DOUBLE, CollectionType::SINGLE));
+        AttributeVector::SP date = AttributeFactory::createAttribute("date", Config(BasicType::INT64, CollectionType::SINGLE));
+        ASSERT_TRUE(price->addDocs(NUM_DOCS));
+        ASSERT_TRUE(date->addDocs(NUM_DOCS));
+        auto &priceAttr = static_cast<FloatingPointAttribute &>(*price);
+        auto &dateAttr = static_cast<IntegerAttribute &>(*date);
+        for (uint32_t docId = 0; docId < NUM_DOCS; ++docId) {
+            priceAttr.update(docId, (rnd() % 10000) / 100.0);
+            dateAttr.update(docId, 1500000000 + (rnd() % 100000000));
+        }
+        price->commit();
+        date->commit();
+        mgr.add(price);
+        mgr.add(date);
+        hits.reserve(NUM_DOCS);
+        for (uint32_t docId = 0; docId < NUM_DOCS; ++docId) {
+            hits.emplace_back(docId, rnd() % 1000);
+        }
+    }
+
+    void benchmark(const vespalib::string &sortSpec, int method, uint32_t topn) {
+        std::vector<RankedHit> work(hits);
+        double min_time_s = BenchmarkTimer::benchmark([&]() {
+            AttributeContext ac(mgr);
+            FastS_SortSpec sorter(7, doom, ucaFactory, method);
+            ASSERT_TRUE(sorter.Init(sortSpec, ac));
+            std::copy(hits.begin(), hits.end(), work.begin());
+            sorter.sortResults(&work[0], work.size(), topn);
+        }, 5.0);
+        fprintf(stderr, "sort '%s' (method %d, %u hits, top %u): %g ms\n",
+                sortSpec.c_str(), method, NUM_DOCS, topn, min_time_s * 1000.0);
+    }
+};
+
+}
+
+TEST_F("benchmark multi-level attribute sorting of 1M hits", Fixture()) {
+    for (int method : {1, 2}) {
+        f1.benchmark("+price", method, NUM_DOCS);
+        f1.benchmark("+price +date", method, NUM_DOCS);
+        f1.benchmark("+price +date", method, 1000);
+        f1.benchmark("-price -date +[docid]", method, 1000);
+    }
+}
+
+TEST_MAIN() { TEST_RUN_ALL(); }
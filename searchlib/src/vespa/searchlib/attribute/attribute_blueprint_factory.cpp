@@ -2,6 +2,7 @@
 
 #include "attribute_blueprint_factory.h"
 #include "attribute_weighted_set_blueprint.h"
+#include "geo_nearest_blueprint.h"
 #include "i_document_weight_attribute.h"
 #include "iterator_pack.h"
 #include "predicate_attribute.h"
@@ -267,6 +268,9 @@ make_location_blueprint(const FieldSpec &field, const IAttributeVector &attribut
     {
         return std::make_unique<queryeval::EmptyBlueprint>(field);
     }
+    if (location.getTargetHits() > 0) {
+        return std::make_unique<attribute::GeoNearestBlueprint>(field, attribute, loc.getLocationString());
+    }
     ZCurve::RangeVector rangeVector = ZCurve::find_ranges(
             location.getMinX(), location.getMinY(),
             location.getMaxX(), location.getMaxY());
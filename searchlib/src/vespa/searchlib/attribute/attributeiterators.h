@@ -165,6 +165,49 @@ public:
     { }
 };
 
+/**
+ * Strict iterators used for attribute vectors that keep a zone map
+ * (min/max per block of lids). Blocks that cannot contain a match are
+ * skipped without looking at the values.
+ *
+ * @param SC the specialized search context type associated with this iterator,
+ *           must provide nextCandidate(docId) and blockEnd(docId)
+ */
+template <typename SC>
+class ZoneMapAttributeIteratorStrict : public AttributeIteratorT<SC>
+{
+private:
+    using AttributeIteratorT<SC>::_concreteSearchCtx;
+    using AttributeIteratorT<SC>::setDocId;
+    using AttributeIteratorT<SC>::setAtEnd;
+    using AttributeIteratorT<SC>::isAtEnd;
+    using AttributeIteratorT<SC>::_weight;
+    using Trinary=vespalib::Trinary;
+    void doSeek(uint32_t docId) override;
+    Trinary is_strict() const override { return Trinary::True; }
+public:
+    ZoneMapAttributeIteratorStrict(const SC &concreteSearchCtx, fef::TermFieldMatchData * matchData)
+        : AttributeIteratorT<SC>(concreteSearchCtx, matchData)
+    { }
+};
+
+template <typename SC>
+class ZoneMapFilterAttributeIteratorStrict : public FilterAttributeIteratorT<SC>
+{
+private:
+    using FilterAttributeIteratorT<SC>::_concreteSearchCtx;
+    using FilterAttributeIteratorT<SC>::setDocId;
+    using FilterAttributeIteratorT<SC>::setAtEnd;
+    using FilterAttributeIteratorT<SC>::isAtEnd;
+    using Trinary=vespalib::Trinary;
+    void doSeek(uint32_t docId) override;
+    Trinary is_strict() const override { return Trinary::True; }
+public:
+    ZoneMapFilterAttributeIteratorStrict(const SC &concreteSearchCtx, fef::TermFieldMatchData *matchData)
+        : FilterAttributeIteratorT<SC>(concreteSearchCtx, matchData)
+    { }
+};
+
 /**
  * This class acts as an iterator over documents that are results for
  * the subquery represented by the search context object associated
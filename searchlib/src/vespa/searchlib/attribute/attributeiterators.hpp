@@ -389,6 +389,40 @@ FilterAttributeIteratorStrict<SC>::doSeek(uint32_t docId)
     setAtEnd();
 }
 
+template <typename SC>
+void
+ZoneMapAttributeIteratorStrict<SC>::doSeek(uint32_t docId)
+{
+    for (uint32_t nextId = _concreteSearchCtx.nextCandidate(docId); !isAtEnd(nextId);
+         nextId = _concreteSearchCtx.nextCandidate(nextId))
+    {
+        for (uint32_t blockEnd = _concreteSearchCtx.blockEnd(nextId); (nextId < blockEnd) && !isAtEnd(nextId); ++nextId) {
+            if (this->matches(nextId, _weight)) {
+                setDocId(nextId);
+                return;
+            }
+        }
+    }
+    setAtEnd();
+}
+
+template <typename SC>
+void
+ZoneMapFilterAttributeIteratorStrict<SC>::doSeek(uint32_t docId)
+{
+    for (uint32_t nextId = _concreteSearchCtx.nextCandidate(docId); !isAtEnd(nextId);
+         nextId = _concreteSearchCtx.nextCandidate(nextId))
+    {
+        for (uint32_t blockEnd = _concreteSearchCtx.blockEnd(nextId); (nextId < blockEnd) && !isAtEnd(nextId); ++nextId) {
+            if (this->matches(nextId)) {
+                setDocId(nextId);
+                return;
+            }
+        }
+    }
+    setAtEnd();
+}
+
 template <typename SC>
 void
 AttributeIteratorT<SC>::or_hits_into(BitVector & result, uint32_t begin_id) {
@@ -3,14 +3,28 @@
 #include "bitvector_search_cache.h"
 #include <vespa/searchlib/common/bitvector.h>
 #include <vespa/vespalib/stllike/hash_map.hpp>
+#include <algorithm>
+#include <limits>
 
 namespace search::attribute {
 
 using BitVectorSP = BitVectorSearchCache::BitVectorSP;
 
 BitVectorSearchCache::BitVectorSearchCache()
+    : BitVectorSearchCache(std::numeric_limits<size_t>::max())
+{
+}
+
+BitVectorSearchCache::BitVectorSearchCache(size_t maxBytes)
     : _mutex(),
-      _cache()
+      _cache(),
+      _frequencies(),
+      _maxBytes(maxBytes),
+      _changeCount(0),
+      _memoryUsed(0),
+      _hits(0),
+      _misses(0),
+      _invalidations(0)
 {
 }
 
@@ -18,10 +32,108 @@ BitVectorSearchCache::~BitVectorSearchCache()
 {
 }
 
+size_t
+BitVectorSearchCache::Entry::memoryUsage() const
+{
+    return sizeof(Entry) + (bitVector ? bitVector->sizeBytes() : 0);
+}
+
+bool
+BitVectorSearchCache::checkChangeCount(uint64_t changeCount, Cache &dropped, const LockGuard &)
+{
+    if (changeCount < _changeCount) {
+        return false;
+    }
+    if (changeCount > _changeCount) {
+        _invalidations += _cache.size();
+        _memoryUsed = 0;
+        dropped.swap(_cache);
+        _changeCount = changeCount;
+    }
+    return true;
+}
+
+void
+BitVectorSearchCache::countLookup(const vespalib::string &term, const LockGuard &)
+{
+    auto itr = _frequencies.find(term);
+    if (itr != _frequencies.end()) {
+        ++itr->second;
+        return;
+    }
+    if (_frequencies.size() >= MAX_TRACKED_TERMS) {
+        // Age all counts, forgetting terms that have only been looked up once
+        Frequencies aged;
+        for (const auto &frequency : _frequencies) {
+            if (frequency.second > 1) {
+                aged[frequency.first] = frequency.second / 2;
+            }
+        }
+        _frequencies.swap(aged);
+    }
+    if (_frequencies.size() < MAX_TRACKED_TERMS) {
+        _frequencies[term] = 1;
+    }
+}
+
+uint32_t
+BitVectorSearchCache::getFrequency(const vespalib::string &term, const LockGuard &) const
+{
+    auto itr = _frequencies.find(term);
+    return (itr != _frequencies.end()) ? itr->second : 0u;
+}
+
+bool
+BitVectorSearchCache::makeRoom(size_t bytes, uint32_t frequency, std::vector<Entry::SP> &evicted,
+                               const LockGuard &guard)
+{
+    if (_memoryUsed + bytes <= _maxBytes) {
+        return true;
+    }
+    if (bytes > _maxBytes) {
+        return false;
+    }
+    std::vector<std::pair<uint32_t, vespalib::string>> victims;
+    for (const auto &entry : _cache) {
+        uint32_t victimFrequency = getFrequency(entry.first, guard);
+        if (victimFrequency < frequency) {
+            victims.emplace_back(victimFrequency, entry.first);
+        }
+    }
+    std::sort(victims.begin(), victims.end());
+    size_t freed = 0;
+    size_t numVictims = 0;
+    while (numVictims < victims.size() && _memoryUsed - freed + bytes > _maxBytes) {
+        freed += _cache.find(victims[numVictims].second)->second->memoryUsage();
+        ++numVictims;
+    }
+    if (_memoryUsed - freed + bytes > _maxBytes) {
+        return false;
+    }
+    for (size_t i = 0; i < numVictims; ++i) {
+        auto itr = _cache.find(victims[i].second);
+        evicted.push_back(std::move(itr->second));
+        _cache.erase(itr);
+    }
+    _memoryUsed -= freed;
+    return true;
+}
+
 void
 BitVectorSearchCache::insert(const vespalib::string &term, Entry::SP entry)
 {
+    // Declared before the guard to destroy dropped and evicted entries outside the lock
+    Cache dropped;
+    std::vector<Entry::SP> evicted;
     LockGuard guard(_mutex);
+    if (!checkChangeCount(entry->changeCount, dropped, guard) || _cache.find(term) != _cache.end()) {
+        return;
+    }
+    size_t bytes = entry->memoryUsage();
+    if (!makeRoom(bytes, getFrequency(term, guard), evicted, guard)) {
+        return;
+    }
+    _memoryUsed += bytes;
     _cache.insert(std::make_pair(term, std::move(entry)));
 }
 
@@ -31,8 +143,35 @@ BitVectorSearchCache::find(const vespalib::string &term) const
     LockGuard guard(_mutex);
     auto itr = _cache.find(term);
     if (itr != _cache.end()) {
+        ++_hits;
         return itr->second;
     }
+    ++_misses;
+    return Entry::SP();
+}
+
+BitVectorSearchCache::Entry::SP
+BitVectorSearchCache::find(const vespalib::string &term, uint64_t changeCount, uint32_t docIdLimit)
+{
+    // Declared before the guard to destroy dropped entries outside the lock
+    Cache dropped;
+    Entry::SP stale;
+    LockGuard guard(_mutex);
+    countLookup(term, guard);
+    if (checkChangeCount(changeCount, dropped, guard)) {
+        auto itr = _cache.find(term);
+        if (itr != _cache.end()) {
+            if (itr->second->docIdLimit == docIdLimit) {
+                ++_hits;
+                return itr->second;
+            }
+            stale = std::move(itr->second);
+            _cache.erase(itr);
+            _memoryUsed -= stale->memoryUsage();
+            ++_invalidations;
+        }
+    }
+    ++_misses;
     return Entry::SP();
 }
 
@@ -43,11 +182,27 @@ BitVectorSearchCache::size() const
     return _cache.size();
 }
 
+CacheStats
+BitVectorSearchCache::getStats() const
+{
+    LockGuard guard(_mutex);
+    return CacheStats(_hits, _misses, _cache.size(), _memoryUsed, _invalidations);
+}
+
+vespalib::MemoryUsage
+BitVectorSearchCache::getMemoryUsage() const
+{
+    LockGuard guard(_mutex);
+    return vespalib::MemoryUsage(_memoryUsed, _memoryUsed, 0, 0);
+}
+
 void
 BitVectorSearchCache::clear()
 {
+    Cache dropped;
     LockGuard guard(_mutex);
-    _cache.clear();
+    dropped.swap(_cache);
+    _memoryUsed = 0;
 }
 
 }
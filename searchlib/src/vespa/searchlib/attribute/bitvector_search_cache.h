@@ -3,10 +3,13 @@
 #pragma once
 
 #include <vespa/searchlib/common/i_document_meta_store_context.h>
+#include <vespa/searchlib/docstore/cachestats.h>
+#include <vespa/vespalib/util/memoryusage.h>
 #include <vespa/vespalib/stllike/hash_map.h>
 #include <vespa/vespalib/stllike/string.h>
 #include <memory>
 #include <mutex>
+#include <vector>
 
 namespace search {
 
@@ -17,7 +20,17 @@ namespace attribute {
 /**
  * Class that caches posting lists (as bit vectors) for a set of search terms.
  *
- * Lifetime of cached bit vectors is controlled by calling clear() at regular intervals.
+ * Lifetime of cached bit vectors is controlled by calling clear() at regular intervals,
+ * or by tagging entries with the posting list change count of the attribute they were
+ * computed for. The cache only holds entries for the newest change count seen, and all
+ * entries are dropped when a newer change count is seen. Dropped entries are destroyed
+ * after the cache lock has been released. On an attribute that is fed continuously the
+ * cache thus only helps queries arriving between two commits changing posting lists.
+ *
+ * The memory used by cached entries is limited by a byte budget. Lookups are counted per
+ * term (halving all counts when too many terms are tracked), and counts survive dropped
+ * entries. When the cache is full, a new entry is only admitted if its term has been
+ * looked up more often than the cached entries evicted to make room for it.
  */
 class BitVectorSearchCache {
 public:
@@ -31,23 +44,51 @@ public:
         ReadGuardUP dmsReadGuard;
         BitVectorSP bitVector;
         uint32_t docIdLimit;
-        Entry(ReadGuardUP dmsReadGuard_, BitVectorSP bitVector_, uint32_t docIdLimit_)
-            : dmsReadGuard(std::move(dmsReadGuard_)), bitVector(std::move(bitVector_)), docIdLimit(docIdLimit_) {}
+        uint64_t changeCount;
+        Entry(ReadGuardUP dmsReadGuard_, BitVectorSP bitVector_, uint32_t docIdLimit_, uint64_t changeCount_ = 0)
+            : dmsReadGuard(std::move(dmsReadGuard_)), bitVector(std::move(bitVector_)), docIdLimit(docIdLimit_),
+              changeCount(changeCount_) {}
+        size_t memoryUsage() const;
     };
 
 private:
     using LockGuard = std::lock_guard<std::mutex>;
     using Cache = vespalib::hash_map<vespalib::string, Entry::SP>;
+    using Frequencies = vespalib::hash_map<vespalib::string, uint32_t>;
+
+    static constexpr size_t MAX_TRACKED_TERMS = 1024;
 
     mutable std::mutex _mutex;
     Cache _cache;
+    Frequencies _frequencies;
+    size_t _maxBytes;
+    uint64_t _changeCount;
+    size_t _memoryUsed;
+    mutable size_t _hits;
+    mutable size_t _misses;
+    size_t _invalidations;
+
+    bool checkChangeCount(uint64_t changeCount, Cache &dropped, const LockGuard &guard);
+    void countLookup(const vespalib::string &term, const LockGuard &guard);
+    uint32_t getFrequency(const vespalib::string &term, const LockGuard &guard) const;
+    bool makeRoom(size_t bytes, uint32_t frequency, std::vector<Entry::SP> &evicted, const LockGuard &guard);
 
 public:
     BitVectorSearchCache();
+    explicit BitVectorSearchCache(size_t maxBytes);
     ~BitVectorSearchCache();
     void insert(const vespalib::string &term, Entry::SP entry);
     Entry::SP find(const vespalib::string &term) const;
+    /**
+     * Find the entry for the given term if it was computed for the given
+     * change count and doc id limit. An entry for another doc id limit is
+     * removed, and all entries are removed when a newer change count is seen.
+     * The lookup is counted when deciding which entries to keep when full.
+     */
+    Entry::SP find(const vespalib::string &term, uint64_t changeCount, uint32_t docIdLimit);
     size_t size() const;
+    CacheStats getStats() const;
+    vespalib::MemoryUsage getMemoryUsage() const;
     void clear();
 };
 
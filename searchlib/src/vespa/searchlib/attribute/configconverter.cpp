@@ -67,6 +67,7 @@ ConfigConverter::convert(const AttributesConfig::Attribute & cfg)
     retval.setEnableBitVectors(cfg.enablebitvectors);
     retval.setEnableOnlyBitVector(cfg.enableonlybitvector);
     retval.setIsFilter(cfg.enableonlybitvector);
+    retval.setSearchCacheMaxBytes(cfg.searchcachemaxbytes);
     retval.setFastAccess(cfg.fastaccess);
     retval.setMutable(cfg.ismutable);
     predicateParams.setArity(cfg.arity);
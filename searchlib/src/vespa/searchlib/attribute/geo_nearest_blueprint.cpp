@@ -0,0 +1,314 @@
+// Copyright 2019 Oath Inc. Licensed under the terms of the Apache 2.0 license. See LICENSE in the project root.
+
+#include "geo_nearest_blueprint.h"
+#include <vespa/searchcommon/attribute/i_search_context.h>
+#include <vespa/searchcommon/attribute/iattributevector.h>
+#include <vespa/searchcommon/attribute/search_context_params.h>
+#include <vespa/searchlib/fef/termfieldmatchdata.h>
+#include <vespa/searchlib/query/query_term_decoder.h>
+#include <vespa/searchlib/query/tree/simplequery.h>
+#include <vespa/searchlib/query/tree/stackdumpcreator.h>
+#include <vespa/searchlib/queryeval/emptysearch.h>
+#include <vespa/vespalib/objects/visit.h>
+#include <vespa/vespalib/stllike/hash_set.h>
+#include <algorithm>
+#include <cassert>
+#include <limits>
+
+namespace search::attribute {
+
+using queryeval::SearchIterator;
+using vespalib::geo::ZCurve;
+using Range = ZCurve::Range;
+using RangeVector = ZCurve::RangeVector;
+
+namespace {
+
+// Radius searched in the first round
+constexpr uint32_t INITIAL_RADIUS = 1024;
+
+uint64_t
+distance2(const common::Location &location, int64_t docxy)
+{
+    int32_t docx = 0;
+    int32_t docy = 0;
+    ZCurve::decode(docxy, &docx, &docy);
+    uint32_t dx = (location.getX() > docx)
+                  ? location.getX() - docx
+                  : docx - location.getX();
+    if (location.getXAspect() != 0) {
+        dx = ((uint64_t) dx * location.getXAspect()) >> 32;
+    }
+    uint32_t dy = (location.getY() > docy)
+                  ? location.getY() - docy
+                  : docy - location.getY();
+    return (uint64_t) dx * dx + (uint64_t) dy * dy;
+}
+
+struct Box {
+    int32_t min_x;
+    int32_t min_y;
+    int32_t max_x;
+    int32_t max_y;
+    bool operator==(const Box &rhs) const {
+        return (min_x == rhs.min_x) && (min_y == rhs.min_y) && (max_x == rhs.max_x) && (max_y == rhs.max_y);
+    }
+};
+
+// The area within the given radius of the query position, clipped to the bounding box of the location
+Box
+make_box(const common::Location &location, uint32_t radius)
+{
+    int64_t maxdx = radius;
+    if (location.getXAspect() != 0) {
+        uint64_t maxdx2 = ((static_cast<uint64_t>(radius) << 32) + 0xffffffffu) / location.getXAspect();
+        maxdx = std::min(maxdx2, uint64_t(0xffffffffu));
+    }
+    int64_t x = location.getX();
+    int64_t y = location.getY();
+    return Box{int32_t(std::max(x - maxdx, int64_t(location.getMinX()))),
+               int32_t(std::max(y - radius, int64_t(location.getMinY()))),
+               int32_t(std::min(x + maxdx, int64_t(location.getMaxX()))),
+               int32_t(std::min(y + radius, int64_t(location.getMaxY())))};
+}
+
+/**
+ * Returns the parts of the given (sorted) ranges that are not in the
+ * given (sorted and disjoint) covered ranges.
+ **/
+RangeVector
+subtract_ranges(const RangeVector &ranges, const RangeVector &covered)
+{
+    RangeVector result;
+    auto cov = covered.begin();
+    for (const Range &range : ranges) {
+        int64_t lo = range.min();
+        while ((cov != covered.end()) && (cov->max() < lo)) {
+            ++cov;
+        }
+        for (auto c = cov; ; ++c) {
+            if ((c == covered.end()) || (c->min() > range.max())) {
+                result.emplace_back(lo, range.max());
+                break;
+            }
+            if (c->min() > lo) {
+                result.emplace_back(lo, c->min() - 1);
+            }
+            if (c->max() >= range.max()) {
+                break;
+            }
+            lo = c->max() + 1;
+        }
+    }
+    return result;
+}
+
+/**
+ * Adds the given ranges to the covered ranges, keeping them sorted
+ * and disjoint.
+ **/
+void
+add_ranges(RangeVector &covered, const RangeVector &ranges)
+{
+    covered.insert(covered.end(), ranges.begin(), ranges.end());
+    std::sort(covered.begin(), covered.end());
+    RangeVector merged;
+    for (const Range &range : covered) {
+        if (!merged.empty() &&
+            ((range.min() <= merged.back().max()) || (range.min() == merged.back().max() + 1)))
+        {
+            merged.back().max(std::max(merged.back().max(), range.max()));
+        } else {
+            merged.push_back(range);
+        }
+    }
+    covered.swap(merged);
+}
+
+class NearestCollector {
+public:
+    struct Candidate {
+        uint32_t docid;
+        uint64_t distance2;
+        bool operator<(const Candidate &rhs) const {
+            return (distance2 < rhs.distance2) || ((distance2 == rhs.distance2) && (docid < rhs.docid));
+        }
+    };
+private:
+    const IAttributeVector                 &_attribute;
+    const common::Location                 &_location;
+    uint64_t                                _maxDistance2;
+    std::vector<IAttributeVector::largeint_t> _pos;
+    vespalib::hash_set<uint32_t>            _seen;
+    std::vector<Candidate>                  _candidates;
+public:
+    NearestCollector(const IAttributeVector &attribute, const common::Location &location)
+        : _attribute(attribute),
+          _location(location),
+          _maxDistance2(static_cast<uint64_t>(location.getRadius()) * location.getRadius()),
+          _pos(1),
+          _seen(),
+          _candidates()
+    { }
+
+    void consider(uint32_t docid) {
+        if (!_seen.insert(docid).second) {
+            return;
+        }
+        uint32_t numValues = _attribute.get(docid, &_pos[0], _pos.size());
+        if (numValues > _pos.size()) {
+            _pos.resize(numValues);
+            numValues = _attribute.get(docid, &_pos[0], _pos.size());
+        }
+        uint64_t best = std::numeric_limits<uint64_t>::max();
+        for (uint32_t i = 0; i < numValues; ++i) {
+            if (!_location.getzFailBoundingBoxTest(_pos[i])) {
+                best = std::min(best, distance2(_location, _pos[i]));
+            }
+        }
+        if (best <= _maxDistance2) {
+            _candidates.push_back(Candidate{docid, best});
+        }
+    }
+
+    void search_range(const Range &range) {
+        query::Range qr(range.min(), range.max());
+        query::SimpleRangeTerm rt(qr, "", 0, query::Weight(0));
+        vespalib::string stack(query::StackDumpCreator::create(rt));
+        auto ctx = _attribute.createSearchContext(QueryTermDecoder::decodeTerm(stack), SearchContextParams());
+        ctx->fetchPostings(true);
+        fef::TermFieldMatchData tfmd;
+        auto itr = ctx->createIterator(&tfmd, true);
+        itr->initRange(1, _attribute.getNumDocs());
+        for (itr->seek(1); !itr->isAtEnd(); itr->seek(itr->getDocId() + 1)) {
+            consider(itr->getDocId());
+        }
+    }
+
+    size_t count_within(uint64_t distance2) const {
+        return std::count_if(_candidates.begin(), _candidates.end(),
+                             [distance2](const Candidate &c) { return c.distance2 <= distance2; });
+    }
+
+    std::vector<uint32_t> nearest(uint32_t targetHits) {
+        if (_candidates.size() > targetHits) {
+            std::nth_element(_candidates.begin(), _candidates.begin() + targetHits, _candidates.end());
+            _candidates.resize(targetHits);
+        }
+        std::vector<uint32_t> hits;
+        hits.reserve(_candidates.size());
+        for (const Candidate &c : _candidates) {
+            hits.push_back(c.docid);
+        }
+        std::sort(hits.begin(), hits.end());
+        return hits;
+    }
+};
+
+class GeoNearestIterator : public SearchIterator
+{
+private:
+    const std::vector<uint32_t>          &_hits;
+    std::vector<uint32_t>::const_iterator _pos;
+    fef::TermFieldMatchData              &_tfmd;
+
+    void doSeek(uint32_t docid) override {
+        _pos = std::lower_bound(_pos, _hits.end(), docid);
+        if ((_pos == _hits.end()) || isAtEnd(*_pos)) {
+            setAtEnd();
+        } else {
+            setDocId(*_pos);
+        }
+    }
+    void doUnpack(uint32_t docid) override {
+        _tfmd.resetOnlyDocId(docid);
+    }
+public:
+    GeoNearestIterator(const std::vector<uint32_t> &hits, fef::TermFieldMatchData &tfmd)
+        : SearchIterator(),
+          _hits(hits),
+          _pos(hits.begin()),
+          _tfmd(tfmd)
+    { }
+    void initRange(uint32_t begin_id, uint32_t end_id) override {
+        SearchIterator::initRange(begin_id, end_id);
+        _pos = _hits.begin();
+    }
+};
+
+}
+
+GeoNearestBlueprint::GeoNearestBlueprint(const queryeval::FieldSpec &field, const IAttributeVector &attribute,
+                                         const vespalib::string &locationString)
+    : ComplexLeafBlueprint(field),
+      _attribute(attribute),
+      _location(),
+      _hits(),
+      _rounds(0)
+{
+    _location.setVec(attribute);
+    _location.parse(locationString);
+    if ((_location.getTargetHits() > 0) &&
+        (_location.getMinX() <= _location.getMaxX()) &&
+        (_location.getMinY() <= _location.getMaxY()))
+    {
+        findNearest();
+    }
+    setEstimate(HitEstimate(_hits.size(), _hits.empty()));
+}
+
+GeoNearestBlueprint::~GeoNearestBlueprint() = default;
+
+void
+GeoNearestBlueprint::findNearest()
+{
+    NearestCollector collector(_attribute, _location);
+    if (!_attribute.getIsFastSearch()) {
+        for (uint32_t docid = 1; docid < _attribute.getNumDocs(); ++docid) {
+            collector.consider(docid);
+        }
+        _rounds = 1;
+        _hits = collector.nearest(_location.getTargetHits());
+        return;
+    }
+    const Box fullBox = make_box(_location, _location.getRadius());
+    RangeVector covered;
+    uint32_t radius = std::min(_location.getRadius(), INITIAL_RADIUS);
+    for (;;) {
+        Box box = make_box(_location, radius);
+        RangeVector ranges = ZCurve::find_ranges(box.min_x, box.min_y, box.max_x, box.max_y);
+        for (const Range &range : subtract_ranges(ranges, covered)) {
+            collector.search_range(range);
+        }
+        add_ranges(covered, ranges);
+        ++_rounds;
+        uint64_t radius2 = static_cast<uint64_t>(radius) * radius;
+        if ((box == fullBox) || (collector.count_within(radius2) >= _location.getTargetHits())) {
+            break;
+        }
+        radius = (radius > (_location.getRadius() / 2)) ? _location.getRadius() : (radius * 2);
+    }
+    _hits = collector.nearest(_location.getTargetHits());
+}
+
+SearchIterator::UP
+GeoNearestBlueprint::createLeafSearch(const fef::TermFieldMatchDataArray &tfmda, bool) const
+{
+    assert(tfmda.size() == 1);
+    if (_hits.empty()) {
+        return std::make_unique<queryeval::EmptySearch>();
+    }
+    return std::make_unique<GeoNearestIterator>(_hits, *tfmda[0]);
+}
+
+void
+GeoNearestBlueprint::visitMembers(vespalib::ObjectVisitor &visitor) const
+{
+    ComplexLeafBlueprint::visitMembers(visitor);
+    visit(visitor, "attribute", _attribute.getName());
+    visit(visitor, "target_hits", _location.getTargetHits());
+    visit(visitor, "rounds", _rounds);
+    visit(visitor, "hits", _hits.size());
+}
+
+}
@@ -0,0 +1,55 @@
+// Copyright 2019 Oath Inc. Licensed under the terms of the Apache 2.0 license. See LICENSE in the project root.
+
+#pragma once
+
+#include <vespa/searchlib/common/location.h>
+#include <vespa/searchlib/queryeval/blueprint.h>
+#include <vespa/searchlib/queryeval/searchiterator.h>
+#include <vector>
+
+namespace search::attribute {
+
+class IAttributeVector;
+
+/**
+ * Blueprint matching the documents nearest to the query position of a
+ * location term, limited to the number of target hits given with the
+ * location, as well as its radius and bounding box.
+ *
+ * For fast-search attributes the z-curve ranges around the query
+ * position are searched in rounds, doubling the search radius each
+ * round. Ranges searched in earlier rounds are not searched again. We
+ * stop when enough documents are found within the current radius,
+ * since no document outside the searched area can be closer than
+ * that. Attributes without fast-search are scanned once.
+ *
+ * The nearest documents are found when the blueprint is created,
+ * before the other terms of the query are applied. Combining with
+ * filters may therefore leave fewer than target hits matches.
+ **/
+class GeoNearestBlueprint : public queryeval::ComplexLeafBlueprint
+{
+private:
+    const IAttributeVector &_attribute;
+    common::Location        _location;
+    std::vector<uint32_t>   _hits;
+    uint32_t                _rounds;
+
+    void findNearest();
+public:
+    GeoNearestBlueprint(const queryeval::FieldSpec &field, const IAttributeVector &attribute,
+                        const vespalib::string &locationString);
+    ~GeoNearestBlueprint() override;
+
+    const common::Location &location() const { return _location; }
+    /** Sorted document ids of the nearest documents **/
+    const std::vector<uint32_t> &hits() const { return _hits; }
+    /** Number of rounds used to find the nearest documents **/
+    uint32_t rounds() const { return _rounds; }
+
+    queryeval::SearchIterator::UP
+    createLeafSearch(const fef::TermFieldMatchDataArray &tfmda, bool strict) const override;
+    void visitMembers(vespalib::ObjectVisitor &visitor) const override;
+};
+
+}
@@ -3,6 +3,7 @@
 #pragma once
 
 #include <vespa/searchcommon/attribute/iattributevector.h>
+#include <vespa/searchlib/docstore/cachestats.h>
 
 namespace vespalib { class MemoryUsage; }
 
@@ -23,6 +24,7 @@ public:
 
     virtual void forwardedShrinkLidSpace(uint32_t newSize) = 0;
     virtual vespalib::MemoryUsage getMemoryUsage() const = 0;
+    virtual CacheStats getSearchCacheStats() const = 0;
 };
 
 } // namespace search::attribute
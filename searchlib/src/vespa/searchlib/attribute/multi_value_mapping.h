@@ -44,7 +44,7 @@ public:
 
     void doneLoadFromMultiValue() { _store.setInitializing(false); }
 
-    void compactWorst(bool compactMemory, bool compactAddressSpace) override;
+    datastore::ICompactionContext::UP startCompactWorst(bool compactMemory, bool compactAddressSpace) override;
 
     vespalib::AddressSpace getAddressSpaceUsage() const override;
     vespalib::MemoryUsage getArrayStoreMemoryUsage() const override;
@@ -24,7 +24,11 @@ MultiValueMapping<EntryT,RefT>::MultiValueMapping(const datastore::ArrayStoreCon
 }
 
 template <typename EntryT, typename RefT>
-MultiValueMapping<EntryT,RefT>::~MultiValueMapping() = default;
+MultiValueMapping<EntryT,RefT>::~MultiValueMapping()
+{
+    // The compaction context refers to the array store
+    _compaction.reset();
+}
 
 template <typename EntryT, typename RefT>
 void
@@ -52,13 +56,10 @@ MultiValueMapping<EntryT,RefT>::replace(uint32_t docId, ConstArrayRef values)
 }
 
 template <typename EntryT, typename RefT>
-void
-MultiValueMapping<EntryT,RefT>::compactWorst(bool compactMemory, bool compactAddressSpace)
+datastore::ICompactionContext::UP
+MultiValueMapping<EntryT,RefT>::startCompactWorst(bool compactMemory, bool compactAddressSpace)
 {
-    datastore::ICompactionContext::UP compactionContext(_store.compactWorst(compactMemory, compactAddressSpace));
-    if (compactionContext) {
-        compactionContext->compact(vespalib::ArrayRef<EntryRef>(&_indices[0], _indices.size()));
-    }
+    return _store.compactWorst(compactMemory, compactAddressSpace);
 }
 
 template <typename EntryT, typename RefT>
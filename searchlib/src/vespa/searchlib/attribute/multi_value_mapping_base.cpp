@@ -10,6 +10,8 @@ namespace {
 // minimum dead bytes in multi value mapping before consider compaction
 constexpr size_t DEAD_BYTES_SLACK = 0x10000u;
 constexpr size_t DEAD_ARRAYS_SLACK = 0x10000u;
+// number of docs visited per compaction slice
+constexpr size_t COMPACTION_SLICE_SIZE = 0x40000u;
 
 }
 
@@ -18,7 +20,8 @@ MultiValueMappingBase::MultiValueMappingBase(const vespalib::GrowStrategy &gs,
     : _indices(gs, genHolder),
       _totalValues(0u),
       _cachedArrayStoreMemoryUsage(),
-      _cachedArrayStoreAddressSpaceUsage(0, 0, (1ull << 32))
+      _cachedArrayStoreAddressSpaceUsage(0, 0, (1ull << 32)),
+      _compaction(COMPACTION_SLICE_SIZE)
 {
 }
 
@@ -81,9 +84,22 @@ MultiValueMappingBase::updateStat()
     return retval;
 }
 
+void
+MultiValueMappingBase::compactWorst(bool compactMemory, bool compactAddressSpace)
+{
+    if (!_compaction.active()) {
+        _compaction.start(startCompactWorst(compactMemory, compactAddressSpace));
+    }
+    _compaction.compactAll(vespalib::ArrayRef<EntryRef>(&_indices[0], _indices.size()));
+}
+
 bool
 MultiValueMappingBase::considerCompact(const CompactionStrategy &compactionStrategy)
 {
+    if (_compaction.active()) {
+        _compaction.compactSlice(vespalib::ArrayRef<EntryRef>(&_indices[0], _indices.size()));
+        return true;
+    }
     size_t usedBytes = _cachedArrayStoreMemoryUsage.usedBytes();
     size_t deadBytes = _cachedArrayStoreMemoryUsage.deadBytes();
     size_t usedArrays = _cachedArrayStoreAddressSpaceUsage.used();
@@ -93,7 +109,8 @@ MultiValueMappingBase::considerCompact(const CompactionStrategy &compactionStrat
     bool compactAddressSpace = ((deadArrays >= DEAD_ARRAYS_SLACK) &&
                                 (usedArrays * compactionStrategy.getMaxDeadAddressSpaceRatio() < deadArrays));
     if (compactMemory || compactAddressSpace) {
-        compactWorst(compactMemory, compactAddressSpace);
+        _compaction.start(startCompactWorst(compactMemory, compactAddressSpace));
+        _compaction.compactSlice(vespalib::ArrayRef<EntryRef>(&_indices[0], _indices.size()));
         return true;
     }
     return false;
@@ -3,6 +3,7 @@
 #pragma once
 
 #include <vespa/vespalib/datastore/entryref.h>
+#include <vespa/vespalib/datastore/incremental_compaction.h>
 #include <vespa/vespalib/util/address_space.h>
 #include <vespa/vespalib/util/rcuvector.h>
 #include <functional>
@@ -19,12 +20,14 @@ class MultiValueMappingBase
 public:
     using EntryRef = datastore::EntryRef;
     using RefVector = vespalib::RcuVectorBase<EntryRef>;
+    using CompactionStats = datastore::IncrementalCompaction::Stats;
 
 protected:
     RefVector _indices;
     size_t    _totalValues;
     vespalib::MemoryUsage _cachedArrayStoreMemoryUsage;
     vespalib::AddressSpace _cachedArrayStoreAddressSpaceUsage;
+    datastore::IncrementalCompaction _compaction;
 
     MultiValueMappingBase(const vespalib::GrowStrategy &gs, vespalib::GenerationHolder &genHolder);
     virtual ~MultiValueMappingBase();
@@ -51,8 +54,21 @@ public:
 
     uint32_t getNumKeys() const { return _indices.size(); }
     uint32_t getCapacityKeys() const { return _indices.capacity(); }
-    virtual void compactWorst(bool compatMemory, bool compactAddressSpace) = 0;
+    virtual datastore::ICompactionContext::UP startCompactWorst(bool compactMemory, bool compactAddressSpace) = 0;
+    void compactWorst(bool compactMemory, bool compactAddressSpace);
+
+    /**
+     * Consider compacting the worst buffers of the underlying array store.
+     *
+     * Entries are moved in slices of bounded size, one slice per call,
+     * and a compaction in progress is continued until all refs have been
+     * visited. Returns true if anything was compacted, in which case the
+     * caller must bump the generation.
+     */
     bool considerCompact(const CompactionStrategy &compactionStrategy);
+    bool compactionInProgress() const { return _compaction.active(); }
+    const CompactionStats &getCompactionStats() const { return _compaction.getStats(); }
+    void setCompactionSliceSize(size_t sliceSize) { _compaction.setSliceSize(sliceSize); }
 };
 
 }
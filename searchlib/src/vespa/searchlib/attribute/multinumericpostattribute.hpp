@@ -18,6 +18,7 @@ void
 MultiValueNumericPostingAttribute<B, M>::mergeMemoryStats(vespalib::MemoryUsage & total)
 {
     total.merge(this->getPostingList().getMemoryUsage());
+    this->mergeSearchCacheMemoryUsage(total);
 }
 
 template <typename B, typename M>
@@ -65,6 +66,7 @@ void
 MultiValueNumericPostingAttribute<B, M>::onGenerationChange(generation_t generation)
 {
     _postingList.freeze();
+    this->endPostingChange();
     MultiValueNumericEnumAttribute<B, M>::onGenerationChange(generation);
     _postingList.transferHoldLists(generation - 1);
 }
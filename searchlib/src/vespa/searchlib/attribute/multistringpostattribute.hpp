@@ -64,6 +64,7 @@ void
 MultiValueStringPostingAttributeT<B, T>::mergeMemoryStats(vespalib::MemoryUsage &total)
 {
     total.merge(this->_postingList.getMemoryUsage());
+    this->mergeSearchCacheMemoryUsage(total);
 }
 
 template <typename B, typename T>
@@ -79,6 +80,7 @@ void
 MultiValueStringPostingAttributeT<B, T>::onGenerationChange(generation_t generation)
 {
     _postingList.freeze();
+    this->endPostingChange();
     MultiValueStringAttributeT<B, T>::onGenerationChange(generation);
     _postingList.transferHoldLists(generation - 1);
 }
@@ -0,0 +1,150 @@
+// Copyright 2019 Oath Inc. Licensed under the terms of the Apache 2.0 license. See LICENSE in the project root.
+
+#pragma once
+
+#include <vespa/searchcommon/common/undefinedvalues.h>
+#include <vespa/vespalib/util/rcuvector.h>
+#include <vespa/vespalib/util/memoryusage.h>
+#include <limits>
+
+namespace search::attribute {
+
+/**
+ * Lightweight secondary index for single value numeric attributes
+ * without fast-search. The lid space is split into fixed size blocks,
+ * and the min and max value stored in each block is tracked.
+ *
+ * A block range is only ever widened (when a value is written), never
+ * narrowed, so it is always a superset of the values in the block.
+ * This keeps the writer side to two compares per write and makes it
+ * safe for readers to skip a block whose range does not overlap the
+ * term. Undefined values are not part of the range, since a block of
+ * mostly unset lids would otherwise always extend down to the lowest
+ * value. A block holding an undefined value is instead flagged, and
+ * only matches on that account if the term matches the undefined
+ * value (never for NaN).
+ */
+template <typename T>
+class NumericZoneMap {
+public:
+    static constexpr uint32_t BLOCK_BITS = 10;
+    static constexpr uint32_t BLOCK_SIZE = 1u << BLOCK_BITS;
+
+    struct Zone {
+        T _min;
+        T _max;
+        bool _hasUndefined;
+        Zone() : _min(std::numeric_limits<T>::max()), _max(std::numeric_limits<T>::lowest()), _hasUndefined(false) { }
+        void add(T v) {
+            if (isUndefined<T>(v)) {
+                _hasUndefined = true;
+                return;
+            }
+            if (v < _min) {
+                _min = v;
+            }
+            if (v > _max) {
+                _max = v;
+            }
+        }
+        template <typename Func>
+        bool overlaps(Func overlapsRange) const {
+            return overlapsRange(_min, _max) ||
+                (_hasUndefined && overlapsRange(getUndefined<T>(), getUndefined<T>()));
+        }
+    };
+
+    /**
+     * Read only view used by search contexts. Blocks added after the
+     * view was created are not covered, and all lids in them are
+     * reported as candidates.
+     */
+    class Reader {
+        const Zone * _zones;
+        uint32_t     _numZones;
+    public:
+        Reader(const Zone * zones, uint32_t numZones) : _zones(zones), _numZones(numZones) { }
+
+        /**
+         * Returns the first lid >= the given lid that is in a block
+         * where overlaps(min, max) is true, or in a block not covered.
+         **/
+        template <typename Func>
+        uint32_t nextCandidate(uint32_t lid, Func overlaps) const {
+            uint32_t zone = lid >> BLOCK_BITS;
+            if ((zone >= _numZones) || _zones[zone].overlaps(overlaps)) {
+                return lid;
+            }
+            for (++zone; zone < _numZones; ++zone) {
+                if (_zones[zone].overlaps(overlaps)) {
+                    break;
+                }
+            }
+            return zone << BLOCK_BITS;
+        }
+
+        /**
+         * Returns the end of the block holding the given lid, or the
+         * max lid if the block is not covered.
+         **/
+        uint32_t blockEnd(uint32_t lid) const {
+            uint32_t zone = lid >> BLOCK_BITS;
+            return (zone < _numZones) ? ((zone + 1) << BLOCK_BITS) : std::numeric_limits<uint32_t>::max();
+        }
+    };
+
+private:
+    using ZoneVector = vespalib::RcuVectorBase<Zone>;
+    ZoneVector _zones;
+
+public:
+    explicit NumericZoneMap(vespalib::GenerationHolder & genHolder)
+        : _zones(genHolder)
+    { }
+
+    /**
+     * Registers the value of a newly added lid. Returns true if the
+     * underlying vector was reallocated, and a new generation is needed.
+     **/
+    bool addDoc(uint32_t lid, T v) {
+        bool incGen = false;
+        uint32_t zone = lid >> BLOCK_BITS;
+        if (zone >= _zones.size()) {
+            incGen = _zones.isFull();
+            _zones.push_back(Zone());
+        }
+        _zones[zone].add(v);
+        return incGen;
+    }
+
+    /**
+     * Widens the block holding the given lid. Must be called before the
+     * new value is made visible to readers.
+     **/
+    void update(uint32_t lid, T v) {
+        _zones[lid >> BLOCK_BITS].add(v);
+    }
+
+    /**
+     * Rebuilds all blocks from the given values. Assumes no readers.
+     **/
+    void rebuild(const T * values, uint32_t numValues) {
+        _zones.reset();
+        _zones.unsafe_reserve((numValues + BLOCK_SIZE - 1) >> BLOCK_BITS);
+        for (uint32_t lid = 0; lid < numValues; ++lid) {
+            addDoc(lid, values[lid]);
+        }
+    }
+
+    void shrink(uint32_t lidLimit) {
+        _zones.shrink((lidLimit + BLOCK_SIZE - 1) >> BLOCK_BITS);
+    }
+
+    Reader makeReader() const {
+        return _zones.empty() ? Reader(nullptr, 0) : Reader(&_zones[0], _zones.size());
+    }
+
+    vespalib::MemoryUsage getMemoryUsage() const { return _zones.getMemoryUsage(); }
+};
+
+}
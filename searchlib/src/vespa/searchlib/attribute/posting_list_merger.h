@@ -33,6 +33,8 @@ public:
 
     void reserveArray(uint32_t postingsCount, size_t postingsSize);
     void allocBitVector();
+    // Use an already merged bitvector, e.g. from a search cache
+    void setBitVector(std::shared_ptr<BitVector> bitVector) { _bitVector = std::move(bitVector); }
     void merge();
     bool hasArray() const { return _arrayValid; }
     bool hasBitVector() const { return static_cast<bool>(_bitVector); }
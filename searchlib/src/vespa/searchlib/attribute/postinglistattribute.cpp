@@ -18,18 +18,47 @@ PostingListAttributeBase(AttributeVector &attr,
                    attr.getConfig()),
       _attr(attr),
       _dict(enumStore.get_dictionary().get_posting_dictionary()),
-      _esb(enumStore)
-{ }
+      _esb(enumStore),
+      _searchCache(),
+      _postingChangeCount(0)
+{
+    const attribute::Config &cfg = attr.getConfig();
+    if (cfg.getIsFilter() && cfg.getSearchCacheMaxBytes() > 0) {
+        _searchCache = std::make_unique<attribute::BitVectorSearchCache>(cfg.getSearchCacheMaxBytes());
+    }
+}
 
 template <typename P>
 PostingListAttributeBase<P>::~PostingListAttributeBase() = default;
 
+template <typename P>
+void
+PostingListAttributeBase<P>::beginPostingChange()
+{
+    uint64_t changeCount = _postingChangeCount.load(std::memory_order_relaxed);
+    if ((changeCount & 1) == 0) {
+        _postingChangeCount.store(changeCount + 1, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_release);
+    }
+}
+
+template <typename P>
+void
+PostingListAttributeBase<P>::endPostingChange()
+{
+    uint64_t changeCount = _postingChangeCount.load(std::memory_order_relaxed);
+    if ((changeCount & 1) != 0) {
+        _postingChangeCount.store(changeCount + 1, std::memory_order_release);
+    }
+}
+
 template <typename P>
 void
 PostingListAttributeBase<P>::clearAllPostings()
 {
     _postingList.clearBuilder();
     _attr.incGeneration(); // Force freeze
+    beginPostingChange();
     auto itr = _dict.begin();
     EntryRef prev;
     while (itr.valid()) {
@@ -52,6 +81,7 @@ void
 PostingListAttributeBase<P>::handle_load_posting_lists_and_update_enum_store(enumstore::EnumeratedPostingsLoader& loader)
 {
     clearAllPostings();
+    beginPostingChange();
     uint32_t docIdLimit = _attr.getNumDocs();
     EntryRef newIndex;
     PostingChange<P> postings;
@@ -117,6 +147,9 @@ void
 PostingListAttributeBase<P>::updatePostings(PostingMap &changePost,
                                             datastore::EntryComparator &cmp)
 {
+    if (!changePost.empty()) {
+        beginPostingChange();
+    }
     for (auto& elem : changePost) {
         auto& change = elem.second;
         EnumIndex idx = elem.first.getEnumIdx();
@@ -168,6 +201,7 @@ clearPostings(attribute::IAttributeVector::EnumHandle eidx,
         postings.remove(lid);
     }
 
+    beginPostingChange();
     EntryRef er(eidx);
     auto itr = _dict.lowerBound(er, cmp);
     assert(itr.valid());
@@ -200,6 +234,22 @@ PostingListAttributeBase<P>::getMemoryUsage() const
     return _postingList.getMemoryUsage();
 }
 
+template <typename P>
+void
+PostingListAttributeBase<P>::mergeSearchCacheMemoryUsage(vespalib::MemoryUsage &total) const
+{
+    if (_searchCache) {
+        total.merge(_searchCache->getMemoryUsage());
+    }
+}
+
+template <typename P>
+CacheStats
+PostingListAttributeBase<P>::getSearchCacheStats() const
+{
+    return _searchCache ? _searchCache->getStats() : CacheStats();
+}
+
 template <typename P, typename LoadedVector, typename LoadedValueType,
           typename EnumStoreType>
 PostingListAttributeSubBase<P, LoadedVector, LoadedValueType, EnumStoreType>::
@@ -223,6 +273,7 @@ handle_load_posting_lists(LoadedVector& loaded)
 {
     if constexpr (!std::is_same_v<LoadedVector, NoLoadedVector>) {
         clearAllPostings();
+        this->beginPostingChange();
         EntryRef newIndex;
         PostingChange<P> postings;
         uint32_t docIdLimit = _attr.getNumDocs();
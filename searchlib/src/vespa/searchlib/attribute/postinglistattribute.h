@@ -2,6 +2,7 @@
 
 #pragma once
 
+#include "bitvector_search_cache.h"
 #include "dociditerator.h"
 #include "ipostinglistattributebase.h"
 #include "postingchange.h"
@@ -13,6 +14,7 @@
 #include <vespa/vespalib/btree/btreestore.h>
 #include <vespa/vespalib/datastore/entry_comparator.h>
 #include <vespa/vespalib/datastore/entryref.h>
+#include <atomic>
 #include <map>
 
 namespace search {
@@ -51,10 +53,20 @@ protected:
     AttributeVector &_attr;
     EnumPostingTree &_dict;
     IEnumStore      &_esb;
+    std::unique_ptr<attribute::BitVectorSearchCache> _searchCache;
+    // Odd while posting list changes are not yet visible to readers
+    std::atomic<uint64_t> _postingChangeCount;
 
     PostingListAttributeBase(AttributeVector &attr, IEnumStore &enumStore);
     virtual ~PostingListAttributeBase();
 
+    void beginPostingChange();
+    /*
+     * Called by the attribute when changes to the dictionary and posting
+     * lists have been made visible to readers (after freeze).
+     */
+    void endPostingChange();
+
     virtual void updatePostings(PostingMap & changePost) = 0;
 
     void updatePostings(PostingMap &changePost, datastore::EntryComparator &cmp);
@@ -69,10 +81,21 @@ protected:
 
     void forwardedShrinkLidSpace(uint32_t newSize) override;
     virtual vespalib::MemoryUsage getMemoryUsage() const override;
+    void mergeSearchCacheMemoryUsage(vespalib::MemoryUsage &total) const;
 
 public:
     const PostingList & getPostingList() const { return _postingList; }
     PostingList & getPostingList()             { return _postingList; }
+    // Returns nullptr unless merged posting lists are cached for this attribute
+    attribute::BitVectorSearchCache *getSearchCache() const { return _searchCache.get(); }
+    /*
+     * Returns the number of posting list changes started and published. A
+     * reader sampling an even count before and the same count after taking
+     * a frozen view of the dictionary has seen posting lists that are not
+     * changed by any other count.
+     */
+    uint64_t getPostingChangeCount() const { return _postingChangeCount.load(std::memory_order_acquire); }
+    CacheStats getSearchCacheStats() const override;
 };
 
 template <typename P, typename LoadedVector, typename LoadedValueType,
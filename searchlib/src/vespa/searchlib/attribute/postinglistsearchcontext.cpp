@@ -2,6 +2,7 @@
 
 #include "postinglistsearchcontext.h"
 #include "postinglistsearchcontext.hpp"
+#include "bitvector_search_cache.h"
 #include "attributeiterators.hpp"
 #include "diversity.hpp"
 #include <vespa/vespalib/btree/btreeiterator.hpp>
@@ -18,7 +19,9 @@ PostingListSearchContext(const Dictionary &dictionary,
                          const IEnumStore &esb,
                          uint32_t minBvDocFreq,
                          bool useBitVector,
-                         const ISearchContext &baseSearchCtx)
+                         const ISearchContext &baseSearchCtx,
+                         BitVectorSearchCache *searchCache,
+                         uint64_t changeCount)
     : _frozenDictionary(dictionary.getFrozenView()),
       _lowerDictItr(BTreeNode::Ref(), dictionary.getAllocator()),
       _upperDictItr(BTreeNode::Ref(), dictionary.getAllocator()),
@@ -35,7 +38,10 @@ PostingListSearchContext(const Dictionary &dictionary,
       _esb(esb),
       _minBvDocFreq(minBvDocFreq),
       _gbv(nullptr),
-      _baseSearchCtx(baseSearchCtx)
+      _baseSearchCtx(baseSearchCtx),
+      _searchCache(searchCache),
+      _changeCount(changeCount),
+      _searchCacheKey()
 {
 }
 
@@ -43,6 +49,46 @@ PostingListSearchContext(const Dictionary &dictionary,
 PostingListSearchContext::~PostingListSearchContext() = default;
 
 
+void
+PostingListSearchContext::checkSearchCacheChangeCount(uint64_t changeCount)
+{
+    if (((_changeCount & 1) != 0) || (changeCount != _changeCount)) {
+        _searchCache = nullptr;
+    }
+}
+
+
+void
+PostingListSearchContext::setSearchCacheKey(vespalib::string key)
+{
+    if (_searchCache != nullptr) {
+        _searchCacheKey = std::move(key);
+    }
+}
+
+
+std::shared_ptr<BitVector>
+PostingListSearchContext::lookupSearchCache()
+{
+    if (_searchCacheKey.empty()) {
+        return std::shared_ptr<BitVector>();
+    }
+    auto entry = _searchCache->find(_searchCacheKey, _changeCount, _docIdLimit);
+    return entry ? entry->bitVector : std::shared_ptr<BitVector>();
+}
+
+
+void
+PostingListSearchContext::insertSearchCache(std::shared_ptr<BitVector> bitVector)
+{
+    if (!_searchCacheKey.empty()) {
+        auto entry = std::make_shared<BitVectorSearchCache::Entry>(IDocumentMetaStoreContext::IReadGuard::UP(),
+                                                                   std::move(bitVector), _docIdLimit, _changeCount);
+        _searchCache->insert(_searchCacheKey, std::move(entry));
+    }
+}
+
+
 void
 PostingListSearchContext::lookupTerm(const datastore::EntryComparator &comp)
 {
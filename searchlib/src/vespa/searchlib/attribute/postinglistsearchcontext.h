@@ -14,6 +14,7 @@
 
 namespace search::attribute {
 
+class BitVectorSearchCache;
 class ISearchContext;
 
 /**
@@ -46,13 +47,31 @@ protected:
     uint32_t                _minBvDocFreq;
     const GrowableBitVector *_gbv; // bitvector if _useBitVector has been set
     const ISearchContext    &_baseSearchCtx;
+    BitVectorSearchCache    *_searchCache; // cache for merged posting lists, only used for filter attributes
+    uint64_t                 _changeCount; // posting list change count seen before the dictionary was frozen
+    vespalib::string         _searchCacheKey;
 
 
     PostingListSearchContext(const Dictionary &dictionary, uint32_t docIdLimit, uint64_t numValues, bool hasWeight,
-                             const IEnumStore &esb, uint32_t minBvDocFreq, bool useBitVector, const ISearchContext &baseSearchCtx);
+                             const IEnumStore &esb, uint32_t minBvDocFreq, bool useBitVector, const ISearchContext &baseSearchCtx,
+                             BitVectorSearchCache *searchCache, uint64_t changeCount);
 
     ~PostingListSearchContext();
 
+    /*
+     * Disables the search cache unless the posting list change count seen
+     * after the dictionary was frozen is the even count seen before, i.e.
+     * no posting list changes were pending or published in between.
+     */
+    void checkSearchCacheChangeCount(uint64_t changeCount);
+    /*
+     * The key must identify the set of posting lists to be merged, given
+     * the frozen dictionary of this search context.
+     */
+    void setSearchCacheKey(vespalib::string key);
+    std::shared_ptr<BitVector> lookupSearchCache();
+    void insertSearchCache(std::shared_ptr<BitVector> bitVector);
+
     void lookupTerm(const datastore::EntryComparator &comp);
     void lookupRange(const datastore::EntryComparator &low, const datastore::EntryComparator &high);
     void lookupSingle();
@@ -115,7 +134,8 @@ protected:
 
     PostingListSearchContextT(const Dictionary &dictionary, uint32_t docIdLimit, uint64_t numValues,
                               bool hasWeight, const PostingList &postingList, const IEnumStore &esb,
-                              uint32_t minBvCocFreq, bool useBitVector, const ISearchContext &baseSearchCtx);
+                              uint32_t minBvCocFreq, bool useBitVector, const ISearchContext &baseSearchCtx,
+                              BitVectorSearchCache *searchCache, uint64_t changeCount);
     ~PostingListSearchContextT();
 
     void lookupSingle();
@@ -153,7 +173,8 @@ protected:
 
     PostingListFoldedSearchContextT(const Dictionary &dictionary, uint32_t docIdLimit, uint64_t numValues,
                                     bool hasWeight, const PostingList &postingList, const IEnumStore &esb,
-                                    uint32_t minBvCocFreq, bool useBitVector, const ISearchContext &baseSearchCtx);
+                                    uint32_t minBvCocFreq, bool useBitVector, const ISearchContext &baseSearchCtx,
+                                    BitVectorSearchCache *searchCache, uint64_t changeCount);
 
     unsigned int approximateHits() const override;
 };
@@ -259,10 +280,13 @@ PostingSearchContext(QueryTermSimpleUP qTerm, bool useBitVector, const AttrT &to
               toBeSearched.getEnumStore(),
               toBeSearched._postingList._minBvDocFreq,
               useBitVector,
-              *this),
+              *this,
+              toBeSearched.getSearchCache(),
+              toBeSearched.getPostingChangeCount()),
       _toBeSearched(toBeSearched),
       _enumStore(_toBeSearched.getEnumStore())
 {
+    this->checkSearchCacheChangeCount(toBeSearched.getPostingChangeCount());
     this->_plsc = static_cast<attribute::IPostingListSearchContext *>(this);
 }
 
@@ -297,6 +321,10 @@ StringPostingSearchContext(QueryTermSimpleUP qTerm, bool useBitVector, const Att
         }
         if (this->_uniqueValues == 1u) {
             this->lookupSingle();
+        } else if (this->_uniqueValues > 1u) {
+            vespalib::string key(this->isPrefix() ? "p" : (this->isRegex() ? "r" : "w"));
+            key.append(this->queryTerm()->getTerm());
+            this->setSearchCacheKey(std::move(key));
         }
     }
 }
@@ -324,6 +352,11 @@ NumericPostingSearchContext(QueryTermSimpleUP qTerm, const Params & params_in, c
         }
         if (this->_uniqueValues == 1u) {
             this->lookupSingle();
+        } else if (this->_uniqueValues > 1u) {
+            // The dictionary range is given by the values found at its ends
+            vespalib::string key(reinterpret_cast<const char *>(&_low), sizeof(_low));
+            key.append(reinterpret_cast<const char *>(&_high), sizeof(_high));
+            this->setSearchCacheKey(std::move(key));
         }
     }
 }
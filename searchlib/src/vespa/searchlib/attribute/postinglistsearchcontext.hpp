@@ -21,8 +21,10 @@ template <typename DataT>
 PostingListSearchContextT<DataT>::
 PostingListSearchContextT(const Dictionary &dictionary, uint32_t docIdLimit, uint64_t numValues, bool hasWeight,
                           const PostingList &postingList, const IEnumStore &esb,
-                          uint32_t minBvDocFreq, bool useBitVector, const ISearchContext &searchContext)
-    : PostingListSearchContext(dictionary, docIdLimit, numValues, hasWeight, esb, minBvDocFreq, useBitVector, searchContext),
+                          uint32_t minBvDocFreq, bool useBitVector, const ISearchContext &searchContext,
+                          BitVectorSearchCache *searchCache, uint64_t changeCount)
+    : PostingListSearchContext(dictionary, docIdLimit, numValues, hasWeight, esb, minBvDocFreq, useBitVector, searchContext,
+                               searchCache, changeCount),
       _postingList(postingList),
       _merger(docIdLimit),
       _fetchPostingsDone(false)
@@ -121,6 +123,11 @@ PostingListSearchContextT<DataT>::fetchPostings(bool strict)
 
     if (_uniqueValues < 2u) return;
 
+    auto cached = lookupSearchCache();
+    if (cached) {
+        _merger.setBitVector(std::move(cached));
+        return;
+    }
     if (strict && !fallbackToFiltering()) {
         size_t sum(countHits());
         if (sum < _docIdLimit / 64) {
@@ -131,6 +138,9 @@ PostingListSearchContextT<DataT>::fetchPostings(bool strict)
             fillBitVector();
         }
         _merger.merge();
+        if (_merger.hasBitVector()) {
+            insertSearchCache(_merger.getBitVectorSP());
+        }
     }
 }
 
@@ -289,8 +299,10 @@ template <typename DataT>
 PostingListFoldedSearchContextT<DataT>::
 PostingListFoldedSearchContextT(const Dictionary &dictionary, uint32_t docIdLimit, uint64_t numValues,
                                 bool hasWeight, const PostingList &postingList, const IEnumStore &esb,
-                                uint32_t minBvDocFreq, bool useBitVector, const ISearchContext &searchContext)
-    : Parent(dictionary, docIdLimit, numValues, hasWeight, postingList, esb, minBvDocFreq, useBitVector, searchContext)
+                                uint32_t minBvDocFreq, bool useBitVector, const ISearchContext &searchContext,
+                                BitVectorSearchCache *searchCache, uint64_t changeCount)
+    : Parent(dictionary, docIdLimit, numValues, hasWeight, postingList, esb, minBvDocFreq, useBitVector, searchContext,
+             searchCache, changeCount)
 {
 }
 
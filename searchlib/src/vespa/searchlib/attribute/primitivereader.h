@@ -18,6 +18,7 @@ namespace search {
 
         virtual ~PrimitiveReader() { }
         T getNextData() { return _datReader.readHostOrder(); }
+        void getNextData(T * values, size_t count) { _datReader.readHostOrder(values, count); }
         size_t getDataCount() const { return getDataCountHelper(sizeof(T)); }
         FileReader<T> & getReader() { return _datReader; }
     private:
@@ -4,6 +4,7 @@
 
 #include "integerbase.h"
 #include "floatbase.h"
+#include "numeric_zone_map.h"
 #include <vespa/vespalib/util/rcuvector.h>
 #include <limits>
 
@@ -14,6 +15,7 @@ class SingleValueNumericAttribute final : public B {
 private:
     using T = typename B::BaseType;
     using DataVector = vespalib::RcuVectorBase<T>;
+    using ZoneMap = attribute::NumericZoneMap<T>;
     using DocId = typename B::DocId;
     using EnumHandle = typename B::EnumHandle;
     using Weighted = typename B::Weighted;
@@ -26,6 +28,7 @@ private:
     using B::getGenerationHolder;
 
     DataVector _data;
+    ZoneMap    _zoneMap;
 
     T getFromEnum(EnumHandle e) const override {
         (void) e;
@@ -40,6 +43,7 @@ private:
     {
     private:
         const T * _data;
+        typename ZoneMap::Reader _zoneMap;
 
         int32_t onFind(DocId docId, int32_t elemId, int32_t & weight) const override {
             return find(docId, elemId, weight);
@@ -66,6 +70,14 @@ private:
             return this->match(v) ? 0 : -1;
         }
 
+        uint32_t nextCandidate(DocId docId) const {
+            return _zoneMap.nextCandidate(docId, [this](T min, T max) { return this->overlaps(min, max); });
+        }
+
+        uint32_t blockEnd(DocId docId) const {
+            return _zoneMap.blockEnd(docId);
+        }
+
         Int64Range getAsIntegerTerm() const override;
 
         std::unique_ptr<queryeval::SearchIterator>
@@ -109,6 +121,8 @@ public:
     getSearch(std::unique_ptr<QueryTermSimple> term, const attribute::SearchContextParams & params) const override;
 
     void set(DocId doc, T v) {
+        _zoneMap.update(doc, v);
+        std::atomic_thread_fence(std::memory_order_release);
         _data[doc] = v;
     }
 
@@ -19,7 +19,8 @@ SingleValueNumericAttribute(const vespalib::string & baseFileName, const Attribu
     _data(c.getGrowStrategy().getDocsInitialCapacity(),
           c.getGrowStrategy().getDocsGrowPercent(),
           c.getGrowStrategy().getDocsGrowDelta(),
-          getGenerationHolder())
+          getGenerationHolder()),
+    _zoneMap(getGenerationHolder())
 { }
 
 template <typename B>
@@ -39,12 +40,16 @@ SingleValueNumericAttribute<B>::onCommit()
         typename B::ValueModifier valueGuard(this->getValueModifier());
         for (const auto & change : this->_changes) {
             if (change._type == ChangeBase::UPDATE) {
+                _zoneMap.update(change._doc, change._data);
                 std::atomic_thread_fence(std::memory_order_release);
                 _data[change._doc] = change._data;
             } else if (change._type >= ChangeBase::ADD && change._type <= ChangeBase::DIV) {
+                T v = this->applyArithmetic(_data[change._doc], change);
+                _zoneMap.update(change._doc, v);
                 std::atomic_thread_fence(std::memory_order_release);
-                _data[change._doc] = this->applyArithmetic(_data[change._doc], change);
+                _data[change._doc] = v;
             } else if (change._type == ChangeBase::CLEARDOC) {
+                _zoneMap.update(change._doc, this->_defaultValue._data);
                 std::atomic_thread_fence(std::memory_order_release);
                 _data[change._doc] = this->_defaultValue._data;
             }
@@ -62,6 +67,7 @@ void
 SingleValueNumericAttribute<B>::onUpdateStat()
 {
     vespalib::MemoryUsage usage = _data.getMemoryUsage();
+    usage.merge(_zoneMap.getMemoryUsage());
     usage.mergeGenerationHeldBytes(getGenerationHolder().getHeldBytes());
     usage.merge(this->getChangeVectorMemoryUsage());
     this->updateStatistics(_data.size(), _data.size(),
@@ -79,6 +85,7 @@ bool
 SingleValueNumericAttribute<B>::addDoc(DocId & doc) {
     bool incGen = _data.isFull();
     _data.push_back(attribute::getUndefined<T>());
+    incGen |= _zoneMap.addDoc(_data.size() - 1, attribute::getUndefined<T>());
     std::atomic_thread_fence(std::memory_order_release);
     B::incNumDocs();
     doc = B::getNumDocs() - 1;
@@ -120,6 +127,7 @@ SingleValueNumericAttribute<B>::onLoadEnumerated(ReaderBase &attrReader)
                                    udatBuffer->size() / sizeof(T));
     attribute::loadFromEnumeratedSingleValue(_data, getGenerationHolder(), attrReader,
                                              map, attribute::NoSaveLoadedEnum());
+    _zoneMap.rebuild(_data.data(), _data.size());
     return true;
 }
 
@@ -142,10 +150,11 @@ SingleValueNumericAttribute<B>::onLoad()
     const size_t sz(attrReader.getDataCount());
     getGenerationHolder().clearHoldLists();
     _data.reset();
-    _data.unsafe_reserve(sz);
-    for (uint32_t i = 0; i < sz; ++i) {
-        _data.push_back(attrReader.getNextData());
+    _data.unsafe_resize(sz);
+    if (sz > 0) {
+        attrReader.getNextData(&_data[0], sz);
     }
+    _zoneMap.rebuild(_data.data(), _data.size());
 
     B::setNumDocs(sz);
     B::setCommittedDocIdLimit(sz);
@@ -193,6 +202,7 @@ SingleValueNumericAttribute<B>::onShrinkLidSpace()
     uint32_t committedDocIdLimit = this->getCommittedDocIdLimit();
     assert(_data.size() >= committedDocIdLimit);
     _data.shrink(committedDocIdLimit);
+    _zoneMap.shrink(committedDocIdLimit);
     this->setNumDocs(committedDocIdLimit);
 }
 
@@ -216,7 +226,8 @@ SingleValueNumericAttribute<B>::SingleSearchContext<M>::SingleSearchContext(Quer
                                                                             const NumericAttribute & toBeSearched) :
     M(*qTerm, true),
     AttributeVector::SearchContext(toBeSearched),
-    _data(&static_cast<const SingleValueNumericAttribute<B> &>(toBeSearched)._data[0])
+    _data(&static_cast<const SingleValueNumericAttribute<B> &>(toBeSearched)._data[0]),
+    _zoneMap(static_cast<const SingleValueNumericAttribute<B> &>(toBeSearched)._zoneMap.makeReader())
 { }
 
 
@@ -238,11 +249,11 @@ createFilterIterator(fef::TermFieldMatchData * matchData, bool strict)
     }
     if (getIsFilter()) {
         return strict
-                 ? std::make_unique<FilterAttributeIteratorStrict<SingleSearchContext<M>>>(*this, matchData)
+                 ? std::make_unique<ZoneMapFilterAttributeIteratorStrict<SingleSearchContext<M>>>(*this, matchData)
                  : std::make_unique<FilterAttributeIteratorT<SingleSearchContext<M>>>(*this, matchData);
     }
     return strict
-             ? std::make_unique<AttributeIteratorStrict<SingleSearchContext<M>>>(*this, matchData)
+             ? std::make_unique<ZoneMapAttributeIteratorStrict<SingleSearchContext<M>>>(*this, matchData)
              : std::make_unique<AttributeIteratorT<SingleSearchContext<M>>>(*this, matchData);
 }
 }
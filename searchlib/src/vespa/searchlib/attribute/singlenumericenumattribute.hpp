@@ -129,10 +129,18 @@ SingleValueNumericEnumAttribute<B>::onLoad()
         this->onAddDoc(numDocs - 1);
     }
 
-    for (uint32_t docIdx = 0; docIdx < numDocs; ++docIdx) {
-        loaded[docIdx]._docId = docIdx;
-        loaded[docIdx]._idx = 0;
-        loaded[docIdx].setValue(attrReader.getNextData());
+    // Values are read in bounded chunks; a temporary copy of all values
+    // would double the peak memory usage during load.
+    const uint32_t load_chunk_size = 64 * 1024;
+    std::vector<T> values(std::min(numDocs, load_chunk_size));
+    for (uint32_t docIdx = 0; docIdx < numDocs; ) {
+        uint32_t count = std::min(numDocs - docIdx, load_chunk_size);
+        attrReader.getNextData(values.data(), count);
+        for (uint32_t i = 0; i < count; ++i, ++docIdx) {
+            loaded[docIdx]._docId = docIdx;
+            loaded[docIdx]._idx = 0;
+            loaded[docIdx].setValue(values[i]);
+        }
     }
 
     attribute::sortLoadedByValue(loaded);
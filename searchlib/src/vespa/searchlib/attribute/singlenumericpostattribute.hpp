@@ -37,6 +37,7 @@ void
 SingleValueNumericPostingAttribute<B>::mergeMemoryStats(vespalib::MemoryUsage & total)
 {
     total.merge(this->_postingList.getMemoryUsage());
+    this->mergeSearchCacheMemoryUsage(total);
 }
 
 template <typename B>
@@ -132,6 +133,7 @@ void
 SingleValueNumericPostingAttribute<B>::onGenerationChange(generation_t generation)
 {
     _postingList.freeze();
+    this->endPostingChange();
     SingleValueNumericEnumAttribute<B>::onGenerationChange(generation);
     _postingList.transferHoldLists(generation - 1);
 }
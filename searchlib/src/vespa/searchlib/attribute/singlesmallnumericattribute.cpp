@@ -128,10 +128,10 @@ SingleValueSmallNumericAttribute::onLoad()
         const size_t sz(attrReader.getDataCount());
         getGenerationHolder().clearHoldLists();
         _wordData.reset();
-        _wordData.unsafe_reserve(sz - 1);
+        _wordData.unsafe_resize(sz - 1);
         Word numDocs = attrReader.getNextData();
-        for (uint32_t i = 1; i < sz; ++i) {
-            _wordData.push_back(attrReader.getNextData());
+        if (sz > 1) {
+            attrReader.getNextData(&_wordData[0], sz - 1);
         }
         assert(((numDocs + _valueShiftMask) >> _wordShift) + 1 == sz);
         B::setNumDocs(numDocs);
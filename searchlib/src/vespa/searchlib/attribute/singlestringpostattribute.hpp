@@ -35,6 +35,7 @@ void
 SingleValueStringPostingAttributeT<B>::mergeMemoryStats(vespalib::MemoryUsage & total)
 {
     total.merge(this->_postingList.getMemoryUsage());
+    this->mergeSearchCacheMemoryUsage(total);
 }
 
 template <typename B>
@@ -124,6 +125,7 @@ void
 SingleValueStringPostingAttributeT<B>::onGenerationChange(generation_t generation)
 {
     _postingList.freeze();
+    this->endPostingChange();
     SingleValueStringAttributeT<B>::onGenerationChange(generation);
     _postingList.transferHoldLists(generation - 1);
 }
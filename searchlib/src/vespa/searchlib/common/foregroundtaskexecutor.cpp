@@ -48,5 +48,16 @@ ForegroundTaskExecutor::sync()
 {
 }
 
+void
+ForegroundTaskExecutor::setTaskLimit(uint32_t)
+{
+}
+
+vespalib::ExecutorStats
+ForegroundTaskExecutor::getStats()
+{
+    return vespalib::ExecutorStats();
+}
+
 
 } // namespace search
@@ -29,6 +29,8 @@ public:
     ExecutorId getExecutorId(uint64_t componentId) override;
     void executeTask(ExecutorId id, vespalib::Executor::Task::UP task) override;
     void sync() override;
+    void setTaskLimit(uint32_t taskLimit) override;
+    vespalib::ExecutorStats getStats() override;
 };
 
 } // namespace search
@@ -2,6 +2,7 @@
 #pragma once
 
 #include <vespa/vespalib/util/executor.h>
+#include <vespa/vespalib/util/executor_stats.h>
 #include <vespa/vespalib/stllike/hash_fun.h>
 #include <vespa/vespalib/util/lambdatask.h>
 
@@ -68,6 +69,17 @@ public:
      */
     virtual void sync() = 0;
 
+    /**
+     * Set the max number of pending tasks per internal executor.
+     * Scheduling a task blocks while the limit is reached.
+     */
+    virtual void setTaskLimit(uint32_t taskLimit) = 0;
+
+    /**
+     * Get accumulated stats for all internal executors, and reset them.
+     */
+    virtual vespalib::ExecutorStats getStats() = 0;
+
     /**
      * Wrap lambda function into a task and schedule it to be run.
      * Caller must ensure that pointers and references are valid and
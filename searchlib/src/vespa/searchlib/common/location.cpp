@@ -11,6 +11,7 @@ Location::Location() :
       _y(0),
       _xAspect(0u),
       _radius(std::numeric_limits<uint32_t>::max()),
+      _targetHits(0u),
       _minx(std::numeric_limits<int32_t>::min()),
       _maxx(std::numeric_limits<int32_t>::max()),
       _miny(std::numeric_limits<int32_t>::min()),
@@ -62,6 +63,7 @@ bool Location::parse(const vespalib::string &locStr)
 {
     bool hadCutoff = false;
     bool hadLoc = false;
+    bool hadTargetHits = false;
     const char *p = locStr.c_str();
     while (*p != '\0') {
         if (*p == '[') {
@@ -151,6 +153,24 @@ bool Location::parse(const vespalib::string &locStr)
                 }
             }
             p++;
+        } else if (*p == '{') {
+            p++;
+            if (hadTargetHits) {
+                _parseError = "Duplicate nearest target hits";
+                return false;
+            }
+            hadTargetHits = true;
+            int targetHits = getInt(&p);
+            if (targetHits <= 0) {
+                _parseError = "Nearest target hits must be positive";
+                return false;
+            }
+            _targetHits = targetHits;
+            if (*p != '}') {
+                _parseError = "Missing '}' after nearest target hits";
+                return false;
+            }
+            p++;
         } else if (*p == ' ')
             p++;
         else {
@@ -159,6 +179,10 @@ bool Location::parse(const vespalib::string &locStr)
         }
     }
 
+    if (hadTargetHits && !hadLoc) {
+        _parseError = "Nearest target hits given without a location";
+        return false;
+    }
     if (hadLoc) {
         _rankOnDistance = true;
         uint32_t maxdx = _radius;
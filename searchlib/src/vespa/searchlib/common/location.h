@@ -23,6 +23,7 @@ public:
     int32_t getX()                 const { return _x; }
     int32_t getY()                 const { return _y; }
     uint32_t getRadius()           const { return _radius; }
+    uint32_t getTargetHits()       const { return _targetHits; }
     const char * getParseError()   const { return _parseError; }
     int32_t getMinX() const { return _minx; }
     int32_t getMinY() const { return _miny; }
@@ -40,6 +41,7 @@ private:
     int32_t  _y;        /* Query Y position */
     uint32_t _xAspect;      /* X distance multiplier fraction */
     uint32_t _radius;       /* Radius for euclidian distance */
+    uint32_t _targetHits;   /* Only match this many hits nearest the query position (0 = all) */
     int32_t  _minx;     /* Min X coordinate */
     int32_t  _maxx;     /* Max X coordinate */
     int32_t  _miny;     /* Min Y coordinate */
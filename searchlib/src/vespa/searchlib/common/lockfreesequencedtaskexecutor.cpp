@@ -0,0 +1,389 @@
+// Copyright 2019 Oath Inc. Licensed under the terms of the Apache 2.0 license. See LICENSE in the project root.
+
+#include "lockfreesequencedtaskexecutor.h"
+#include <vespa/vespalib/stllike/hash_map.hpp>
+#include <vespa/vespalib/util/count_down_latch.h>
+#include <atomic>
+#include <cassert>
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+
+using vespalib::Executor;
+
+namespace search {
+
+namespace {
+
+// Max number of tasks run before the pending count is updated and blocked producers are released.
+constexpr uint32_t maxBatchSize = 64;
+
+// Max number of rounds the worker yields while a producer is linking in a task, before blocking.
+constexpr uint32_t maxSpinsBeforeBlocking = 100;
+
+}
+
+/**
+ * A single worker thread and its task queue. The queue is an intrusive
+ * multi producer, single consumer linked list (as described by Dmitry
+ * Vyukov), where producers only need an atomic exchange of the head.
+ *
+ * _pending is incremented before a task is linked in, and decremented
+ * after a batch of tasks has been run. It is therefore never less than
+ * the number of tasks in the queue, and the worker knows that a task is
+ * on its way if the queue looks empty while _pending is not zero. It
+ * yields for a bounded number of rounds waiting for the task, and then
+ * blocks like an idle worker.
+ *
+ * A blocking worker sets _workerWaiting before its last look at the
+ * queue, and a producer checks it after linking in its task. With a
+ * full fence on both sides, either the worker sees the task or the
+ * producer sees that the worker must be woken up.
+ */
+class LockFreeSequencedTaskExecutor::Strand
+{
+    struct Node {
+        std::atomic<Node *> next;
+        Executor::Task::UP  task;
+        Node() : next(nullptr), task() { }
+        explicit Node(Executor::Task::UP task_in) : next(nullptr), task(std::move(task_in)) { }
+    };
+
+    // Written by producers
+    alignas(64) std::atomic<Node *> _head;
+    std::atomic<uint32_t>           _pending;
+    std::atomic<bool>               _producerBlocked;
+    std::atomic<bool>               _workerWaiting;
+    std::atomic<bool>               _closed;
+    std::atomic<uint32_t>           _taskLimit;
+    std::atomic<size_t>             _acceptedTasks;
+    std::atomic<size_t>             _rejectedTasks;
+    std::atomic<size_t>             _maxPendingTasks;
+
+    // Only touched by the worker thread
+    alignas(64) Node *_tail;
+    Node              _stub;
+
+    std::mutex              _lock;
+    std::condition_variable _workerCond;
+    std::condition_variable _producerCond;
+    bool                    _wakeup;
+    std::thread             _thread;
+
+    void push(Node *node) {
+        Node *prev = _head.exchange(node, std::memory_order_acq_rel);
+        prev->next.store(node, std::memory_order_release);
+    }
+    bool hasLinkedTask() const { return _tail->next.load(std::memory_order_acquire) != nullptr; }
+    Node *pop();
+    uint32_t drain();
+    bool waitForTasks();
+    void wakeWorkerIfWaiting();
+    template <typename LimitFunc>
+    void waitForPendingBelow(LimitFunc limit);
+    void wakeProducers();
+    void run();
+
+public:
+    explicit Strand(uint32_t taskLimit);
+    ~Strand();
+    Executor::Task::UP execute(Executor::Task::UP task, bool limited);
+    void waitIdle();
+    void shutdown();
+    void setTaskLimit(uint32_t taskLimit);
+    Stats getStats();
+};
+
+LockFreeSequencedTaskExecutor::Strand::Strand(uint32_t taskLimit)
+    : _head(&_stub),
+      _pending(0),
+      _producerBlocked(false),
+      _workerWaiting(false),
+      _closed(false),
+      _taskLimit(taskLimit),
+      _acceptedTasks(0),
+      _rejectedTasks(0),
+      _maxPendingTasks(0),
+      _tail(&_stub),
+      _stub(),
+      _lock(),
+      _workerCond(),
+      _producerCond(),
+      _wakeup(false),
+      _thread()
+{
+    _thread = std::thread([this]() { run(); });
+}
+
+LockFreeSequencedTaskExecutor::Strand::~Strand()
+{
+    shutdown();
+    _thread.join();
+    assert(_pending.load() == 0);
+}
+
+LockFreeSequencedTaskExecutor::Strand::Node *
+LockFreeSequencedTaskExecutor::Strand::pop()
+{
+    Node *tail = _tail;
+    Node *next = tail->next.load(std::memory_order_acquire);
+    if (tail == &_stub) {
+        if (next == nullptr) {
+            return nullptr;
+        }
+        _tail = next;
+        tail = next;
+        next = next->next.load(std::memory_order_acquire);
+    }
+    if (next != nullptr) {
+        _tail = next;
+        return tail;
+    }
+    if (tail != _head.load(std::memory_order_acquire)) {
+        return nullptr; // A producer is in the middle of linking in a node
+    }
+    _stub.next.store(nullptr, std::memory_order_relaxed);
+    push(&_stub);
+    next = tail->next.load(std::memory_order_acquire);
+    if (next != nullptr) {
+        _tail = next;
+        return tail;
+    }
+    return nullptr;
+}
+
+uint32_t
+LockFreeSequencedTaskExecutor::Strand::drain()
+{
+    uint32_t done = 0;
+    while (done < maxBatchSize) {
+        std::unique_ptr<Node> node(pop());
+        if (!node) {
+            break;
+        }
+        node->task->run();
+        ++done;
+    }
+    return done;
+}
+
+bool
+LockFreeSequencedTaskExecutor::Strand::waitForTasks()
+{
+    std::unique_lock<std::mutex> guard(_lock);
+    _workerWaiting.store(true, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    while (!_wakeup && !hasLinkedTask()) {
+        if (_closed.load() && (_pending.load() == 0)) {
+            _workerWaiting.store(false, std::memory_order_relaxed);
+            return false;
+        }
+        _workerCond.wait(guard);
+    }
+    _workerWaiting.store(false, std::memory_order_relaxed);
+    _wakeup = false;
+    return true;
+}
+
+void
+LockFreeSequencedTaskExecutor::Strand::wakeWorkerIfWaiting()
+{
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    if (!_workerWaiting.load(std::memory_order_relaxed)) {
+        return;
+    }
+    std::lock_guard<std::mutex> guard(_lock);
+    if (_workerWaiting.load(std::memory_order_relaxed)) {
+        _wakeup = true;
+        _workerCond.notify_one();
+    }
+}
+
+void
+LockFreeSequencedTaskExecutor::Strand::run()
+{
+    uint32_t spins = 0;
+    for (;;) {
+        uint32_t done = drain();
+        if (done > 0) {
+            spins = 0;
+            _pending.fetch_sub(done);
+            if (_producerBlocked.load()) {
+                wakeProducers();
+            }
+        } else if ((_pending.load() > 0) && (++spins < maxSpinsBeforeBlocking)) {
+            std::this_thread::yield(); // A producer is linking in a task
+        } else {
+            spins = 0;
+            if (!waitForTasks()) {
+                return;
+            }
+        }
+    }
+}
+
+template <typename LimitFunc>
+void
+LockFreeSequencedTaskExecutor::Strand::waitForPendingBelow(LimitFunc limit)
+{
+    if (_pending.load(std::memory_order_relaxed) < limit()) {
+        return;
+    }
+    std::unique_lock<std::mutex> guard(_lock);
+    for (;;) {
+        _producerBlocked.store(true);
+        if (_pending.load() < limit()) {
+            return;
+        }
+        _producerCond.wait(guard);
+    }
+}
+
+void
+LockFreeSequencedTaskExecutor::Strand::wakeProducers()
+{
+    {
+        std::lock_guard<std::mutex> guard(_lock);
+        _producerBlocked.store(false);
+    }
+    _producerCond.notify_all();
+}
+
+Executor::Task::UP
+LockFreeSequencedTaskExecutor::Strand::execute(Executor::Task::UP task, bool limited)
+{
+    if (limited) {
+        waitForPendingBelow([this]() { return _taskLimit.load(); });
+    }
+    uint32_t pending = _pending.fetch_add(1);
+    if (_closed.load()) {
+        _pending.fetch_sub(1);
+        wakeWorkerIfWaiting(); // It might be waiting for this task before exiting
+        if (limited) {
+            _rejectedTasks.fetch_add(1, std::memory_order_relaxed);
+        }
+        return task;
+    }
+    push(new Node(std::move(task)));
+    wakeWorkerIfWaiting();
+    if (limited) {
+        _acceptedTasks.fetch_add(1, std::memory_order_relaxed);
+        size_t maxPending = _maxPendingTasks.load(std::memory_order_relaxed);
+        while (pending + 1 > maxPending &&
+               !_maxPendingTasks.compare_exchange_weak(maxPending, pending + 1, std::memory_order_relaxed)) { }
+    }
+    return Executor::Task::UP();
+}
+
+void
+LockFreeSequencedTaskExecutor::Strand::waitIdle()
+{
+    waitForPendingBelow([]() { return 1u; });
+}
+
+void
+LockFreeSequencedTaskExecutor::Strand::shutdown()
+{
+    std::lock_guard<std::mutex> guard(_lock);
+    _closed.store(true);
+    _wakeup = true;
+    _workerCond.notify_one();
+}
+
+void
+LockFreeSequencedTaskExecutor::Strand::setTaskLimit(uint32_t taskLimit)
+{
+    _taskLimit.store(taskLimit);
+    wakeProducers();
+}
+
+LockFreeSequencedTaskExecutor::Stats
+LockFreeSequencedTaskExecutor::Strand::getStats()
+{
+    Stats stats;
+    stats.acceptedTasks = _acceptedTasks.exchange(0, std::memory_order_relaxed);
+    stats.rejectedTasks = _rejectedTasks.exchange(0, std::memory_order_relaxed);
+    stats.maxPendingTasks = _maxPendingTasks.exchange(_pending.load(std::memory_order_relaxed), std::memory_order_relaxed);
+    return stats;
+}
+
+LockFreeSequencedTaskExecutor::LockFreeSequencedTaskExecutor(uint32_t threads, uint32_t taskLimit)
+    : _strands(),
+      _ids()
+{
+    for (uint32_t id = 0; id < threads; ++id) {
+        _strands.push_back(std::make_unique<Strand>(taskLimit));
+    }
+}
+
+LockFreeSequencedTaskExecutor::~LockFreeSequencedTaskExecutor()
+{
+    sync();
+}
+
+void
+LockFreeSequencedTaskExecutor::setTaskLimit(uint32_t taskLimit)
+{
+    for (const auto &strand : _strands) {
+        strand->setTaskLimit(taskLimit);
+    }
+}
+
+ISequencedTaskExecutor::ExecutorId
+LockFreeSequencedTaskExecutor::getExecutorId(uint64_t componentId)
+{
+    auto itr = _ids.find(componentId);
+    if (itr == _ids.end()) {
+        auto insarg = std::make_pair(componentId, ExecutorId(_ids.size() % _strands.size()));
+        auto insres = _ids.insert(insarg);
+        assert(insres.second);
+        itr = insres.first;
+    }
+    return itr->second;
+}
+
+void
+LockFreeSequencedTaskExecutor::executeTask(ExecutorId id, Executor::Task::UP task)
+{
+    assert(id.getId() < _strands.size());
+    // Tasks rejected after shutdown are dropped, and counted in the stats
+    _strands[id.getId()]->execute(std::move(task), true);
+}
+
+void
+LockFreeSequencedTaskExecutor::sync()
+{
+    vespalib::CountDownLatch latch(_strands.size());
+    for (auto &strand : _strands) {
+        auto rejected = strand->execute(vespalib::makeLambdaTask([&latch]() { latch.countDown(); }), false);
+        if (rejected) {
+            // The strand is shut down, but its thread still runs the queued tasks
+            strand->waitIdle();
+            rejected->run();
+        }
+    }
+    latch.await();
+}
+
+void
+LockFreeSequencedTaskExecutor::shutdown()
+{
+    for (auto &strand : _strands) {
+        strand->shutdown();
+    }
+}
+
+LockFreeSequencedTaskExecutor::Stats
+LockFreeSequencedTaskExecutor::getStats()
+{
+    Stats accumulatedStats;
+    for (auto &strand : _strands) {
+        Stats stats = strand->getStats();
+        accumulatedStats.maxPendingTasks += stats.maxPendingTasks;
+        accumulatedStats.acceptedTasks += stats.acceptedTasks;
+        accumulatedStats.rejectedTasks += stats.rejectedTasks;
+    }
+    return accumulatedStats;
+}
+
+} // namespace search
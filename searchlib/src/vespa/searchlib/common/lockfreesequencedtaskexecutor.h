@@ -0,0 +1,46 @@
+// Copyright 2019 Oath Inc. Licensed under the terms of the Apache 2.0 license. See LICENSE in the project root.
+#pragma once
+
+#include "isequencedtaskexecutor.h"
+#include <vespa/vespalib/stllike/hash_map.h>
+#include <vector>
+
+namespace search {
+
+/**
+ * Class to run multiple tasks in parallel, but tasks with same
+ * id has to be run in sequence.
+ *
+ * Each executor id is served by a single thread consuming a lock free
+ * multi producer, single consumer queue. A producer only takes a lock
+ * to wake up the thread when it is blocked waiting for tasks, or when
+ * it has to wait because the task limit is reached. The thread runs
+ * the tasks available in the queue in batches before updating the
+ * pending task count, and blocks when there is nothing left to run.
+ *
+ * Drop-in alternative to SequencedTaskExecutor, with the same sync()
+ * and task limit semantics. Tasks scheduled after shutdown() are
+ * dropped and counted as rejected in the stats.
+ */
+class LockFreeSequencedTaskExecutor : public ISequencedTaskExecutor
+{
+    class Strand;
+    using Stats = vespalib::ExecutorStats;
+    std::vector<std::unique_ptr<Strand>> _strands;
+    vespalib::hash_map<size_t, ExecutorId> _ids;
+public:
+    using ISequencedTaskExecutor::getExecutorId;
+
+    LockFreeSequencedTaskExecutor(uint32_t threads, uint32_t taskLimit = 1000);
+    ~LockFreeSequencedTaskExecutor() override;
+
+    void setTaskLimit(uint32_t taskLimit) override;
+    uint32_t getNumExecutors() const override { return _strands.size(); }
+    ExecutorId getExecutorId(uint64_t componentId) override;
+    void executeTask(ExecutorId id, vespalib::Executor::Task::UP task) override;
+    void sync() override;
+    void shutdown();
+    Stats getStats() override;
+};
+
+} // namespace search
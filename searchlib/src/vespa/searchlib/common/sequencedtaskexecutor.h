@@ -5,10 +5,7 @@
 #include <vespa/vespalib/stllike/hash_map.h>
 #include <vector>
 
-namespace vespalib {
-    struct ExecutorStats;
-    class BlockingThreadStackExecutor;
-}
+namespace vespalib { class BlockingThreadStackExecutor; }
 
 namespace search {
 
@@ -27,12 +24,12 @@ public:
     SequencedTaskExecutor(uint32_t threads, uint32_t taskLimit = 1000);
     ~SequencedTaskExecutor();
 
-    void setTaskLimit(uint32_t taskLimit);
+    void setTaskLimit(uint32_t taskLimit) override;
     uint32_t getNumExecutors() const override { return _executors.size(); }
     ExecutorId getExecutorId(uint64_t componentId) override;
     void executeTask(ExecutorId id, vespalib::Executor::Task::UP task) override;
     void sync() override;
-    Stats getStats();
+    Stats getStats() override;
 };
 
 } // namespace search
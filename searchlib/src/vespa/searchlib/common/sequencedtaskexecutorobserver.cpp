@@ -39,6 +39,18 @@ SequencedTaskExecutorObserver::sync()
     _executor.sync();
 }
 
+void
+SequencedTaskExecutorObserver::setTaskLimit(uint32_t taskLimit)
+{
+    _executor.setTaskLimit(taskLimit);
+}
+
+vespalib::ExecutorStats
+SequencedTaskExecutorObserver::getStats()
+{
+    return _executor.getStats();
+}
+
 std::vector<uint32_t>
 SequencedTaskExecutorObserver::getExecuteHistory()
 {
@@ -0,0 +1,109 @@
+// Copyright 2019 Oath Inc. Licensed under the terms of the Apache 2.0 license. See LICENSE in the project root.
+
+#include "sequencedtaskexecutorview.h"
+#include <vespa/vespalib/stllike/hash_map.hpp>
+#include <cassert>
+
+namespace search {
+
+SequencedTaskExecutorView::SequencedTaskExecutorView(ISequencedTaskExecutor &executor, uint32_t numExecutors,
+                                                     uint32_t offset, uint32_t taskLimit)
+    : _executor(executor),
+      _numExecutors(std::max(numExecutors, 1u)),
+      _offset(offset),
+      _ids(),
+      _lock(),
+      _cond(),
+      _waiters(0),
+      _pending(0),
+      _taskLimit(taskLimit),
+      _acceptedTasks(0),
+      _maxPendingTasks(0)
+{
+}
+
+SequencedTaskExecutorView::~SequencedTaskExecutorView()
+{
+    sync();
+}
+
+template <typename Pred>
+void
+SequencedTaskExecutorView::waitFor(Pred pred)
+{
+    std::unique_lock<std::mutex> guard(_lock);
+    ++_waiters;
+    while (!pred()) {
+        _cond.wait(guard);
+    }
+    --_waiters;
+}
+
+void
+SequencedTaskExecutorView::taskDone()
+{
+    // The view must not be touched after the lock is released, as sync() may return and the view be destroyed.
+    std::lock_guard<std::mutex> guard(_lock);
+    --_pending;
+    if (_waiters > 0) {
+        _cond.notify_all();
+    }
+}
+
+ISequencedTaskExecutor::ExecutorId
+SequencedTaskExecutorView::getExecutorId(uint64_t componentId)
+{
+    auto itr = _ids.find(componentId);
+    if (itr == _ids.end()) {
+        auto insarg = std::make_pair(componentId, ExecutorId(_ids.size() % _numExecutors));
+        auto insres = _ids.insert(insarg);
+        assert(insres.second);
+        itr = insres.first;
+    }
+    return itr->second;
+}
+
+void
+SequencedTaskExecutorView::executeTask(ExecutorId id, vespalib::Executor::Task::UP task)
+{
+    assert(id.getId() < _numExecutors);
+    uint64_t limit = uint64_t(_taskLimit.load()) * _numExecutors;
+    if (_pending.load() >= limit) {
+        waitFor([this]() { return _pending.load() < uint64_t(_taskLimit.load()) * _numExecutors; });
+    }
+    uint32_t pending = ++_pending;
+    ++_acceptedTasks;
+    size_t maxPending = _maxPendingTasks.load(std::memory_order_relaxed);
+    while (pending > maxPending &&
+           !_maxPendingTasks.compare_exchange_weak(maxPending, pending, std::memory_order_relaxed)) { }
+    ExecutorId sharedId((_offset + id.getId()) % _executor.getNumExecutors());
+    _executor.executeTask(sharedId, vespalib::makeLambdaTask([this, inner = std::move(task)]() {
+                                                                 inner->run();
+                                                                 taskDone();
+                                                             }));
+}
+
+void
+SequencedTaskExecutorView::sync()
+{
+    waitFor([this]() { return _pending.load() == 0; });
+}
+
+void
+SequencedTaskExecutorView::setTaskLimit(uint32_t taskLimit)
+{
+    _taskLimit = taskLimit;
+    std::lock_guard<std::mutex> guard(_lock);
+    _cond.notify_all();
+}
+
+vespalib::ExecutorStats
+SequencedTaskExecutorView::getStats()
+{
+    vespalib::ExecutorStats stats;
+    stats.acceptedTasks = _acceptedTasks.exchange(0);
+    stats.maxPendingTasks = _maxPendingTasks.exchange(_pending.load());
+    return stats;
+}
+
+} // namespace search
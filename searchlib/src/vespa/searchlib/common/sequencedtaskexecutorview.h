@@ -0,0 +1,65 @@
+// Copyright 2019 Oath Inc. Licensed under the terms of the Apache 2.0 license. See LICENSE in the project root.
+#pragma once
+
+#include "isequencedtaskexecutor.h"
+#include <vespa/vespalib/stllike/hash_map.h>
+#include <atomic>
+#include <condition_variable>
+#include <mutex>
+
+namespace search {
+
+/**
+ * A view of a sequenced task executor shared with other users. The
+ * view has its own set of executor ids and component id mapping, which
+ * are mapped onto the executors of the shared executor starting at the
+ * given offset.
+ *
+ * Tasks scheduled through the view are tracked, so the task limit,
+ * sync() and stats only concern this view. The task limit applies to
+ * the total number of pending tasks in the view (task limit times
+ * number of executor ids), which keeps a busy user from filling the
+ * queues of the shared executor while still letting it use all of
+ * them. sync() does not wait for tasks scheduled by other users.
+ *
+ * A task is marked as done while holding the view lock, which sync()
+ * also takes, so the view can be destroyed as soon as sync() returns.
+ */
+class SequencedTaskExecutorView : public ISequencedTaskExecutor
+{
+    ISequencedTaskExecutor                &_executor;
+    const uint32_t                         _numExecutors;
+    const uint32_t                         _offset;
+    vespalib::hash_map<size_t, ExecutorId> _ids;
+    std::mutex                             _lock;
+    std::condition_variable                _cond;
+    uint32_t                               _waiters;
+    std::atomic<uint32_t>                  _pending;
+    std::atomic<uint32_t>                  _taskLimit;
+    std::atomic<size_t>                    _acceptedTasks;
+    std::atomic<size_t>                    _maxPendingTasks;
+
+    template <typename Pred>
+    void waitFor(Pred pred);
+    void taskDone();
+public:
+    using ISequencedTaskExecutor::getExecutorId;
+
+    /**
+     * @param executor      the shared executor
+     * @param numExecutors  the number of executor ids exposed by this view
+     * @param offset        the executor id in the shared executor used for executor id 0 in this view
+     * @param taskLimit     max number of pending tasks per executor id in this view
+     */
+    SequencedTaskExecutorView(ISequencedTaskExecutor &executor, uint32_t numExecutors, uint32_t offset, uint32_t taskLimit);
+    ~SequencedTaskExecutorView() override;
+
+    uint32_t getNumExecutors() const override { return _numExecutors; }
+    ExecutorId getExecutorId(uint64_t componentId) override;
+    void executeTask(ExecutorId id, vespalib::Executor::Task::UP task) override;
+    void sync() override;
+    void setTaskLimit(uint32_t taskLimit) override;
+    vespalib::ExecutorStats getStats() override;
+};
+
+} // namespace search
@@ -234,6 +234,9 @@ FastS_SortSpec::initSortData(const RankedHit *hits, uint32_t n)
             }
         }
     }
+    if ((variableWidth == 0) && initFixedWidthSortData(hits, n, fixedWidth)) {
+        return;
+    }
     uint32_t dataSize = (fixedWidth + variableWidth) * n;
     uint32_t available = dataSize;
     _binarySortData.resize(dataSize);
@@ -294,6 +297,73 @@ FastS_SortSpec::initSortData(const RankedHit *hits, uint32_t n)
     }
 }
 
+bool
+FastS_SortSpec::initFixedWidthSortData(const RankedHit *hits, uint32_t n, size_t fixedWidth)
+{
+    _binarySortData.resize(fixedWidth * n);
+    _sortDataArray.resize(n);
+    uint8_t *sortData = &_binarySortData[0];
+    size_t offset = 0;
+    // Fill one column at a time, so the type dispatch is done once per sort level and not once per hit.
+    for (auto iter = _vectors.begin(); (iter != _vectors.end()) && !_doom.hard_doom(); ++iter) {
+        uint8_t *dst = sortData + offset;
+        size_t width = 0;
+        switch (iter->_type) {
+        case ASC_DOCID:
+            width = sizeof(hits->_docId) + sizeof(_partitionId);
+            for (uint32_t i(0); i < n; ++i, dst += fixedWidth) {
+                serializeForSort<convertForSort<uint32_t, true> >(hits[i].getDocId(), dst);
+                serializeForSort<convertForSort<uint16_t, true> >(_partitionId, dst + sizeof(hits->_docId));
+            }
+            break;
+        case DESC_DOCID:
+            width = sizeof(hits->_docId) + sizeof(_partitionId);
+            for (uint32_t i(0); i < n; ++i, dst += fixedWidth) {
+                serializeForSort<convertForSort<uint32_t, false> >(hits[i].getDocId(), dst);
+                serializeForSort<convertForSort<uint16_t, false> >(_partitionId, dst + sizeof(hits->_docId));
+            }
+            break;
+        case ASC_RANK:
+            width = sizeof(hits->_rankValue);
+            for (uint32_t i(0); i < n; ++i, dst += fixedWidth) {
+                serializeForSort<convertForSort<search::HitRank, true> >(hits[i]._rankValue, dst);
+            }
+            break;
+        case DESC_RANK:
+            width = sizeof(hits->_rankValue);
+            for (uint32_t i(0); i < n; ++i, dst += fixedWidth) {
+                serializeForSort<convertForSort<search::HitRank, false> >(hits[i]._rankValue, dst);
+            }
+            break;
+        case ASC_VECTOR:
+            width = iter->_vector->getFixedWidth();
+            for (uint32_t i(0); i < n; ++i, dst += fixedWidth) {
+                if (iter->_vector->serializeForAscendingSort(hits[i].getDocId(), dst, width, iter->_converter) != long(width)) {
+                    return false;
+                }
+            }
+            break;
+        case DESC_VECTOR:
+            width = iter->_vector->getFixedWidth();
+            for (uint32_t i(0); i < n; ++i, dst += fixedWidth) {
+                if (iter->_vector->serializeForDescendingSort(hits[i].getDocId(), dst, width, iter->_converter) != long(width)) {
+                    return false;
+                }
+            }
+            break;
+        }
+        offset += width;
+    }
+    for (uint32_t i(0); i < n; ++i) {
+        SortData & sd = _sortDataArray[i];
+        sd._docId = hits[i]._docId;
+        sd._rankValue = hits[i]._rankValue;
+        sd._idx = i * fixedWidth;
+        sd._len = fixedWidth;
+        sd._pos = 0;
+    }
+    return true;
+}
 
 FastS_SortSpec::FastS_SortSpec(uint32_t partitionId, const Doom & doom, const ConverterFactory & ucaFactory, int method) :
     _partitionId(partitionId),
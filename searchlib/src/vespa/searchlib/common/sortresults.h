@@ -109,6 +109,12 @@ private:
 
     bool Add(search::attribute::IAttributeContext & vecMan, const search::common::SortInfo & sInfo);
     void initSortData(const search::RankedHit *a, uint32_t n);
+    /**
+     * Build the sort blobs when all sort levels have a fixed width, writing one sort level
+     * for all hits at a time. Returns false if an attribute did not serialize to its
+     * advertised fixed width, in which case the generic path must be used.
+     **/
+    bool initFixedWidthSortData(const search::RankedHit *a, uint32_t n, size_t fixedWidth);
     uint8_t * realloc(uint32_t n, size_t & variableWidth, uint32_t & available, uint32_t & dataSize, uint8_t *mySortData);
 
 public:
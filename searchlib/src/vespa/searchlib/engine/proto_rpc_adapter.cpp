@@ -82,9 +82,10 @@ bool decode_message(const FRT_Values &src, MSG &dst) {
 struct SearchRequestDecoder : SearchRequest::Source::Decoder {
     FRT_RPCRequest &rpc; // valid until Return is called
     QueryStats &stats;
+    SearchRequestCapture *capture;
     RelativeTime relative_time;
-    SearchRequestDecoder(FRT_RPCRequest &rpc_in, QueryStats &stats_in)
-        : rpc(rpc_in), stats(stats_in), relative_time(std::make_unique<SteadyClock>()) {}
+    SearchRequestDecoder(FRT_RPCRequest &rpc_in, QueryStats &stats_in, SearchRequestCapture *capture_in)
+        : rpc(rpc_in), stats(stats_in), capture(capture_in), relative_time(std::make_unique<SteadyClock>()) {}
     std::unique_ptr<SearchRequest> decode() override {
         ProtoSearchRequest msg;
         stats.request_size = (*rpc.GetParams())[2]._data._len;
@@ -92,14 +93,17 @@ struct SearchRequestDecoder : SearchRequest::Source::Decoder {
             LOG(warning, "got bad protobuf search request over rpc (unable to decode)");
             return std::unique_ptr<SearchRequest>(nullptr);
         }
+        if (capture != nullptr) {
+            capture->sample(msg);
+        }
         auto req = std::make_unique<SearchRequest>(std::move(relative_time));
         ProtoConverter::search_request_from_proto(msg, *req);
         return req;
     }
 };
 
-std::unique_ptr<SearchRequest::Source::Decoder> search_request_decoder(FRT_RPCRequest &rpc, QueryStats &stats) {
-    return std::make_unique<SearchRequestDecoder>(rpc, stats);
+std::unique_ptr<SearchRequest::Source::Decoder> search_request_decoder(FRT_RPCRequest &rpc, QueryStats &stats, SearchRequestCapture *capture) {
+    return std::make_unique<SearchRequestDecoder>(rpc, stats, capture);
 }
 
 // allocated in the stash of the request it is completing; no self-delete needed
@@ -203,7 +207,8 @@ ProtoRpcAdapter::ProtoRpcAdapter(SearchServer &search_server,
       _docsum_server(docsum_server),
       _monitor_server(monitor_server),
       _online(false),
-      _metrics()
+      _metrics(),
+      _search_capture()
 {
     FRT_ReflectionBuilder rb(&orb);
     //-------------------------------------------------------------------------
@@ -224,6 +229,8 @@ ProtoRpcAdapter::ProtoRpcAdapter(SearchServer &search_server,
     //-------------------------------------------------------------------------
 }
 
+ProtoRpcAdapter::~ProtoRpcAdapter() = default;
+
 void
 ProtoRpcAdapter::rpc_search(FRT_RPCRequest *req)
 {
@@ -232,7 +239,7 @@ ProtoRpcAdapter::rpc_search(FRT_RPCRequest *req)
     }
     req->Detach();
     auto &client = req->getStash().create<SearchCompletionHandler>(*req, _metrics);
-    auto reply = _search_server.search(search_request_decoder(*req, client.stats), client);
+    auto reply = _search_server.search(search_request_decoder(*req, client.stats, _search_capture.get()), client);
     if (reply) {
         client.searchDone(std::move(reply));
     }
@@ -7,6 +7,7 @@
 #include <atomic>
 
 #include "search_protocol_metrics.h"
+#include "search_request_capture.h"
 
 class FRT_Supervisor;
 
@@ -36,14 +37,19 @@ private:
     MonitorServer  &_monitor_server;
     std::atomic<bool> _online;
     SearchProtocolMetrics _metrics;
+    std::unique_ptr<SearchRequestCapture> _search_capture;
 public:
     ProtoRpcAdapter(SearchServer &search_server,
                     DocsumServer &docsum_server,
                     MonitorServer &monitor_server,
                     FRT_Supervisor &orb);
+    ~ProtoRpcAdapter();
 
     SearchProtocolMetrics &metrics() { return _metrics; }
 
+    // must be called before set_online
+    void set_search_capture(std::unique_ptr<SearchRequestCapture> capture) { _search_capture = std::move(capture); }
+
     void set_online() { _online.store(true, std::memory_order_release); }
     bool is_online() const { return _online.load(std::memory_order_acquire); }
 
@@ -0,0 +1,185 @@
+// Copyright 2019 Oath Inc. Licensed under the terms of the Apache 2.0 license. See LICENSE in the project root.
+
+#include "search_request_capture.h"
+#include <algorithm>
+#include <arpa/inet.h>
+#include <cerrno>
+#include <cstring>
+#include <vector>
+
+#include <vespa/log/log.h>
+LOG_SETUP(".engine.search_request_capture");
+
+namespace search::engine {
+
+namespace {
+
+// max size of serialized requests waiting to be written by the writer thread
+constexpr size_t max_queued_bytes = 64 * 1024 * 1024;
+
+}
+
+void
+SearchRequestCapture::open_file()
+{
+    _file = fopen(_file_name.c_str(), "a");
+    if (_file == nullptr) {
+        LOG(warning, "Unable to open search request capture file '%s': %s", _file_name.c_str(), strerror(errno));
+        return;
+    }
+    long pos = ftell(_file);
+    _file_size = (pos > 0) ? pos : 0;
+}
+
+void
+SearchRequestCapture::close_file()
+{
+    if (_file != nullptr) {
+        fclose(_file);
+        _file = nullptr;
+    }
+    _file_size = 0;
+}
+
+void
+SearchRequestCapture::write_record(const std::string &blob)
+{
+    if ((_file != nullptr) && (_file_size >= _max_file_size)) {
+        close_file();
+        vespalib::string rotated = _file_name + ".1";
+        if (rename(_file_name.c_str(), rotated.c_str()) != 0) {
+            LOG(warning, "Unable to rotate search request capture file '%s': %s", _file_name.c_str(), strerror(errno));
+        }
+        open_file();
+    }
+    if (_file == nullptr) {
+        return;
+    }
+    uint32_t len = htonl(blob.size());
+    if ((fwrite(&len, sizeof(len), 1, _file) != 1) ||
+        (fwrite(blob.data(), 1, blob.size(), _file) != blob.size()))
+    {
+        LOG(warning, "Unable to write to search request capture file '%s', capture disabled", _file_name.c_str());
+        close_file();
+        return;
+    }
+    _file_size += sizeof(len) + blob.size();
+    _captured.fetch_add(1, std::memory_order_relaxed);
+}
+
+void
+SearchRequestCapture::run()
+{
+    std::vector<std::string> batch;
+    std::unique_lock<std::mutex> guard(_lock);
+    for (;;) {
+        while (_queue.empty() && !_closed) {
+            _wakeup.wait(guard);
+        }
+        if (_queue.empty()) {
+            return;
+        }
+        batch.swap(_queue);
+        _queued_bytes = 0;
+        _writing = true;
+        guard.unlock();
+        for (const auto &blob: batch) {
+            write_record(blob);
+        }
+        if (_file != nullptr) {
+            fflush(_file);
+        }
+        batch.clear();
+        guard.lock();
+        _writing = false;
+        _idle.notify_all();
+    }
+}
+
+SearchRequestCapture::SearchRequestCapture(const vespalib::string &file_name, uint32_t sample_every, uint64_t max_file_size)
+    : _file_name(file_name),
+      _sample_every(std::max(sample_every, 1u)),
+      _max_file_size(max_file_size),
+      _seen(0),
+      _captured(0),
+      _dropped(0),
+      _lock(),
+      _wakeup(),
+      _idle(),
+      _queue(),
+      _queued_bytes(0),
+      _writing(false),
+      _closed(false),
+      _file(nullptr),
+      _file_size(0),
+      _writer()
+{
+    open_file();
+    _writer = std::thread([this](){ run(); });
+}
+
+SearchRequestCapture::~SearchRequestCapture()
+{
+    {
+        std::lock_guard<std::mutex> guard(_lock);
+        _closed = true;
+        _wakeup.notify_one();
+    }
+    _writer.join();
+    close_file();
+}
+
+void
+SearchRequestCapture::sample(const ProtoSearchRequest &request)
+{
+    if ((_seen.fetch_add(1, std::memory_order_relaxed) % _sample_every) != 0) {
+        return;
+    }
+    std::string blob = request.SerializeAsString();
+    std::lock_guard<std::mutex> guard(_lock);
+    if ((_queued_bytes + blob.size()) > max_queued_bytes) {
+        _dropped.fetch_add(1, std::memory_order_relaxed);
+        return;
+    }
+    _queued_bytes += blob.size();
+    _queue.push_back(std::move(blob));
+    _wakeup.notify_one();
+}
+
+void
+SearchRequestCapture::sync()
+{
+    std::unique_lock<std::mutex> guard(_lock);
+    while (!_queue.empty() || _writing) {
+        _idle.wait(guard);
+    }
+}
+
+size_t
+SearchRequestCapture::read_file(const vespalib::string &file_name, const Consumer &consumer)
+{
+    FILE *file = fopen(file_name.c_str(), "r");
+    if (file == nullptr) {
+        return 0;
+    }
+    size_t num_read = 0;
+    std::vector<char> buf;
+    uint32_t len = 0;
+    while (fread(&len, sizeof(len), 1, file) == 1) {
+        buf.resize(ntohl(len));
+        if (fread(buf.data(), 1, buf.size(), file) != buf.size()) {
+            break;
+        }
+        ProtoSearchRequest request;
+        if (!request.ParseFromArray(buf.data(), buf.size())) {
+            LOG(warning, "Bad search request in capture file '%s' after %zu requests", file_name.c_str(), num_read);
+            break;
+        }
+        consumer(request);
+        ++num_read;
+    }
+    fclose(file);
+    return num_read;
+}
+
+}
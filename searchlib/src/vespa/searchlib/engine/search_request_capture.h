@@ -0,0 +1,88 @@
+// Copyright 2019 Oath Inc. Licensed under the terms of the Apache 2.0 license. See LICENSE in the project root.
+
+#pragma once
+
+#include "proto_converter.h"
+#include <vespa/vespalib/stllike/string.h>
+#include <atomic>
+#include <condition_variable>
+#include <cstdio>
+#include <functional>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace search::engine {
+
+/**
+ * Writes a sample of the protobuf search requests received by a
+ * search node to a local file, so that real traffic can later be
+ * replayed against the matching engine in a controlled setting.
+ *
+ * Each record is a 32-bit length (network byte order) followed by the
+ * serialized request. When the file grows beyond the max file size it
+ * is renamed to '<file>.1' (replacing any earlier one) and a new file
+ * is started, bounding the disk usage to about twice the max size.
+ *
+ * Requests are only serialized in the calling (query) thread. Writing
+ * to the file is done by an internal writer thread. If the writer
+ * falls behind, samples are dropped instead of blocking the caller.
+ **/
+class SearchRequestCapture
+{
+public:
+    using ProtoSearchRequest = ProtoConverter::ProtoSearchRequest;
+    using Consumer = std::function<void(ProtoSearchRequest &)>;
+private:
+    vespalib::string         _file_name;
+    uint32_t                 _sample_every;
+    uint64_t                 _max_file_size;
+    std::atomic<uint64_t>    _seen;
+    std::atomic<uint64_t>    _captured;
+    std::atomic<uint64_t>    _dropped;
+    std::mutex               _lock;
+    std::condition_variable  _wakeup;
+    std::condition_variable  _idle;
+    std::vector<std::string> _queue;
+    size_t                   _queued_bytes;
+    bool                     _writing;
+    bool                     _closed;
+    FILE                    *_file;      // only used by writer thread
+    uint64_t                 _file_size;  // only used by writer thread
+    std::thread              _writer;
+
+    void open_file();
+    void close_file();
+    void write_record(const std::string &blob);
+    void run();
+public:
+    SearchRequestCapture(const vespalib::string &file_name, uint32_t sample_every, uint64_t max_file_size);
+    ~SearchRequestCapture();
+
+    /**
+     * Called for each successfully decoded request. Every
+     * sample_every'th request is queued to be written to the capture
+     * file.
+     **/
+    void sample(const ProtoSearchRequest &request);
+
+    /**
+     * Wait until all queued requests have been written to the capture
+     * file.
+     **/
+    void sync();
+
+    uint64_t captured() const { return _captured.load(std::memory_order_relaxed); }
+    uint64_t dropped() const { return _dropped.load(std::memory_order_relaxed); }
+
+    /**
+     * Reads all records in the given capture file, handing each
+     * request to the consumer. Returns the number of requests read. A
+     * truncated record at the end of the file (e.g. after a crash) is
+     * ignored.
+     **/
+    static size_t read_file(const vespalib::string &file_name, const Consumer &consumer);
+};
+
+}
@@ -102,6 +102,9 @@ public:
         read(&result, sizeof(result));
         return result;
     }
+    void readHostOrder(T * values, size_t count) {
+        read(values, count * sizeof(T));
+    }
 };
 
 class SequentialFileArray
@@ -5,6 +5,7 @@
 #include <vespa/searchsummary/docsummary/resultpacker.h>
 #include <vespa/searchsummary/docsummary/docsumstate.h>
 #include <vespa/vespalib/data/slime/slime.h>
+#include <vespa/vespalib/data/slime/binary_stream_encoder.h>
 #include <vespa/searchlib/util/slime_output_raw_buf_adapter.h>
 
 using namespace vespalib::slime::convenience;
@@ -46,6 +47,20 @@ struct DocsumFixture : IDocsumStore, GetDocsumsStateCallback {
         EXPECT_GREATER(vespalib::slime::BinaryFormat
                        ::decode(Memory(buf.GetDrainPos(), buf.GetUsedLen()), slime), 0u);
     }
+    void insertDocsum(Slime &slime) {
+        SlimeInserter inserter(slime);
+        auto rci = writer->resolveClassInfo(state._args.getResultClassName(), getSummaryClassId());
+        writer->insertDocsum(rci, 1u, &state, this, slime, inserter);
+    }
+    void writeDocsum(Slime &slime, bool classSymbols) {
+        vespalib::slime::BinaryStreamEncoder encoder;
+        auto rci = writer->resolveClassInfo(state._args.getResultClassName(), getSummaryClassId());
+        encoder.reset(classSymbols ? &rci.outputClass->getSymbols() : nullptr);
+        writer->writeDocsum(rci, 1u, &state, this, encoder);
+        vespalib::SimpleBuffer buf;
+        encoder.flush(buf);
+        EXPECT_EQUAL(buf.get().size, vespalib::slime::BinaryFormat::decode(buf.get(), slime));
+    }
     uint32_t getNumDocs() const override { return 2; }
     DocsumStoreValue getMappedDocsum(uint32_t docid) override {
         EXPECT_EQUAL(1u, docid);
@@ -127,4 +142,15 @@ TEST_FF("require that docsum can be written as slime", DocsumFixture(), Slime())
     EXPECT_EQUAL(f2.get()["bad_jsonstring_field"].type().getId(), 0u);
 }
 
+TEST_F("require that streamed docsum is equal to inserted docsum", DocsumFixture()) {
+    Slime expect;
+    f1.insertDocsum(expect);
+    Slime withClassSymbols;
+    f1.writeDocsum(withClassSymbols, true);
+    Slime withLocalSymbols;
+    f1.writeDocsum(withLocalSymbols, false);
+    EXPECT_EQUAL(expect.toString(), withClassSymbols.toString());
+    EXPECT_EQUAL(expect.toString(), withLocalSymbols.toString());
+}
+
 TEST_MAIN() { TEST_RUN_ALL(); }
@@ -7,11 +7,13 @@
 #include <vespa/searchlib/util/slime_output_raw_buf_adapter.h>
 #include <vespa/searchlib/attribute/iattributemanager.h>
 #include <vespa/vespalib/data/slime/slime.h>
+#include <vespa/vespalib/data/slime/binary_stream_encoder.h>
 
 #include <vespa/log/log.h>
 LOG_SETUP(".searchlib.docsummary.docsumwriter");
 
 using namespace vespalib::slime::convenience;
+using vespalib::slime::BinaryStreamEncoder;
 
 namespace search::docsummary {
 
@@ -26,6 +28,29 @@ IDocsumWriter::slime2RawBuf(const Slime & slime, RawBuf & buf)
     return (buf.GetUsedLen() - preUsed);
 }
 
+uint32_t
+IDocsumWriter::encoder2RawBuf(const BinaryStreamEncoder & encoder, RawBuf & buf)
+{
+    const uint32_t preUsed = buf.GetUsedLen();
+    const uint32_t magic = SLIME_MAGIC_ID;
+    buf.append(&magic, sizeof(magic));
+    SlimeOutputRawBufAdapter adapter(buf);
+    encoder.flush(adapter);
+    return (buf.GetUsedLen() - preUsed);
+}
+
+void
+IDocsumWriter::writeDocsum(const ResolveClassInfo & rci, uint32_t docid, GetDocsumsState *state,
+                           IDocsumStore *docinfos, BinaryStreamEncoder & encoder)
+{
+    vespalib::Slime slime;
+    vespalib::slime::SlimeInserter inserter(slime);
+    insertDocsum(rci, docid, state, docinfos, slime, inserter);
+    if (slime.get().type().getId() != vespalib::slime::NIX::ID) {
+        encoder.writeValue(slime.get());
+    }
+}
+
 DynamicDocsumWriter::ResolveClassInfo
 DynamicDocsumWriter::resolveClassInfo(vespalib::stringref outputClassName, uint32_t inputClassId) const
 {
@@ -144,6 +169,107 @@ static void convertEntry(GetDocsumsState *state,
     }
 }
 
+static void writeEntry(GetDocsumsState *state,
+                       const ResConfigEntry *resCfg,
+                       const ResEntry *entry,
+                       Symbol symbol,
+                       BinaryStreamEncoder &encoder)
+{
+    const char *ptr;
+    uint32_t len;
+
+    LOG_ASSERT(resCfg != nullptr && entry != nullptr);
+    switch (resCfg->_type) {
+    case RES_INT:
+    case RES_SHORT:
+    case RES_BYTE:
+        if (entry->_intval != default_32bits_int) {
+            encoder.field(symbol);
+            encoder.writeLong(entry->_intval);
+        }
+        break;
+    case RES_BOOL:
+        encoder.field(symbol);
+        encoder.writeBool(entry->_intval != 0);
+        break;
+    case RES_FLOAT:
+    case RES_DOUBLE:
+        if (! std::isnan(entry->_doubleval)) {
+            encoder.field(symbol);
+            encoder.writeDouble(entry->_doubleval);
+        }
+        break;
+    case RES_INT64:
+        if (entry->_int64val != default_64bits_int) {
+            encoder.field(symbol);
+            encoder.writeLong(entry->_int64val);
+        }
+        break;
+    case RES_STRING:
+    case RES_LONG_STRING:
+    case RES_FEATUREDATA:
+    case RES_XMLSTRING:
+        entry->_resolve_field(&ptr, &len, &state->_docSumFieldSpace);
+        if (len != 0) {
+            encoder.field(symbol);
+            encoder.writeString(Memory(ptr, len));
+        }
+        break;
+    case RES_DATA:
+    case RES_TENSOR:
+    case RES_LONG_DATA:
+        entry->_resolve_field(&ptr, &len, &state->_docSumFieldSpace);
+        if (len != 0) {
+            encoder.field(symbol);
+            encoder.writeData(Memory(ptr, len));
+        }
+        break;
+    case RES_JSONSTRING:
+        entry->_resolve_field(&ptr, &len, &state->_docSumFieldSpace);
+        if (len != 0) {
+            // note: 'JSONSTRING' really means 'structured data'
+            encoder.field(symbol);
+            size_t d = encoder.writeBinary(Memory(ptr, len));
+            if (d != len) {
+                LOG(warning, "could not decode %u bytes: %zu bytes decoded", len, d);
+            }
+        }
+        break;
+    }
+}
+
+namespace {
+
+/**
+ * Field writers insert their values into a slime object, which is
+ * created the first time it is needed for a docsum. The values are
+ * copied into the encoder as soon as they are produced.
+ **/
+class FieldWriterValues
+{
+    std::unique_ptr<Slime> _slime;
+    Cursor                *_fields;
+public:
+    FieldWriterValues() : _slime(), _fields(nullptr) { }
+    void write(IDocsumFieldWriter &writer, uint32_t docid, GeneralResult *gres, GetDocsumsState *state,
+               const ResConfigEntry &resCfg, Symbol symbol, BinaryStreamEncoder &encoder)
+    {
+        if (!_slime) {
+            _slime = std::make_unique<Slime>();
+            _fields = &_slime->setObject();
+        }
+        const Memory field_name(resCfg._bindname.data(), resCfg._bindname.size());
+        ObjectInserter inserter(*_fields, field_name);
+        writer.insertField(docid, gres, state, resCfg._type, inserter);
+        const Inspector &value = (*_fields)[field_name];
+        if (value.valid()) {
+            encoder.field(symbol);
+            encoder.writeValue(value);
+        }
+    }
+};
+
+}
 
 void
 DynamicDocsumWriter::insertDocsum(const ResolveClassInfo & rci, uint32_t docid, GetDocsumsState *state,
@@ -199,6 +325,64 @@ DynamicDocsumWriter::insertDocsum(const ResolveClassInfo & rci, uint32_t docid,
     }
 }
 
+void
+DynamicDocsumWriter::writeDocsum(const ResolveClassInfo & rci, uint32_t docid, GetDocsumsState *state,
+                                 IDocsumStore *docinfos, BinaryStreamEncoder & encoder)
+{
+    const ResultClass &outputClass = *rci.outputClass;
+    // The symbol of a field is the entry index when the encoder uses the symbols of the output class
+    const bool classSymbols = (encoder.getPreset() == &outputClass.getSymbols());
+    auto fieldSymbol = [&](uint32_t i, const ResConfigEntry &resCfg) {
+        return classSymbols ? Symbol(i) : encoder.resolve(Memory(resCfg._bindname.data(), resCfg._bindname.size()));
+    };
+    FieldWriterValues values;
+    if (rci.allGenerated) {
+        // generate docsum entry on-the-fly
+        encoder.openObject();
+        for (uint32_t i = 0; i < outputClass.GetNumEntries(); ++i) {
+            const ResConfigEntry *resCfg = outputClass.GetEntry(i);
+            IDocsumFieldWriter *writer = _overrideTable[resCfg->_enumValue];
+            if (! writer->isDefaultValue(docid, state)) {
+                values.write(*writer, docid, nullptr, state, *resCfg, fieldSymbol(i, *resCfg), encoder);
+            }
+        }
+        encoder.close();
+    } else {
+        // look up docsum entry
+        DocsumStoreValue value = docinfos->getMappedDocsum(docid);
+        // re-pack docsum blob
+        GeneralResult gres(rci.inputClass);
+        if (! gres.inplaceUnpack(value)) {
+            LOG(debug, "Unpack failed: illegal docsum entry for document %d. This is expected during lidspace compaction.", docid);
+            return;
+        }
+        encoder.openObject();
+        for (uint32_t i = 0; i < outputClass.GetNumEntries(); ++i) {
+            const ResConfigEntry *outCfg = outputClass.GetEntry(i);
+            IDocsumFieldWriter *writer = _overrideTable[outCfg->_enumValue];
+            if (writer != nullptr) {
+                if (! writer->isDefaultValue(docid, state)) {
+                    values.write(*writer, docid, &gres, state, *outCfg, fieldSymbol(i, *outCfg), encoder);
+                }
+            } else {
+                if (rci.inputClass == rci.outputClass) {
+                    writeEntry(state, outCfg, gres.GetEntry(i), fieldSymbol(i, *outCfg), encoder);
+                } else {
+                    int inIdx = rci.inputClass->GetIndexFromEnumValue(outCfg->_enumValue);
+                    const ResConfigEntry *inCfg = rci.inputClass->GetEntry(inIdx);
+                    if (inCfg != nullptr && inCfg->_type == outCfg->_type) {
+                        // copy field
+                        const ResEntry *entry = gres.GetEntry(inIdx);
+                        LOG_ASSERT(entry != nullptr);
+                        writeEntry(state, outCfg, entry, fieldSymbol(i, *outCfg), encoder);
+                    }
+                }
+            }
+        }
+        encoder.close();
+    }
+}
+
 DynamicDocsumWriter::DynamicDocsumWriter( ResultConfig *config, KeywordExtractor *extractor)
     : _resultConfig(config),
       _keywordExtractor(extractor),
@@ -319,11 +503,16 @@ DynamicDocsumWriter::InitState(IAttributeManager & attrMan, GetDocsumsState *sta
 uint32_t
 DynamicDocsumWriter::WriteDocsum(uint32_t docid, GetDocsumsState *state, IDocsumStore *docinfos, search::RawBuf *target)
 {
-    vespalib::Slime slime;
-    vespalib::slime::SlimeInserter inserter(slime);
+    BinaryStreamEncoder encoder;
     ResolveClassInfo rci = resolveClassInfo(state->_args.getResultClassName(), docinfos->getSummaryClassId());
-    insertDocsum(rci, docid, state, docinfos, slime, inserter);
-    return slime2RawBuf(slime, *target);
+    if (!rci.mustSkip) {
+        encoder.reset(&rci.outputClass->getSymbols());
+        writeDocsum(rci, docid, state, docinfos, encoder);
+    }
+    if (encoder.empty()) {
+        encoder.writeNix();
+    }
+    return encoder2RawBuf(encoder, *target);
 }
 
 }
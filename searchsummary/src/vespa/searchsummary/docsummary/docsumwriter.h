@@ -14,6 +14,8 @@
 
 using search::IAttributeManager;
 
+namespace vespalib::slime { class BinaryStreamEncoder; }
+
 namespace search::docsummary {
 
 static constexpr uint32_t SLIME_MAGIC_ID = 0x55555555;
@@ -43,7 +45,17 @@ public:
                               IDocsumStore *docinfos, vespalib::Slime & slime, vespalib::slime::Inserter & target) = 0;
     virtual ResolveClassInfo resolveClassInfo(vespalib::stringref outputClassName, uint32_t inputClassId) const = 0;
 
+    /**
+     * Write the docsum directly to the given encoder, without building
+     * a Slime tree. Nothing is written if the docsum can not be produced.
+     * The encoder should be reset with the symbols of the output class.
+     * The default implementation inserts the docsum into a Slime first.
+     **/
+    virtual void writeDocsum(const ResolveClassInfo & rci, uint32_t docid, GetDocsumsState *state,
+                             IDocsumStore *docinfos, vespalib::slime::BinaryStreamEncoder & encoder);
+
     static uint32_t slime2RawBuf(const vespalib::Slime & slime, RawBuf & buf);
+    static uint32_t encoder2RawBuf(const vespalib::slime::BinaryStreamEncoder & encoder, RawBuf & buf);
 };
 
 //--------------------------------------------------------------------------
@@ -80,6 +92,8 @@ public:
 
     void insertDocsum(const ResolveClassInfo & outputClassInfo, uint32_t docid, GetDocsumsState *state,
                       IDocsumStore *docinfos, vespalib::Slime & slime, vespalib::slime::Inserter & target) override;
+    void writeDocsum(const ResolveClassInfo & rci, uint32_t docid, GetDocsumsState *state,
+                     IDocsumStore *docinfos, vespalib::slime::BinaryStreamEncoder & encoder) override;
 
     ResolveClassInfo resolveClassInfo(vespalib::stringref outputClassName, uint32_t inputClassId) const override;
 };
@@ -367,7 +367,7 @@ DynamicTeaserDFW::getJuniperInput(GeneralResult *gres, GetDocsumsState *state) {
     return vespalib::stringref();
 }
 
-vespalib::string
+vespalib::stringref
 DynamicTeaserDFW::makeDynamicTeaser(uint32_t docid, vespalib::stringref input, GetDocsumsState *state)
 {
     if (state->_dynteaser._query == nullptr) {
@@ -428,9 +428,9 @@ DynamicTeaserDFW::makeDynamicTeaser(uint32_t docid, vespalib::stringref input, G
     }
 
     if (teaser != nullptr) {
-        return vespalib::string(teaser->Text(), teaser->Length());
+        return vespalib::stringref(teaser->Text(), teaser->Length());
     } else {
-        return vespalib::string();
+        return vespalib::stringref();
     }
 }
 
@@ -440,8 +440,8 @@ DynamicTeaserDFW::insertField(uint32_t docid, GeneralResult *gres, GetDocsumsSta
 {
     vespalib::stringref input = getJuniperInput(gres, state);
     if (input.length() > 0) {
-        vespalib::string teaser = makeDynamicTeaser(docid, input, state);
-        vespalib::Memory value(teaser.c_str(), teaser.size());
+        vespalib::stringref teaser = makeDynamicTeaser(docid, input, state);
+        vespalib::Memory value(teaser.data(), teaser.size());
         target.insertString(value);
     }
 }
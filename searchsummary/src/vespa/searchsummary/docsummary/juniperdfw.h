@@ -50,9 +50,13 @@ public:
     DynamicTeaserDFW(juniper::Juniper * juniper) : JuniperTeaserDFW(juniper) { }
 
     vespalib::stringref getJuniperInput(GeneralResult *gres, GetDocsumsState *state);
-    vespalib::string makeDynamicTeaser(uint32_t docid,
-                                       vespalib::stringref input,
-                                       GetDocsumsState *state);
+    /**
+     * Returns the teaser for the given document. The returned reference points into the juniper
+     * result cached in the docsum state, and is valid until the next call for another document.
+     **/
+    vespalib::stringref makeDynamicTeaser(uint32_t docid,
+                                          vespalib::stringref input,
+                                          GetDocsumsState *state);
 
     void insertField(uint32_t docid, GeneralResult *gres, GetDocsumsState *state,
                      ResType type, vespalib::slime::Inserter &target) override;
@@ -15,7 +15,8 @@ ResultClass::ResultClass(const char *name, uint32_t id, util::StringEnum & field
       _nameMap(),
       _fieldEnum(fieldEnum),
       _enumMap(),
-      _dynInfo(NULL)
+      _dynInfo(NULL),
+      _symbols()
 { }
 
 
@@ -40,6 +41,9 @@ ResultClass::AddConfigEntry(const char *name, ResType type)
     e._bindname  = name;
     e._enumValue = _fieldEnum.Add(name);
     assert(e._enumValue >= 0);
+    vespalib::slime::Symbol symbol = _symbols.insert(vespalib::Memory(name));
+    assert(symbol.getValue() == _entries.size());
+    (void) symbol;
     _entries.push_back(e);
     return true;
 }
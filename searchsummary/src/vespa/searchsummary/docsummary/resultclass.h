@@ -6,6 +6,7 @@
 #include <vespa/vespalib/stllike/string.h>
 #include <vespa/vespalib/stllike/hash_map.h>
 #include <vespa/searchlib/util/stringenum.h>
+#include <vespa/vespalib/data/slime/symbol_table.h>
 
 namespace search::docsummary {
 
@@ -141,6 +142,7 @@ private:
     util::StringEnum          &_fieldEnum;   // fieldname -> f.n. enum value [SHARED]
     std::vector<int>           _enumMap;     // fieldname enum value -> entry index
     DynamicInfo               *_dynInfo;     // fields overridden and generated
+    vespalib::slime::SymbolTable _symbols;   // field names, symbol value == entry index
 
 public:
     typedef std::unique_ptr<ResultClass> UP;
@@ -202,6 +204,16 @@ public:
     uint32_t GetNumEntries() const { return _entries.size(); }
 
 
+    /**
+     * Obtain the slime symbol table containing the names of the config
+     * entries, where the symbol for a field is the entry index. Used
+     * as preset symbol table when encoding docsums of this class.
+     *
+     * @return symbol table for the field names of this result class.
+     **/
+    const vespalib::slime::SymbolTable &getSymbols() const { return _symbols; }
+
+
     /**
      * Add a config entry to this result class. Each config entry
      * contains the name and type of a field present in the docsum blobs
@@ -17,6 +17,7 @@
 #include <vespa/vespalib/gtest/gtest.h>
 #include <vespa/vespalib/text/stringtokenizer.h>
 #include <vespa/vespalib/util/benchmark_timer.h>
+#include <algorithm>
 #include <sstream>
 #include <iomanip>
 
@@ -1541,6 +1542,55 @@ TEST_F(BucketDBUpdaterTest, pending_cluster_state_receive) {
     EXPECT_EQ(3, (int)pendingTransition.results().size());
 }
 
+TEST_F(BucketDBUpdaterTest, pending_cluster_state_merges_unsorted_replies_into_bucket_db) {
+    DistributorMessageSenderStub sender;
+
+    auto cmd(std::make_shared<api::SetSystemStateCommand>(
+            lib::ClusterState("distributor:1 storage:3")));
+
+    framework::defaultimplementation::FakeClock clock;
+    ClusterInformation::CSP clusterInfo(createClusterInfo("cluster:d"));
+    OutdatedNodesMap outdatedNodesMap;
+    std::unique_ptr<PendingClusterState> state(
+            PendingClusterState::createForClusterStateChange(
+                    clock, clusterInfo, sender, getBucketSpaceRepo(),
+                    cmd, outdatedNodesMap, api::Timestamp(1)));
+
+    ASSERT_EQ(messageCount(3), sender.commands().size());
+    sortSentMessagesByIndex(sender);
+
+    for (uint32_t i = 0; i < sender.commands().size(); i++) {
+        auto* req = dynamic_cast<RequestBucketInfoCommand*>(sender.command(i).get());
+        ASSERT_TRUE(req != nullptr);
+        auto rep = std::make_shared<RequestBucketInfoReply>(*req);
+        // All nodes have the same buckets, each node replies in its own order
+        for (uint32_t j = 0; j < 10; ++j) {
+            uint32_t bucket = (j * 7 + i) % 10;
+            rep->getBucketInfo().push_back(
+                    RequestBucketInfoReply::Entry(
+                            document::BucketId(16, bucket),
+                            api::BucketInfo(bucket + 1, 1, 1)));
+        }
+        ASSERT_TRUE(state->onRequestBucketInfoReply(rep));
+    }
+    auto& pendingTransition = state->getPendingBucketSpaceDbTransition(makeBucketSpace());
+    // Entries added one at a time are sorted as a single run
+    pendingTransition.addNodeInfo(document::BucketId(16, 12), BucketCopy(1, 0, api::BucketInfo(13, 1, 1)));
+    pendingTransition.addNodeInfo(document::BucketId(16, 10), BucketCopy(1, 0, api::BucketInfo(11, 1, 1)));
+    pendingTransition.addNodeInfo(document::BucketId(16, 11), BucketCopy(1, 0, api::BucketInfo(12, 1, 1)));
+    state->mergeIntoBucketDatabases();
+
+    const auto& results = pendingTransition.results();
+    EXPECT_EQ(33u, results.size());
+    EXPECT_TRUE(std::is_sorted(results.begin(), results.end()));
+    for (uint32_t bucket = 0; bucket < 13; ++bucket) {
+        BucketDatabase::Entry e(getBucketDatabase().get(document::BucketId(16, bucket)));
+        ASSERT_TRUE(e.valid());
+        EXPECT_EQ((bucket < 10) ? 3u : 1u, e->getNodeCount());
+        EXPECT_EQ(bucket + 1, e->getNodeRef(0).getChecksum());
+    }
+}
+
 TEST_F(BucketDBUpdaterTest, pending_cluster_state_with_group_down) {
     std::string config(getDistConfig6Nodes4Groups());
     config += "distributor_auto_ownership_transfer_on_whole_group_down true\n";
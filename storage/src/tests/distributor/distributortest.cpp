@@ -13,6 +13,7 @@
 #include <vespa/storage/config/config-stor-distributormanager.h>
 #include <vespa/storage/distributor/distributor.h>
 #include <vespa/vespalib/text/stringtokenizer.h>
+#include <vespa/vespalib/util/stringfmt.h>
 #include <vespa/vespalib/util/time.h>
 #include <thread>
 #include <vespa/vespalib/gtest/gtest.h>
@@ -1050,6 +1051,37 @@ TEST_F(DistributorTest, gets_are_started_outside_main_distributor_logic_if_btree
     EXPECT_THAT(_sender.replies(), SizeIs(1));
 }
 
+TEST_F(DistributorTest, replies_for_gets_started_outside_main_thread_are_routed_to_owning_stripe) {
+    createLinks(true);
+    setupDistributor(Redundancy(1), NodeCount(1), "distributor:1 storage:1");
+    configure_stale_reads_enabled(true);
+
+    // Users 1-8 have different lowest location bits and end up in different stripes
+    constexpr uint32_t num_users = 8;
+    for (uint32_t user = 1; user <= num_users; ++user) {
+        addNodesToBucketDB(document::BucketId(16, user), "0=1/1/1/t");
+    }
+    for (uint32_t user = 1; user <= num_users; ++user) {
+        _distributor->onDown(std::make_shared<api::GetCommand>(
+                makeDocumentBucket(document::BucketId(0)),
+                document::DocumentId(vespalib::make_string("id:foo:testdoctype1:n=%u:foo", user)),
+                "[all]"));
+    }
+    ASSERT_THAT(_sender.commands(), SizeIs(num_users));
+    EXPECT_THAT(_sender.replies(), SizeIs(0));
+
+    // Reply in reverse order so no reply relies on the order of operations within a stripe
+    for (uint32_t i = num_users; i > 0; --i) {
+        auto reply = std::shared_ptr<api::StorageReply>(_sender.command(i - 1)->makeReply());
+        _distributor->onDown(reply);
+    }
+    ASSERT_THAT(_sender.commands(), SizeIs(num_users));
+    ASSERT_THAT(_sender.replies(), SizeIs(num_users));
+    for (uint32_t i = 0; i < num_users; ++i) {
+        EXPECT_EQ(api::MessageType::GET_REPLY, _sender.reply(i)->getType());
+    }
+}
+
 TEST_F(DistributorTest, gets_are_not_started_outside_main_distributor_logic_if_stale_reads_disabled) {
     set_up_and_start_get_op_with_stale_reads_enabled(false);
     // Get has been placed into distributor queue, so no external messages are produced.
@@ -77,6 +77,31 @@ TEST(SimpleBucketPriorityDatabaseTest, no_maintenance_needed_clears_bucket_from_
     ASSERT_TRUE(iter == queue.end());
 }
 
+TEST(SimpleBucketPriorityDatabaseTest, reprioritizing_bucket_keeps_other_buckets_at_same_priority) {
+    SimpleBucketPriorityDatabase queue;
+
+    PrioritizedBucket lowPriBucket(makeDocumentBucket(BucketId(16, 1)), Priority::LOW);
+    PrioritizedBucket reprioritizedBucket(makeDocumentBucket(BucketId(16, 2)), Priority::LOW);
+    queue.setPriority(lowPriBucket);
+    queue.setPriority(reprioritizedBucket);
+    reprioritizedBucket = PrioritizedBucket(makeDocumentBucket(BucketId(16, 2)), Priority::HIGH);
+    queue.setPriority(reprioritizedBucket);
+
+    auto iter = queue.begin();
+    ASSERT_EQ(reprioritizedBucket, *iter);
+    ++iter;
+    ASSERT_TRUE(iter != queue.end());
+    ASSERT_EQ(lowPriBucket, *iter);
+    ++iter;
+    ASSERT_TRUE(iter == queue.end());
+
+    queue.setPriority(PrioritizedBucket(makeDocumentBucket(BucketId(16, 1)), Priority::NO_MAINTENANCE_NEEDED));
+    auto iter2 = queue.begin();
+    ASSERT_EQ(reprioritizedBucket, *iter2);
+    ++iter2;
+    ASSERT_TRUE(iter2 == queue.end());
+}
+
 TEST(SimpleBucketPriorityDatabaseTest, iterate_over_multiple_buckets_with_multiple_priorities) {
     SimpleBucketPriorityDatabase queue;
 
@@ -60,10 +60,14 @@ ExternalOperationHandler::ExternalOperationHandler(Distributor& owner,
       _direct_dispatch_sender(std::make_unique<DirectDispatchSender>(owner)),
       _operationGenerator(gen),
       _rejectFeedBeforeTimeReached(), // At epoch
-      _non_main_thread_ops_mutex(),
-      _non_main_thread_ops_owner(*_direct_dispatch_sender, getClock()),
+      _non_main_thread_ops_stripes(),
       _concurrent_gets_enabled(false)
 {
+    _non_main_thread_ops_stripes.reserve(1u << NonMainThreadOpsStripeBits);
+    for (uint32_t i = 0; i < (1u << NonMainThreadOpsStripeBits); ++i) {
+        _non_main_thread_ops_stripes.emplace_back(
+                std::make_unique<NonMainThreadOpsStripe>(*_direct_dispatch_sender, getClock()));
+    }
 }
 
 ExternalOperationHandler::~ExternalOperationHandler() = default;
@@ -77,10 +81,30 @@ ExternalOperationHandler::handleMessage(const std::shared_ptr<api::StorageMessag
     return retVal;
 }
 
+ExternalOperationHandler::NonMainThreadOpsStripe::NonMainThreadOpsStripe(DistributorMessageSender& sender,
+                                                                         const framework::Clock& clock)
+    : _mutex(),
+      _owner(sender, clock)
+{
+}
+
+ExternalOperationHandler::NonMainThreadOpsStripe::~NonMainThreadOpsStripe() = default;
+
+ExternalOperationHandler::NonMainThreadOpsStripe&
+ExternalOperationHandler::non_main_thread_ops_stripe_of(const document::DocumentId& id) {
+    // The bucket of a client Get is not set, and replies carry whatever bucket the
+    // content node was asked about, so the stripe is chosen by the lowest location
+    // bits of the document itself. Both the command and its replies map to it.
+    const uint64_t mask = (1u << NonMainThreadOpsStripeBits) - 1;
+    return *_non_main_thread_ops_stripes[getBucketId(id).getRawId() & mask];
+}
+
 void ExternalOperationHandler::close_pending() {
-    std::lock_guard g(_non_main_thread_ops_mutex);
     // Make sure we drain any pending operations upon close.
-    _non_main_thread_ops_owner.onClose();
+    for (auto& stripe : _non_main_thread_ops_stripes) {
+        std::lock_guard g(stripe->_mutex);
+        stripe->_owner.onClose();
+    }
 }
 
 api::ReturnCode
@@ -395,19 +419,23 @@ bool ExternalOperationHandler::try_handle_message_outside_main_thread(const std:
         if (!concurrent_gets_enabled()) {
             return false;
         }
-        auto op = try_generate_get_operation(std::dynamic_pointer_cast<api::GetCommand>(msg));
+        auto cmd = std::dynamic_pointer_cast<api::GetCommand>(msg);
+        auto op = try_generate_get_operation(cmd);
         if (op) {
-            std::lock_guard g(_non_main_thread_ops_mutex);
-            _non_main_thread_ops_owner.start(std::move(op), msg->getPriority());
+            auto& stripe = non_main_thread_ops_stripe_of(cmd->getDocumentId());
+            std::lock_guard g(stripe._mutex);
+            stripe._owner.start(std::move(op), msg->getPriority());
         }
         return true;
     } else if (type_id == api::MessageType::GET_REPLY_ID) {
-        std::lock_guard g(_non_main_thread_ops_mutex);
+        auto reply = std::dynamic_pointer_cast<api::GetReply>(msg);
         // The Get for which this reply was created may have been sent by someone outside
         // the ExternalOperationHandler, such as TwoPhaseUpdateOperation. Pass it on if so.
         // It is undefined which thread actually invokes this, so mutex protection of reply
         // handling is crucial!
-        return _non_main_thread_ops_owner.handleReply(std::dynamic_pointer_cast<api::StorageReply>(msg));
+        auto& stripe = non_main_thread_ops_stripe_of(reply->getDocumentId());
+        std::lock_guard g(stripe._mutex);
+        return stripe._owner.handleReply(reply);
     }
     return false;
 }
@@ -10,6 +10,7 @@
 #include <atomic>
 #include <chrono>
 #include <mutex>
+#include <vector>
 
 namespace storage {
 
@@ -72,10 +73,24 @@ private:
     OperationSequencer _mutationSequencer;
     Operation::SP _op;
     TimePoint _rejectFeedBeforeTimeReached;
-    mutable std::mutex _non_main_thread_ops_mutex;
-    OperationOwner _non_main_thread_ops_owner;
+    /*
+     * Operations started outside the main distributor thread are spread
+     * across stripes keyed by the lowest location bits of the document,
+     * so that concurrent Gets for different superbuckets do not contend
+     * on a single mutex.
+     */
+    struct NonMainThreadOpsStripe {
+        std::mutex     _mutex;
+        OperationOwner _owner;
+        NonMainThreadOpsStripe(DistributorMessageSender& sender, const framework::Clock& clock);
+        ~NonMainThreadOpsStripe();
+    };
+    static constexpr uint32_t NonMainThreadOpsStripeBits = 3;
+    std::vector<std::unique_ptr<NonMainThreadOpsStripe>> _non_main_thread_ops_stripes;
     std::atomic<bool> _concurrent_gets_enabled;
 
+    NonMainThreadOpsStripe& non_main_thread_ops_stripe_of(const document::DocumentId& id);
+
     template <typename Func>
     void bounce_or_invoke_read_only_op(api::StorageCommand& cmd,
                                        const document::Bucket& bucket,
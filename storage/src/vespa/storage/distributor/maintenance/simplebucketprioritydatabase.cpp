@@ -1,11 +1,18 @@
 // Copyright 2017 Yahoo Holdings. Licensed under the terms of the Apache 2.0 license. See LICENSE in the project root.
 
 #include "simplebucketprioritydatabase.h"
+#include <vespa/vespalib/stllike/hash_map.hpp>
 #include <iostream>
 #include <sstream>
 
 namespace storage::distributor {
 
+SimpleBucketPriorityDatabase::SimpleBucketPriorityDatabase()
+    : _prioritizedBuckets(),
+      _bucketPriorities()
+{
+}
+
 SimpleBucketPriorityDatabase::~SimpleBucketPriorityDatabase()
 {
 }
@@ -13,13 +20,16 @@ SimpleBucketPriorityDatabase::~SimpleBucketPriorityDatabase()
 void
 SimpleBucketPriorityDatabase::clearAllEntriesForBucket(const document::Bucket &bucket)
 {
-    for (PriorityMap::iterator priIter(_prioritizedBuckets.begin()),
-             priEnd(_prioritizedBuckets.end());
-         priIter != priEnd;
-         ++priIter)
-    {
-        priIter->second.erase(bucket);
+    auto indexIter = _bucketPriorities.find(bucket);
+    if (indexIter == _bucketPriorities.end()) {
+        return;
+    }
+    auto priIter = _prioritizedBuckets.find(indexIter->second);
+    priIter->second.erase(bucket);
+    if (priIter->second.empty()) {
+        _prioritizedBuckets.erase(priIter);
     }
+    _bucketPriorities.erase(indexIter);
 }
 
 void
@@ -28,6 +38,7 @@ SimpleBucketPriorityDatabase::setPriority(const PrioritizedBucket& bucket)
     clearAllEntriesForBucket(bucket.getBucket());
     if (bucket.requiresMaintenance()) {
         _prioritizedBuckets[bucket.getPriority()].insert(bucket.getBucket());
+        _bucketPriorities[bucket.getBucket()] = bucket.getPriority();
     }
 }
 
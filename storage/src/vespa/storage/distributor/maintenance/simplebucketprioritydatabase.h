@@ -2,6 +2,7 @@
 #pragma once
 
 #include "bucketprioritydatabase.h"
+#include <vespa/vespalib/stllike/hash_map.h>
 #include <set>
 #include <map>
 
@@ -11,6 +12,7 @@ namespace distributor {
 class SimpleBucketPriorityDatabase : public BucketPriorityDatabase
 {
 public:
+    SimpleBucketPriorityDatabase();
     virtual ~SimpleBucketPriorityDatabase();
     typedef PrioritizedBucket::Priority Priority;
 
@@ -23,6 +25,7 @@ public:
 private:
     typedef std::set<document::Bucket> BucketSet;
     typedef std::map<Priority, BucketSet> PriorityMap;
+    typedef vespalib::hash_map<document::Bucket, Priority, document::Bucket::hash> BucketPriorityIndex;
 
     class SimpleConstIteratorImpl : public ConstIteratorImpl
     {
@@ -59,6 +62,10 @@ private:
     void clearAllEntriesForBucket(const document::Bucket &bucket);
 
     PriorityMap _prioritizedBuckets;
+    // Current priority of each bucket in _prioritizedBuckets, avoids
+    // looking for the bucket in every priority when it is reprioritized.
+    // Entries are kept in a flat node vector, not one heap node each.
+    BucketPriorityIndex _bucketPriorities;
 };
 
 }
@@ -24,6 +24,7 @@ PendingBucketSpaceDbTransition::PendingBucketSpaceDbTransition(const PendingClus
                                                                const lib::ClusterState &newClusterState,
                                                                api::Timestamp creationTimestamp)
     : _entries(),
+      _sortedRunEnds(),
       _iter(0),
       _removedBuckets(),
       _missingEntries(),
@@ -227,23 +228,61 @@ PendingBucketSpaceDbTransition::addToInserter(BucketDatabase::TrailingInserter&
     inserter.insert_at_end(e);
 }
 
+void
+PendingBucketSpaceDbTransition::closeUnsortedRun()
+{
+    size_t runStart = sortedEnd();
+    if (runStart < _entries.size()) {
+        std::sort(_entries.begin() + runStart, _entries.end());
+        _sortedRunEnds.push_back(_entries.size());
+    }
+}
+
+void
+PendingBucketSpaceDbTransition::mergeSortedRuns()
+{
+    closeUnsortedRun();
+    // Pairwise merge of neighbouring runs, halving the number of runs in each pass.
+    while (_sortedRunEnds.size() > 1) {
+        std::vector<size_t> mergedRunEnds;
+        mergedRunEnds.reserve((_sortedRunEnds.size() + 1) / 2);
+        size_t runStart = 0;
+        for (size_t i = 0; i < _sortedRunEnds.size(); i += 2) {
+            if (i + 1 < _sortedRunEnds.size()) {
+                std::inplace_merge(_entries.begin() + runStart,
+                                   _entries.begin() + _sortedRunEnds[i],
+                                   _entries.begin() + _sortedRunEnds[i + 1]);
+                runStart = _sortedRunEnds[i + 1];
+            } else {
+                runStart = _sortedRunEnds[i];
+            }
+            mergedRunEnds.push_back(runStart);
+        }
+        _sortedRunEnds.swap(mergedRunEnds);
+    }
+}
+
 void
 PendingBucketSpaceDbTransition::mergeIntoBucketDatabase()
 {
     BucketDatabase &db(_distributorBucketSpace.getBucketDatabase());
-    std::sort(_entries.begin(), _entries.end());
+    mergeSortedRuns();
     db.merge(*this);
 }
 
 void
 PendingBucketSpaceDbTransition::onRequestBucketInfoReply(const api::RequestBucketInfoReply &reply, uint16_t node)
 {
+    // Each reply is sorted when it arrives, so that only a merge of the
+    // sorted runs remains when the pending cluster state is activated.
+    closeUnsortedRun();
     for (const auto &entry : reply.getBucketInfo()) {
         _entries.emplace_back(entry._bucketId,
                               BucketCopy(_creationTimestamp,
                                          node,
                                          entry._info));
     }
+    closeUnsortedRun();
 }
 
 bool
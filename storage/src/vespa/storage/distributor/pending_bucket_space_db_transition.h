@@ -30,6 +30,10 @@ private:
     using Range = std::pair<uint32_t, uint32_t>;
 
     EntryList                                 _entries;
+    // End offsets of the sorted runs in _entries, one run per reply. Entries
+    // after the last run (added by addNodeInfo) are sorted as a single run
+    // when the next reply arrives or when merging.
+    std::vector<size_t>                       _sortedRunEnds;
     uint32_t                                  _iter;
     std::vector<document::BucketId>           _removedBuckets;
     std::vector<Range>                        _missingEntries;
@@ -61,6 +65,10 @@ private:
      */
     Range skipAllForSameBucket();
 
+    size_t sortedEnd() const { return _sortedRunEnds.empty() ? 0 : _sortedRunEnds.back(); }
+    void closeUnsortedRun();
+    void mergeSortedRuns();
+
     std::vector<BucketCopy> getCopiesThatAreNewOrAltered(BucketDatabase::Entry& info, const Range& range);
     void insertInfo(BucketDatabase::Entry& info, const Range& range);
     void addToMerger(BucketDatabase::Merger& merger, const Range& range);
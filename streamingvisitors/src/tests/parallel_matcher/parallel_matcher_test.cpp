@@ -0,0 +1,251 @@
+// Copyright 2019 Oath Inc. Licensed under the terms of the Apache 2.0 license. See LICENSE in the project root.
+
+#include <vespa/document/base/documentid.h>
+#include <vespa/document/datatype/documenttype.h>
+#include <vespa/document/fieldvalue/document.h>
+#include <vespa/document/fieldvalue/stringfieldvalue.h>
+#include <vespa/searchlib/query/tree/querybuilder.h>
+#include <vespa/searchlib/query/tree/simplequery.h>
+#include <vespa/searchlib/query/tree/stackdumpcreator.h>
+#include <vespa/searchlib/query/streaming/query.h>
+#include <vespa/searchvisitor/parallel_matcher.h>
+#include <vespa/searchvisitor/querytermdata.h>
+#include <vespa/vsm/common/storagedocument.h>
+#include <vespa/vsm/vsm/fieldsearchspec.h>
+#include <vespa/vespalib/gtest/gtest.h>
+#include <vespa/vespalib/util/stringfmt.h>
+#include <vespa/vespalib/util/threadstackexecutor.h>
+
+using document::DataType;
+using document::DocumentId;
+using document::DocumentType;
+using document::Field;
+using document::StringFieldValue;
+using search::query::QueryBuilder;
+using search::query::SimpleQueryNodeTypes;
+using search::query::StackDumpCreator;
+using search::query::Weight;
+using search::streaming::Query;
+using search::streaming::QueryTermList;
+using streaming::ParallelMatcher;
+using streaming::QueryTermDataFactory;
+using vespa::config::search::vsm::VsmfieldsConfigBuilder;
+using vsm::FieldIdTSearcherMap;
+using vsm::FieldPathMapT;
+using vsm::FieldSearchSpecMap;
+using vsm::SearcherBuf;
+using vsm::SharedFieldPathMap;
+using vsm::SharedSearcherBuf;
+using vsm::StorageDocument;
+using vsm::StringFieldIdTMap;
+
+using State = ParallelMatcher::Result::State;
+using Results = std::vector<ParallelMatcher::Result>;
+
+namespace {
+
+const vespalib::string doc_type_name("test");
+const vespalib::string field_name("title");
+
+vsm::VsmfieldsHandle make_fields_config() {
+    VsmfieldsConfigBuilder builder;
+    builder.fieldspec.resize(1);
+    builder.fieldspec[0].name = field_name;
+    builder.documenttype.resize(1);
+    builder.documenttype[0].name = doc_type_name;
+    builder.documenttype[0].index.resize(1);
+    builder.documenttype[0].index[0].name = field_name;
+    builder.documenttype[0].index[0].field.resize(1);
+    builder.documenttype[0].index[0].field[0].name = field_name;
+    return std::make_shared<VsmfieldsConfig>(builder);
+}
+
+vespalib::string make_query_blob() {
+    // title:foo OR (title:bar AND title:baz)
+    QueryBuilder<SimpleQueryNodeTypes> builder;
+    builder.addOr(2);
+    builder.addStringTerm("foo", field_name, 0, Weight(100));
+    builder.addAnd(2);
+    builder.addStringTerm("bar", field_name, 1, Weight(100));
+    builder.addStringTerm("baz", field_name, 2, Weight(100));
+    return StackDumpCreator::create(*builder.build());
+}
+
+vespalib::string make_title(size_t i) {
+    switch (i % 4) {
+    case 0: return "foo";
+    case 1: return "bar xyzzy baz";
+    case 2: return "bar only";
+    default: return "nothing to see here";
+    }
+}
+
+bool expect_match(size_t i) {
+    return (i % 4) < 2;
+}
+
+struct Fixture {
+    Field                            field;
+    DocumentType                     doc_type;
+    FieldSearchSpecMap               spec_map;
+    vespalib::string                 query_blob;
+    StringFieldIdTMap                fields_in_query;
+    SharedFieldPathMap               field_path_map;
+    std::vector<StorageDocument::UP> docs;
+
+    Fixture();
+    ~Fixture();
+    void add_docs(size_t num_docs);
+    std::vector<StorageDocument *> doc_ptrs() const;
+    Results match_serial();
+    Results match_parallel(uint32_t num_contexts, size_t min_docs_per_context);
+};
+
+Fixture::Fixture()
+    : field(field_name, 1, *DataType::STRING, true),
+      doc_type(doc_type_name),
+      spec_map(),
+      query_blob(make_query_blob()),
+      fields_in_query(),
+      field_path_map(std::make_shared<FieldPathMapT>()),
+      docs()
+{
+    doc_type.addField(field);
+    spec_map.buildFromConfig(make_fields_config());
+    QueryTermDataFactory factory;
+    Query query(factory, query_blob);
+    spec_map.reconfigFromQuery(query);
+    spec_map.buildFieldsInQuery(query, fields_in_query);
+    field_path_map->resize(fields_in_query.highestFieldNo());
+    for (const auto & field_id : fields_in_query.map()) {
+        doc_type.buildFieldPath((*field_path_map)[field_id.second], field_id.first);
+    }
+}
+
+Fixture::~Fixture() = default;
+
+void
+Fixture::add_docs(size_t num_docs)
+{
+    for (size_t i = 0; i < num_docs; ++i) {
+        auto doc = std::make_unique<document::Document>(doc_type, DocumentId(vespalib::make_string("id:ns:test::%zu", i)));
+        doc->setValue(field, StringFieldValue(make_title(i)));
+        docs.push_back(std::make_unique<StorageDocument>(std::move(doc), field_path_map,
+                                                         fields_in_query.highestFieldNo()));
+    }
+}
+
+std::vector<StorageDocument *>
+Fixture::doc_ptrs() const
+{
+    std::vector<StorageDocument *> result;
+    for (const auto & doc : docs) {
+        result.push_back(doc.get());
+    }
+    return result;
+}
+
+Results
+Fixture::match_serial()
+{
+    // Matches the documents one by one the way the search visitor does without parallel matching
+    QueryTermDataFactory factory;
+    Query query(factory, query_blob);
+    QueryTermList leafs;
+    query.getLeafs(leafs);
+    FieldIdTSearcherMap searchers;
+    SharedSearcherBuf buf(new SearcherBuf());
+    spec_map.buildSearcherMap(fields_in_query.map(), searchers);
+    searchers.prepare(spec_map.documentTypeMap(), buf, query);
+    Results results(docs.size());
+    for (size_t i = 0; i < docs.size(); ++i) {
+        for (auto & searcher : searchers) {
+            searcher->search(*docs[i]);
+        }
+        if (query.evaluate()) {
+            results[i].state = State::MATCH;
+            for (const auto & leaf : leafs) {
+                results[i].terms.emplace_back();
+                results[i].terms.back().hits = leaf->getHitList();
+            }
+        }
+        query.reset();
+    }
+    return results;
+}
+
+Results
+Fixture::match_parallel(uint32_t num_contexts, size_t min_docs_per_context)
+{
+    vespalib::ThreadStackExecutor executor(num_contexts - 1, 128 * 1024);
+    ParallelMatcher matcher(executor, num_contexts, min_docs_per_context,
+                            search::QueryPacketT(query_blob.data(), query_blob.size()), spec_map, fields_in_query);
+    EXPECT_TRUE(matcher.useParallel(docs.size()));
+    Results results;
+    matcher.match(doc_ptrs(), results);
+    return results;
+}
+
+void
+expect_equal_results(const Results & expected, const Results & actual)
+{
+    ASSERT_EQ(expected.size(), actual.size());
+    for (size_t i = 0; i < expected.size(); ++i) {
+        SCOPED_TRACE(vespalib::make_string("doc %zu", i));
+        EXPECT_TRUE(expected[i].state == actual[i].state);
+        ASSERT_EQ(expected[i].terms.size(), actual[i].terms.size());
+        for (size_t t = 0; t < expected[i].terms.size(); ++t) {
+            const auto & expected_hits = expected[i].terms[t].hits;
+            const auto & actual_hits = actual[i].terms[t].hits;
+            ASSERT_EQ(expected_hits.size(), actual_hits.size());
+            for (size_t h = 0; h < expected_hits.size(); ++h) {
+                EXPECT_EQ(expected_hits[h].wordpos(), actual_hits[h].wordpos());
+                EXPECT_EQ(expected_hits[h].weight(), actual_hits[h].weight());
+            }
+        }
+    }
+}
+
+}
+
+TEST(ParallelMatcherTest, serial_matching_finds_expected_documents)
+{
+    Fixture f;
+    f.add_docs(40);
+    Results results = f.match_serial();
+    for (size_t i = 0; i < results.size(); ++i) {
+        EXPECT_EQ(expect_match(i), results[i].state == State::MATCH) << "doc " << i;
+    }
+}
+
+TEST(ParallelMatcherTest, parallel_matching_gives_same_hits_as_serial_matching)
+{
+    Fixture f;
+    f.add_docs(40);
+    Results expected = f.match_serial();
+    expect_equal_results(expected, f.match_parallel(4, 2));
+    // Uneven split, with the last match context getting fewer documents
+    expect_equal_results(expected, f.match_parallel(3, 7));
+}
+
+TEST(ParallelMatcherTest, missing_documents_do_not_match)
+{
+    Fixture f;
+    f.add_docs(8);
+    vespalib::ThreadStackExecutor executor(1, 128 * 1024);
+    ParallelMatcher matcher(executor, 2, 2, search::QueryPacketT(f.query_blob.data(), f.query_blob.size()),
+                            f.spec_map, f.fields_in_query);
+    std::vector<StorageDocument *> docs = f.doc_ptrs();
+    docs[0] = nullptr;
+    docs[5] = nullptr;
+    Results results;
+    matcher.match(docs, results);
+    ASSERT_EQ(8u, results.size());
+    for (size_t i = 0; i < results.size(); ++i) {
+        bool match = (docs[i] != nullptr) && expect_match(i);
+        EXPECT_EQ(match, results[i].state == State::MATCH) << "doc " << i;
+        EXPECT_EQ(match ? 3u : 0u, results[i].terms.size()) << "doc " << i;
+    }
+}
+
+GTEST_MAIN_RUN_ALL_TESTS()
@@ -29,8 +29,9 @@ private:
     std::unique_ptr<StorageComponent> _component;
     SearchEnvironment                 _env;
     void testSearchVisitor();
+    void testSearchVisitorWithParallelMatching();
     void testSearchEnvironment();
-    void testCreateSearchVisitor(const vespalib::string & dir, const vdslib::Parameters & parameters);
+    void testCreateSearchVisitor(const vespalib::string & dir, const vdslib::Parameters & parameters, size_t numDocs = 1);
     void testOnlyRequireWeakReadConsistency();
 
 public:
@@ -54,25 +55,27 @@ SearchVisitorTest::SearchVisitorTest() :
 SearchVisitorTest::~SearchVisitorTest() = default;
 
 std::vector<spi::DocEntry::UP>
-createDocuments(const vespalib::string & dir)
+createDocuments(const vespalib::string & dir, size_t numDocs)
 {
     (void) dir;
     std::vector<spi::DocEntry::UP> documents;
     spi::Timestamp ts;
-    document::Document::UP doc(new document::Document());
-    spi::DocEntry::UP e(new spi::DocEntry(ts, 0, std::move(doc)));
-    documents.push_back(std::move(e));
+    for (size_t i(0); i < numDocs; ++i) {
+        document::Document::UP doc(new document::Document());
+        spi::DocEntry::UP e(new spi::DocEntry(ts, 0, std::move(doc)));
+        documents.push_back(std::move(e));
+    }
     return documents;
 }
 
 void
-SearchVisitorTest::testCreateSearchVisitor(const vespalib::string & dir, const vdslib::Parameters & params)
+SearchVisitorTest::testCreateSearchVisitor(const vespalib::string & dir, const vdslib::Parameters & params, size_t numDocs)
 {
     SearchVisitorFactory sFactory(dir);
     VisitorFactory & factory(sFactory);
     std::unique_ptr<Visitor> sv(static_cast<SearchVisitor *>(factory.makeVisitor(*_component, _env, params)));
     document::BucketId bucketId;
-    std::vector<spi::DocEntry::UP> documents(createDocuments(dir));
+    std::vector<spi::DocEntry::UP> documents(createDocuments(dir, numDocs));
     Visitor::HitCounter hitCounter;
     sv->handleDocuments(bucketId, documents, hitCounter);
 }
@@ -103,6 +106,26 @@ SearchVisitorTest::testSearchVisitor()
     testCreateSearchVisitor("dir:" + TEST_PATH("cfg"), params);
 }
 
+void
+SearchVisitorTest::testSearchVisitorWithParallelMatching()
+{
+    vdslib::Parameters params;
+    params.set("searchcluster", "aaa");
+    params.set("summarycount", "3");
+    params.set("summaryclass", "petra");
+    params.set("rankprofile", "default");
+    params.set("matchthreads", "4");
+    params.set("matchminblocksize", "2");
+
+    QueryBuilder<SimpleQueryNodeTypes> builder;
+    builder.addStringTerm("maptest", "sddocname", 0, Weight(0));
+    Node::UP node = builder.build();
+    vespalib::string stackDump = StackDumpCreator::create(*node);
+
+    params.set("query", stackDump);
+    testCreateSearchVisitor("dir:" + TEST_PATH("cfg"), params, 16);
+}
+
 void
 SearchVisitorTest::testOnlyRequireWeakReadConsistency()
 {
@@ -119,6 +142,7 @@ SearchVisitorTest::Main()
     TEST_INIT("searchvisitor_test");
 
     testSearchVisitor(); TEST_FLUSH();
+    testSearchVisitorWithParallelMatching(); TEST_FLUSH();
     testSearchEnvironment(); TEST_FLUSH();
     testOnlyRequireWeakReadConsistency(); TEST_FLUSH();
 
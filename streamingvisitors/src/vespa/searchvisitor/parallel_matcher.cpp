@@ -0,0 +1,144 @@
+// Copyright 2019 Oath Inc. Licensed under the terms of the Apache 2.0 license. See LICENSE in the project root.
+
+#include "parallel_matcher.h"
+#include "querytermdata.h"
+#include <vespa/vsm/common/storagedocument.h>
+#include <vespa/vespalib/util/count_down_latch.h>
+#include <vespa/vespalib/util/lambdatask.h>
+#include <vespa/vespalib/util/threadexecutor.h>
+#include <cassert>
+
+#include <vespa/log/log.h>
+LOG_SETUP(".visitor.instance.parallel_matcher");
+
+using search::streaming::Hit;
+using search::streaming::Query;
+using search::streaming::QueryTerm;
+using search::streaming::QueryTermList;
+using vsm::StorageDocument;
+
+namespace streaming {
+
+ParallelMatcher::MatchContext::MatchContext(const search::QueryPacketT & queryBlob,
+                                            vsm::FieldSearchSpecMap & fieldSearchSpecMap,
+                                            const vsm::StringFieldIdTMap & fieldsInQuery)
+    : _query(),
+      _leafs(),
+      _fieldSearcherMap(),
+      _searchBuffer(new vsm::SearcherBuf())
+{
+    QueryTermDataFactory addOnFactory;
+    _query = Query(addOnFactory, queryBlob);
+    _query.getLeafs(_leafs);
+    _searchBuffer->reserve(0x10000);
+    fieldSearchSpecMap.buildSearcherMap(fieldsInQuery.map(), _fieldSearcherMap);
+    _fieldSearcherMap.prepare(fieldSearchSpecMap.documentTypeMap(), _searchBuffer, _query);
+}
+
+ParallelMatcher::MatchContext::~MatchContext() = default;
+
+bool
+ParallelMatcher::MatchContext::match(const StorageDocument & doc, Result & result)
+{
+    for (vsm::FieldSearcherContainer & fSearch : _fieldSearcherMap) {
+        fSearch->search(doc);
+    }
+    bool hit(_query.evaluate());
+    if (hit) {
+        result.terms.resize(_leafs.size());
+        for (size_t i(0); i < _leafs.size(); ++i) {
+            const QueryTerm & term = *_leafs[i];
+            TermMatch & termMatch = result.terms[i];
+            termMatch.hits = term.getHitList();
+            termMatch.fieldInfo.clear();
+            termMatch.fieldInfo.reserve(term.getFieldInfoSize());
+            for (size_t fid(0); fid < term.getFieldInfoSize(); ++fid) {
+                termMatch.fieldInfo.push_back(term.getFieldInfo(fid));
+            }
+        }
+    }
+    _query.reset();
+    return hit;
+}
+
+void
+ParallelMatcher::MatchContext::match(const std::vector<StorageDocument *> & docs, size_t begin, size_t end,
+                                     std::vector<Result> & result)
+{
+    for (size_t i(begin); i < end; ++i) {
+        try {
+            bool hit = (docs[i] != nullptr) && match(*docs[i], result[i]);
+            result[i].state = hit ? Result::State::MATCH : Result::State::NO_MATCH;
+        } catch (const std::exception & e) {
+            // Let the visitor thread redo this document and report the problem.
+            LOG(debug, "Caught exception matching document in parallel. Exception='%s'", e.what());
+            _query.reset();
+            result[i].state = Result::State::UNKNOWN;
+            result[i].terms.clear();
+        }
+    }
+}
+
+void
+ParallelMatcher::apply(const Result & result, const QueryTermList & leafs)
+{
+    assert(result.terms.size() == leafs.size());
+    for (size_t i(0); i < leafs.size(); ++i) {
+        QueryTerm & term = *leafs[i];
+        const TermMatch & termMatch = result.terms[i];
+        for (const Hit & hit : termMatch.hits) {
+            term.add(hit.wordpos(), hit.context(), hit.elemId(), hit.weight());
+        }
+        if ( ! termMatch.fieldInfo.empty()) {
+            term.resizeFieldId(termMatch.fieldInfo.size() - 1);
+        }
+        for (size_t fid(0); fid < termMatch.fieldInfo.size(); ++fid) {
+            term.getFieldInfo(fid) = termMatch.fieldInfo[fid];
+        }
+    }
+}
+
+ParallelMatcher::ParallelMatcher(vespalib::ThreadExecutor & executor, uint32_t numContexts, size_t minDocsPerContext,
+                                 const search::QueryPacketT & queryBlob, vsm::FieldSearchSpecMap & fieldSearchSpecMap,
+                                 const vsm::StringFieldIdTMap & fieldsInQuery)
+    : _executor(executor),
+      _contexts(),
+      _minDocsPerContext(std::max(minDocsPerContext, size_t(1)))
+{
+    assert(numContexts > 0);
+    _contexts.reserve(numContexts);
+    for (uint32_t i(0); i < numContexts; ++i) {
+        _contexts.push_back(std::make_unique<MatchContext>(queryBlob, fieldSearchSpecMap, fieldsInQuery));
+    }
+}
+
+ParallelMatcher::~ParallelMatcher() = default;
+
+void
+ParallelMatcher::match(const std::vector<StorageDocument *> & docs, std::vector<Result> & result)
+{
+    result.clear();
+    result.resize(docs.size());
+    size_t numParts = std::min(_contexts.size(), std::max(docs.size() / _minDocsPerContext, size_t(1)));
+    size_t partSize = (docs.size() + numParts - 1) / numParts;
+    vespalib::CountDownLatch latch(numParts - 1);
+    for (size_t part(1); part < numParts; ++part) {
+        MatchContext & ctx = *_contexts[part];
+        size_t begin = std::min(part * partSize, docs.size());
+        size_t end = std::min(begin + partSize, docs.size());
+        auto task = vespalib::makeLambdaTask([&ctx, &docs, &result, &latch, begin, end]()
+                                             {
+                                                 ctx.match(docs, begin, end, result);
+                                                 latch.countDown();
+                                             });
+        auto rejected = _executor.execute(std::move(task));
+        if (rejected) {
+            // The shared executor is saturated, do the work in this thread instead.
+            rejected->run();
+        }
+    }
+    _contexts[0]->match(docs, 0, std::min(partSize, docs.size()), result);
+    latch.await();
+}
+
+}
@@ -0,0 +1,94 @@
+// Copyright 2019 Oath Inc. Licensed under the terms of the Apache 2.0 license. See LICENSE in the project root.
+
+#pragma once
+
+#include <vespa/searchlib/query/streaming/query.h>
+#include <vespa/vsm/searcher/fieldsearcher.h>
+#include <vespa/vsm/vsm/fieldsearchspec.h>
+#include <memory>
+#include <vector>
+
+namespace vespalib { class ThreadExecutor; }
+namespace vsm { class StorageDocument; }
+
+namespace streaming {
+
+/*
+ * Class used to find the documents in a large block that match the
+ * query by spreading the work across a shared executor. Each match
+ * context has its own copy of the query and the field searchers, so
+ * the contexts can run concurrently. The visitor thread takes part in
+ * the work itself and waits for the other contexts before returning.
+ *
+ * For a matching document the hits and field info of all query terms
+ * are kept, so the visitor thread can put them into its own query and
+ * rank the document without running the field searchers again.
+ * Ranking, grouping and hit collection for the (typically few) matching
+ * documents is still done by the visitor thread, since those depend on
+ * the visitor local attribute vectors being filled in hit order.
+ */
+class ParallelMatcher {
+public:
+    struct TermMatch {
+        search::streaming::HitList                            hits;
+        std::vector<search::streaming::QueryTerm::FieldInfo>  fieldInfo;
+    };
+
+    /**
+     * The outcome of matching one document. The terms are given in
+     * query leaf order, and only for a matching document. UNKNOWN means
+     * that matching failed and must be redone by the visitor thread.
+     **/
+    struct Result {
+        enum class State : uint8_t { NO_MATCH, MATCH, UNKNOWN };
+        State                  state;
+        std::vector<TermMatch> terms;
+        Result() : state(State::NO_MATCH), terms() { }
+    };
+
+    /**
+     * Put the hits and field info of a matching document into the given query terms,
+     * which must be the leafs of a query built from the same query blob.
+     **/
+    static void apply(const Result & result, const search::streaming::QueryTermList & leafs);
+
+private:
+    class MatchContext {
+        search::streaming::Query         _query;
+        search::streaming::QueryTermList _leafs;
+        vsm::FieldIdTSearcherMap         _fieldSearcherMap;
+        vsm::SharedSearcherBuf           _searchBuffer;
+        bool match(const vsm::StorageDocument & doc, Result & result);
+    public:
+        MatchContext(const search::QueryPacketT & queryBlob, vsm::FieldSearchSpecMap & fieldSearchSpecMap,
+                     const vsm::StringFieldIdTMap & fieldsInQuery);
+        ~MatchContext();
+        void match(const std::vector<vsm::StorageDocument *> & docs, size_t begin, size_t end, std::vector<Result> & result);
+    };
+
+    vespalib::ThreadExecutor                 & _executor;
+    std::vector<std::unique_ptr<MatchContext>> _contexts;
+    size_t                                     _minDocsPerContext;
+
+public:
+    ParallelMatcher(vespalib::ThreadExecutor & executor, uint32_t numContexts, size_t minDocsPerContext,
+                    const search::QueryPacketT & queryBlob, vsm::FieldSearchSpecMap & fieldSearchSpecMap,
+                    const vsm::StringFieldIdTMap & fieldsInQuery);
+    ~ParallelMatcher();
+
+    size_t getNumContexts() const { return _contexts.size(); }
+
+    /**
+     * Returns whether a block of the given size is large enough to be
+     * worth spreading across more than one match context.
+     **/
+    bool useParallel(size_t numDocs) const { return (_contexts.size() > 1) && (numDocs >= 2 * _minDocsPerContext); }
+
+    /**
+     * Match all the given documents, with result[i] being the outcome for docs[i].
+     * A nullptr entry in docs is treated as a non-matching document.
+     **/
+    void match(const std::vector<vsm::StorageDocument *> & docs, std::vector<Result> & result);
+};
+
+}
@@ -36,6 +36,12 @@ parseLocation(const string & location_str)
                      location.c_str(), locationSpec.getParseError());
         return fefLocation;
     }
+    // Streaming search does not match on the location, it is only used for ranking.
+    // Limiting matches to the nearest documents ({N} in the location) is therefore not supported.
+    if (locationSpec.getTargetHits() > 0) {
+        LOG(warning, "Location target hits is not supported by streaming search (location: '%s'). Target hits ignored.",
+                     location.c_str());
+    }
     fefLocation.setAttribute(attr);
     fefLocation.setXPosition(locationSpec.getX());
     fefLocation.setYPosition(locationSpec.getY());
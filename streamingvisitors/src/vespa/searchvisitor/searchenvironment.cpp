@@ -2,6 +2,8 @@
 
 #include "searchenvironment.h"
 #include <vespa/vespalib/stllike/hash_map.hpp>
+#include <vespa/vespalib/util/threadstackexecutor.h>
+#include <thread>
 
 #include <vespa/log/log.h>
 LOG_SETUP(".visitor.instance.searchenvironment");
@@ -11,6 +13,13 @@ using vsm::VSMAdapter;
 
 namespace streaming {
 
+namespace {
+
+constexpr uint32_t MATCH_THREAD_STACK_SIZE = 256 * 1024;
+constexpr uint32_t MATCH_TASKS_PER_THREAD = 2;
+
+}
+
 __thread SearchEnvironment::EnvMap * SearchEnvironment::_localEnvMap=0;
 
 SearchEnvironment::Env::Env(const vespalib::string & muffens, const config::ConfigUri & configUri, Fast_NormalizeWordFolder & wf) :
@@ -52,15 +61,30 @@ SearchEnvironment::Env::~Env()
 SearchEnvironment::SearchEnvironment(const config::ConfigUri & configUri) :
     VisitorEnvironment(),
     _envMap(),
-    _configUri(configUri)
+    _configUri(configUri),
+    _matchExecutor()
 { }
 
 SearchEnvironment::~SearchEnvironment()
 {
+    _matchExecutor.reset();
     vespalib::LockGuard guard(_lock);
     _threadLocals.clear();
 }
 
+vespalib::ThreadExecutor &
+SearchEnvironment::getMatchExecutor()
+{
+    vespalib::LockGuard guard(_lock);
+    if ( ! _matchExecutor) {
+        uint32_t numThreads = std::max(1u, std::thread::hardware_concurrency());
+        LOG(debug, "Creating match executor with %u threads", numThreads);
+        _matchExecutor = std::make_unique<vespalib::ThreadStackExecutor>(numThreads, MATCH_THREAD_STACK_SIZE,
+                                                                         numThreads * MATCH_TASKS_PER_THREAD);
+    }
+    return *_matchExecutor;
+}
+
 SearchEnvironment::Env &
 SearchEnvironment::getEnv(const vespalib::string & searchCluster)
 {
@@ -10,6 +10,8 @@
 #include <vespa/vsm/vsm/vsm-adapter.h>
 #include <vespa/fastlib/text/normwordfolder.h>
 
+namespace vespalib { class ThreadExecutor; }
+
 namespace streaming {
 
 class SearchEnvironment : public storage::VisitorEnvironment
@@ -41,6 +43,7 @@ private:
     vespalib::Lock           _lock;
     Fast_NormalizeWordFolder _wordFolder;
     config::ConfigUri        _configUri;
+    std::unique_ptr<vespalib::ThreadExecutor> _matchExecutor;
 
     Env & getEnv(const vespalib::string & searchcluster);
 
@@ -49,6 +52,13 @@ public:
     ~SearchEnvironment();
     const vsm::VSMAdapter * getVSMAdapter(const vespalib::string & searchcluster) { return getEnv(searchcluster).getVSMAdapter(); }
     const RankManager * getRankManager(const vespalib::string & searchcluster)    { return getEnv(searchcluster).getRankManager(); }
+
+    /**
+     * Returns the executor shared by all search visitors for matching large blocks of documents in parallel.
+     * It is created on first use. The number of threads and the number of queued tasks are bounded,
+     * so a single visitor can never take over the node.
+     **/
+    vespalib::ThreadExecutor & getMatchExecutor();
 };
 
 }
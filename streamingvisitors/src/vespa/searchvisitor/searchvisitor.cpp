@@ -16,6 +16,7 @@
 #include <vespa/vespalib/util/exceptions.h>
 #include <vespa/fnet/databuffer.h>
 #include "matching_elements_filler.h"
+#include "parallel_matcher.h"
 
 #include <vespa/log/log.h>
 LOG_SETUP(".visitor.instance.searchvisitor");
@@ -202,7 +203,9 @@ SearchVisitor::SearchVisitor(StorageComponent& component,
     _rankAttribute(dynamic_cast<search::SingleFloatExtAttribute &>(*_rankAttributeBacking)),
     _shouldFillRankAttribute(false),
     _syntheticFieldsController(),
-    _rankController()
+    _rankController(),
+    _parallelMatcher(),
+    _queryLeafs()
 {
     LOG(debug, "Created SearchVisitor");
 }
@@ -328,6 +331,8 @@ void SearchVisitor::init(const Parameters & params)
             // Depends on hitCollector setup.
             setupDocsumObjects();
 
+            setupParallelMatcher(params, search::QueryPacketT(queryBlob.data(), queryBlob.size()), fieldsInQuery);
+
         } else {
             LOG(warning, "No query received");
         }
@@ -652,6 +657,22 @@ SearchVisitor::setupFieldSearchers(const std::vector<vespalib::string> & additio
     _fieldSearcherMap.prepare(_fieldSearchSpecMap.documentTypeMap(), _searchBuffer, _query);
 }
 
+void
+SearchVisitor::setupParallelMatcher(const Parameters & params, const search::QueryPacketT & queryBlob,
+                                    const StringFieldIdTMap & fieldsInQuery)
+{
+    int matchThreads = params.get("matchthreads", 1);
+    if (matchThreads > 1) {
+        int minDocsPerThread = params.get("matchminblocksize", 64);
+        LOG(debug, "Matching large blocks using %d threads (at least %d documents per thread)",
+            matchThreads, minDocsPerThread);
+        _parallelMatcher = std::make_unique<ParallelMatcher>(_env.getMatchExecutor(), matchThreads,
+                                                             std::max(minDocsPerThread, 1), queryBlob,
+                                                             _fieldSearchSpecMap, fieldsInQuery);
+        _query.getLeafs(_queryLeafs);
+    }
+}
+
 void
 SearchVisitor::setupSnippetModifiers()
 {
@@ -888,17 +909,36 @@ SearchVisitor::handleDocuments(const document::BucketId&,
 
     const document::DocumentType* defaultDocType = _docTypeMapping.getDefaultDocumentType();
     assert(defaultDocType);
+    std::vector<StorageDocument::UP> documents;
+    documents.reserve(entries.size());
     for (const auto & entry : entries) {
-        StorageDocument::UP document(new StorageDocument(entry->releaseDocument(), _fieldPathMap, highestFieldNo));
-
+        documents.push_back(std::make_unique<StorageDocument>(entry->releaseDocument(), _fieldPathMap, highestFieldNo));
+    }
+    std::vector<ParallelMatcher::Result> matched;
+    if (_parallelMatcher && _parallelMatcher->useParallel(documents.size())) {
+        std::vector<StorageDocument *> toMatch;
+        toMatch.reserve(documents.size());
+        for (const auto & document : documents) {
+            toMatch.push_back(compatibleDocumentTypes(*defaultDocType, document->docDoc().getType()) ? document.get() : nullptr);
+        }
+        VISITOR_TRACE(9, vespalib::make_string("Matching %zu documents using %zu match contexts",
+                                               toMatch.size(), _parallelMatcher->getNumContexts()));
+        _parallelMatcher->match(toMatch, matched);
+    }
+    for (size_t i(0); i < documents.size(); ++i) {
+        StorageDocument::UP & document = documents[i];
         try {
             if (defaultDocType != nullptr
                 && !compatibleDocumentTypes(*defaultDocType, document->docDoc().getType()))
             {
                 LOG(debug, "Skipping document of type '%s' when handling only documents of type '%s'",
                     document->docDoc().getType().getName().c_str(), defaultDocType->getName().c_str());
+            } else if ( ! matched.empty() && (matched[i].state == ParallelMatcher::Result::State::NO_MATCH)) {
+                handleNonMatchingDocument(*document);
             } else {
-                if (handleDocument(*document)) {
+                const ParallelMatcher::Result * preMatched =
+                    ( ! matched.empty() && (matched[i].state == ParallelMatcher::Result::State::MATCH)) ? &matched[i] : nullptr;
+                if (handleDocument(*document, preMatched)) {
                     _backingDocuments.push_back(std::move(document));
                 }
             }
@@ -909,13 +949,22 @@ SearchVisitor::handleDocuments(const document::BucketId&,
     }
 }
 
+void
+SearchVisitor::handleNonMatchingDocument(StorageDocument & document)
+{
+    _syntheticFieldsController.onDocument(document);
+    group(document.docDoc(), 0, true);
+    _docSearchedCount++;
+    LOG(debug, "Did not match document with id '%s'", document.docDoc().getId().getScheme().toString().c_str());
+}
+
 bool
-SearchVisitor::handleDocument(StorageDocument & document)
+SearchVisitor::handleDocument(StorageDocument & document, const ParallelMatcher::Result * preMatched)
 {
     bool needToKeepDocument(false);
     _syntheticFieldsController.onDocument(document);
     group(document.docDoc(), 0, true);
-    if (match(document)) {
+    if (match(document, preMatched)) {
         RankProcessor & rp = *_rankController.getRankProcessor();
         vespalib::string documentId(document.docDoc().getId().getScheme().toString());
         LOG(debug, "Matched document with id '%s'", documentId.c_str());
@@ -971,10 +1020,14 @@ SearchVisitor::group(const document::Document & doc, search::HitRank rank, bool
 }
 
 bool
-SearchVisitor::match(const StorageDocument & doc)
+SearchVisitor::match(const StorageDocument & doc, const ParallelMatcher::Result * preMatched)
 {
-    for (vsm::FieldSearcherContainer & fSearch : _fieldSearcherMap) {
-        fSearch->search(doc);
+    if (preMatched != nullptr) {
+        ParallelMatcher::apply(*preMatched, _queryLeafs);
+    } else {
+        for (vsm::FieldSearcherContainer & fSearch : _fieldSearcherMap) {
+            fSearch->search(doc);
+        }
     }
     bool hit(_query.evaluate());
     if (hit) {
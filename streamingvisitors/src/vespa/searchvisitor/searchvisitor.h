@@ -4,6 +4,7 @@
 
 #include "hitcollector.h"
 #include "indexenvironment.h"
+#include "parallel_matcher.h"
 #include "queryenvironment.h"
 #include "rankmanager.h"
 #include "rankprocessor.h"
@@ -258,6 +259,17 @@ private:
     void setupFieldSearchers(const std::vector<vespalib::string> & additionalFields,
                              vsm::StringFieldIdTMap & fieldsInQuery);
 
+    /**
+     * Setup matching of large document blocks across multiple threads if requested by the
+     * 'matchthreads' parameter. Each thread gets its own copy of the query and field searchers.
+     *
+     * @param params the visitor parameters.
+     * @param queryBlob the binary representation of the query.
+     * @param fieldsInQuery mapping from field name to field id for fields mentioned in the query.
+     **/
+    void setupParallelMatcher(const vdslib::Parameters & params, const search::QueryPacketT & queryBlob,
+                              const vsm::StringFieldIdTMap & fieldsInQuery);
+
     /**
      * Setup snippet modifiers for the fields where we have substring search.
      * The modifiers will be used when generating docsum.
@@ -307,9 +319,16 @@ private:
     /**
      * Process one document
      * @param document Document to process.
+     * @param preMatched The outcome of matching the document in parallel, or nullptr if not matched yet.
      * @return true if the underlying buffer is needed later on, then it must be kept.
      */
-    bool handleDocument(vsm::StorageDocument & document);
+    bool handleDocument(vsm::StorageDocument & document, const ParallelMatcher::Result * preMatched);
+
+    /**
+     * Process one document already known not to match the query.
+     * @param document Document to process.
+     */
+    void handleNonMatchingDocument(vsm::StorageDocument & document);
 
     /**
      * Collect the given document for grouping.
@@ -323,9 +342,11 @@ private:
      * Check if the given document matches the query.
      *
      * @param doc the document to match.
+     * @param preMatched the term hits found when matching the document in parallel,
+     *                   used instead of running the field searchers if not nullptr.
      * @return whether the document matched the query.
      **/
-    bool match(const vsm::StorageDocument & doc);
+    bool match(const vsm::StorageDocument & doc, const ParallelMatcher::Result * preMatched);
 
     /**
      * Fill attribute vectors needed for aggregation and sorting with values from the scratch document.
@@ -448,6 +469,8 @@ private:
     bool                                    _shouldFillRankAttribute;
     SyntheticFieldsController               _syntheticFieldsController;
     RankController                          _rankController;
+    std::unique_ptr<ParallelMatcher>        _parallelMatcher;
+    search::streaming::QueryTermList        _queryLeafs;
     DocumentVector                          _backingDocuments;
     vsm::StringFieldIdTMapT                 _fieldsUnion;
 
@@ -0,0 +1,70 @@
+// Copyright 2019 Oath Inc. Licensed under the terms of the Apache 2.0 license. See LICENSE in the project root.
+#include <vespa/vespalib/testkit/test_kit.h>
+#include <vbench/test/all.h>
+#include <cstdio>
+
+using namespace vbench;
+
+struct RequestList : Handler<Request> {
+    std::vector<Request::UP> list;
+    void handle(Request::UP request) override { list.push_back(std::move(request)); }
+};
+
+string record(const string &payload) {
+    string str;
+    uint32_t len = payload.size();
+    str.push_back(char(len >> 24));
+    str.push_back(char(len >> 16));
+    str.push_back(char(len >> 8));
+    str.push_back(char(len));
+    str += payload;
+    return str;
+}
+
+void write_file(const string &name, const string &data) {
+    FILE *file = fopen(name.c_str(), "w");
+    ASSERT_TRUE(file != nullptr);
+    ASSERT_EQUAL(data.size(), fwrite(data.data(), 1, data.size(), file));
+    fclose(file);
+}
+
+struct CaptureFile {
+    string name;
+    CaptureFile() : name("capture.bin") {
+        string truncated = record("xyz").substr(0, 5);
+        write_file(name, record("foo") + record("") + record(string(300, 'x')) + truncated);
+    }
+    ~CaptureFile() { remove(name.c_str()); }
+};
+
+TEST_FFF("generate requests from capture file", CaptureFile(), RequestList(), CapturedRequestGenerator(f1.name, 0, f2)) {
+    f3.run();
+    EXPECT_FALSE(f3.tainted());
+    ASSERT_EQUAL(3u, f2.list.size());
+    EXPECT_EQUAL(string("foo"), f2.list[0]->payload());
+    EXPECT_EQUAL(string(""), f2.list[1]->payload());
+    EXPECT_EQUAL(string(300, 'x'), f2.list[2]->payload());
+}
+
+TEST_FFF("require that trace level is appended to payload", CaptureFile(), RequestList(), CapturedRequestGenerator(f1.name, 300, f2)) {
+    f3.run();
+    ASSERT_EQUAL(3u, f2.list.size());
+    // field 4 (varint): tag 0x20, then 300 as varint (0xac 0x02)
+    EXPECT_EQUAL(string("foo\x20\xac\x02"), f2.list[0]->payload());
+    EXPECT_EQUAL(string("\x20\xac\x02"), f2.list[1]->payload());
+}
+
+TEST_FF("capture file not found", RequestList(), CapturedRequestGenerator("no_such_capture.bin", 0, f1)) {
+    f2.run();
+    EXPECT_EQUAL(0u, f1.list.size());
+    EXPECT_TRUE(f2.tainted());
+}
+
+TEST_FFF("abort request generation", CaptureFile(), RequestList(), CapturedRequestGenerator(f1.name, 0, f2)) {
+    f3.abort();
+    f3.run();
+    EXPECT_EQUAL(0u, f2.list.size());
+    EXPECT_FALSE(f3.tainted());
+}
+
+TEST_MAIN() { TEST_RUN_ALL(); }
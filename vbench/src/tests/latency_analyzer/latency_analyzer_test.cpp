@@ -27,10 +27,31 @@ TEST_FF("verify percentiles", RequestSink(), LatencyAnalyzer(f1)) {
         post(0.001 * i, f2);
     }
     LatencyAnalyzer::Stats stats = f2.getStats();
-    EXPECT_APPROX(5.0, stats.per50, 10e-6);
-    EXPECT_APPROX(9.5, stats.per95, 10e-6);
-    EXPECT_APPROX(9.9, stats.per99, 10e-6);
+    // log-linear buckets give a relative error below 0.1%
+    EXPECT_APPROX(5.0, stats.per50, 5e-3);
+    EXPECT_APPROX(9.5, stats.per95, 5e-3);
+    EXPECT_APPROX(9.9, stats.per99, 5e-3);
     fprintf(stderr, "%s", stats.toString().c_str());
 }
 
+TEST_FF("verify sub-millisecond percentiles", RequestSink(), LatencyAnalyzer(f1)) {
+    for (size_t i = 0; i <= 1000; ++i) {
+        post(0.000001 * i, f2);
+    }
+    LatencyAnalyzer::Stats stats = f2.getStats();
+    EXPECT_APPROX(0.0005, stats.per50, 10e-9);
+    EXPECT_APPROX(0.00095, stats.per95, 10e-9);
+    EXPECT_APPROX(0.00099, stats.per99, 10e-9);
+}
+
+TEST_FF("require that large latencies are part of percentiles", RequestSink(), LatencyAnalyzer(f1)) {
+    for (size_t i = 0; i < 100; ++i) {
+        post((i < 50) ? 1.0 : 100.0, f2);
+    }
+    LatencyAnalyzer::Stats stats = f2.getStats();
+    EXPECT_APPROX(50.5, stats.per50, 0.1);
+    EXPECT_APPROX(100.0, stats.per95, 0.1);
+    EXPECT_APPROX(100.0, stats.per99, 0.1);
+}
+
 TEST_MAIN() { TEST_RUN_ALL(); }
@@ -0,0 +1,33 @@
+// Copyright 2019 Oath Inc. Licensed under the terms of the Apache 2.0 license. See LICENSE in the project root.
+#include <vespa/vespalib/testkit/testapp.h>
+#include <vbench/test/all.h>
+
+using namespace vbench;
+
+void post(double first, double second, Handler<Request> &handler,
+          Request::Status status = Request::STATUS_OK)
+{
+    Request::UP req(new Request());
+    req->status(status);
+    req->phases().first_phase.set(first);
+    if (second > 0.0) {
+        req->phases().second_phase.set(second);
+    }
+    handler.handle(std::move(req));
+}
+
+TEST_FF("require that only OK requests with phases are counted", RequestSink(), PhaseAnalyzer(f1)) {
+    post(1.0, 0.5, f2);
+    post(2.0, 0.0, f2);
+    post(10.0, 10.0, f2, Request::STATUS_DROPPED);
+    post(20.0, 20.0, f2, Request::STATUS_FAILED);
+    EXPECT_APPROX(1.0, f2.getFirstPhaseStats().min, 10e-6);
+    EXPECT_APPROX(1.5, f2.getFirstPhaseStats().avg, 10e-6);
+    EXPECT_APPROX(2.0, f2.getFirstPhaseStats().max, 10e-6);
+    EXPECT_APPROX(0.5, f2.getSecondPhaseStats().min, 10e-6);
+    EXPECT_APPROX(0.5, f2.getSecondPhaseStats().max, 10e-6);
+    EXPECT_EQUAL(0.0, f2.getSetupStats().max);
+    f2.report();
+}
+
+TEST_MAIN() { TEST_RUN_ALL(); }
@@ -0,0 +1,205 @@
+// Copyright 2019 Oath Inc. Licensed under the terms of the Apache 2.0 license. See LICENSE in the project root.
+#include <vespa/vespalib/testkit/test_kit.h>
+#include <vbench/test/all.h>
+#include <vespa/fnet/frt/frt.h>
+#include <vespa/vespalib/data/slime/slime.h>
+#include <vespa/vespalib/util/compressionconfig.h>
+#include <mutex>
+
+using namespace vbench;
+using vespalib::Slime;
+using vespalib::slime::Cursor;
+using vespalib::compression::CompressionConfig;
+
+auto null_crypto = std::make_shared<vespalib::NullCryptoEngine>();
+
+//-----------------------------------------------------------------------------
+
+void addVarint(string &dst, uint64_t value) {
+    while (value >= 0x80) {
+        dst.push_back(char((value & 0x7f) | 0x80));
+        value >>= 7;
+    }
+    dst.push_back(char(value));
+}
+
+void addInt(string &dst, uint32_t field, uint64_t value) {
+    addVarint(dst, (field << 3) | 0);
+    addVarint(dst, value);
+}
+
+void addBytes(string &dst, uint32_t field, const string &value) {
+    addVarint(dst, (field << 3) | 2);
+    addVarint(dst, value.size());
+    dst += value;
+}
+
+void addEvent(Cursor &traces, double ms, const char *event) {
+    Cursor &obj = traces.addObject();
+    obj.setDouble("timestamp_ms", ms);
+    obj.setString("event", event);
+}
+
+string make_trace() {
+    Slime slime;
+    Cursor &root = slime.setObject();
+    Cursor &traces = root.setArray("traces");
+    addEvent(traces, 1.0, "MTF: Start");
+    addEvent(traces, 3.0, "MTF: Complete");
+    Cursor &tag = traces.addObject();
+    tag.setDouble("timestamp_ms", 3.5);
+    tag.setString("tag", "match_threads");
+    Cursor &threads = tag.setArray("threads");
+    Cursor &thread1 = threads.addObject().setArray("traces");
+    addEvent(thread1, 3.5, "Start MatchThread::run");
+    addEvent(thread1, 4.0, "Start match and first phase rank");
+    addEvent(thread1, 9.0, "Start second phase rerank");
+    addEvent(thread1, 10.0, "Create result set");
+    addEvent(thread1, 12.0, "MatchThread::run Done");
+    Cursor &thread2 = threads.addObject().setArray("traces");
+    addEvent(thread2, 3.5, "Start MatchThread::run");
+    addEvent(thread2, 4.0, "Start match and first phase rank");
+    addEvent(thread2, 11.0, "Create result set");
+    addEvent(thread2, 12.0, "MatchThread::run Done");
+    root.setDouble("duration_ms", 15.0);
+    vespalib::SimpleBuffer buf;
+    vespalib::slime::BinaryFormat::encode(slime, buf);
+    return string(buf.get().data, buf.get().size);
+}
+
+// total hit count is the size of the request payload
+string make_reply(size_t request_size, bool degraded) {
+    string reply;
+    addInt(reply, 1, request_size);
+    addInt(reply, 2, 1000);
+    addInt(reply, 3, 1000);
+    addInt(reply, 4, 1000);
+    addInt(reply, 5, degraded ? 1 : 0);
+    addBytes(reply, 7, "hit 1");
+    addBytes(reply, 7, "hit 2");
+    addBytes(reply, 8, "grouping");
+    addBytes(reply, 9, make_trace());
+    return reply;
+}
+
+//-----------------------------------------------------------------------------
+
+struct Server : FRT_Invokable {
+    fnet::frt::StandaloneFRT frt;
+    Server() : frt() {
+        FRT_ReflectionBuilder rb(&frt.supervisor());
+        rb.DefineMethod("vespa.searchprotocol.search", "bix", "bix",
+                        FRT_METHOD(Server::rpc_search), this);
+        frt.supervisor().Listen(0);
+    }
+    int port() const { return const_cast<Server*>(this)->frt.supervisor().GetListenPort(); }
+    void rpc_search(FRT_RPCRequest *req) {
+        const FRT_Values &params = *req->GetParams();
+        string payload(params[2]._data._buf, params[2]._data._len);
+        if (payload == "fail") {
+            req->SetError(FRTE_RPC_METHOD_FAILED, "fail");
+            return;
+        }
+        string reply = make_reply(payload.size(), payload == "degraded");
+        FRT_Values &ret = *req->GetReturn();
+        ret.AddInt8(CompressionConfig::NONE);
+        ret.AddInt32(reply.size());
+        ret.AddData(reply.data(), reply.size());
+    }
+};
+
+struct RequestList : Handler<Request> {
+    std::mutex lock;
+    std::vector<Request::UP> list;
+    void handle(Request::UP request) override {
+        std::lock_guard<std::mutex> guard(lock);
+        list.push_back(std::move(request));
+    }
+    const Request *find(const string &payload) const {
+        for (const auto &request: list) {
+            if (request->payload() == payload) {
+                return request.get();
+            }
+        }
+        return nullptr;
+    }
+};
+
+void send(SearchProtocolClient &client, int port, const string &payload) {
+    Request::UP request(new Request());
+    request->server(ServerSpec("localhost", port)).payload(payload);
+    client.search(std::move(request));
+}
+
+//-----------------------------------------------------------------------------
+
+TEST("require that search reply can be decoded") {
+    string reply = make_reply(3, false);
+    Request request;
+    EXPECT_TRUE(SearchReplyDecoder::decodeReply(vespalib::Memory(reply.data(), reply.size()), request));
+    EXPECT_EQUAL(3.0, request.headers().total_hit_count.value);
+    EXPECT_EQUAL(2.0, request.headers().num_hits.value);
+    EXPECT_EQUAL(1000.0, request.headers().docs_searched.value);
+    EXPECT_EQUAL(1.0, request.headers().full_coverage.value);
+    EXPECT_EQUAL(reply.size(), request.size());
+}
+
+TEST("require that degraded search reply is not full coverage") {
+    string reply = make_reply(3, true);
+    Request request;
+    EXPECT_TRUE(SearchReplyDecoder::decodeReply(vespalib::Memory(reply.data(), reply.size()), request));
+    EXPECT_EQUAL(0.0, request.headers().full_coverage.value);
+}
+
+TEST("require that truncated search reply is not decoded") {
+    string reply = make_reply(3, false);
+    Request request;
+    EXPECT_FALSE(SearchReplyDecoder::decodeReply(vespalib::Memory(reply.data(), reply.size() - 1), request));
+}
+
+TEST("require that match phases are extracted from search trace (slowest thread)") {
+    string trace = make_trace();
+    MatchPhases phases;
+    EXPECT_TRUE(SearchReplyDecoder::decodeTrace(vespalib::Memory(trace.data(), trace.size()), phases));
+    EXPECT_APPROX(0.002, phases.setup.value, 1e-9);
+    EXPECT_APPROX(0.007, phases.first_phase.value, 1e-9);
+    EXPECT_APPROX(0.001, phases.second_phase.value, 1e-9);
+    EXPECT_APPROX(0.002, phases.result.value, 1e-9);
+    EXPECT_APPROX(0.015, phases.total.value, 1e-9);
+    EXPECT_TRUE(phases.setup.is_set && phases.first_phase.is_set && phases.second_phase.is_set &&
+                phases.result.is_set && phases.total.is_set);
+}
+
+TEST_FF("require that requests are sent using the search protocol", Server(), RequestList()) {
+    Timer timer;
+    SearchProtocolClient client(null_crypto, timer, f2, 10);
+    send(client, f1.port(), "foo");
+    send(client, f1.port(), "foobar");
+    send(client, f1.port(), "fail");
+    client.waitForPending();
+    ASSERT_EQUAL(3u, f2.list.size());
+    const Request *foo = f2.find("foo");
+    const Request *foobar = f2.find("foobar");
+    const Request *fail = f2.find("fail");
+    ASSERT_TRUE((foo != nullptr) && (foobar != nullptr) && (fail != nullptr));
+    EXPECT_EQUAL(Request::STATUS_OK, foo->status());
+    EXPECT_EQUAL(3.0, foo->headers().total_hit_count.value);
+    EXPECT_EQUAL(Request::STATUS_OK, foobar->status());
+    EXPECT_EQUAL(6.0, foobar->headers().total_hit_count.value);
+    EXPECT_APPROX(0.007, foobar->phases().first_phase.value, 1e-9);
+    EXPECT_TRUE(foobar->endTime() >= foobar->startTime());
+    EXPECT_EQUAL(Request::STATUS_FAILED, fail->status());
+}
+
+TEST_FF("require that requests are dropped when too many are pending", Server(), RequestList()) {
+    Timer timer;
+    SearchProtocolClient client(null_crypto, timer, f2, 0);
+    send(client, f1.port(), "foo");
+    send(client, f1.port(), "bar");
+    client.waitForPending();
+    ASSERT_EQUAL(2u, f2.list.size());
+    EXPECT_EQUAL(Request::STATUS_DROPPED, f2.list[0]->status());
+    EXPECT_EQUAL(Request::STATUS_DROPPED, f2.list[1]->status());
+}
+
+TEST_MAIN() { TEST_RUN_ALL(); }
@@ -29,6 +29,10 @@ struct BenchmarkHeaders
                 is_set = true;
             }
         }
+        void set(double val) {
+            value = val;
+            is_set = true;
+        }
     };
     Value num_hits;
     Value num_fasthits;
@@ -0,0 +1,116 @@
+// Copyright 2019 Oath Inc. Licensed under the terms of the Apache 2.0 license. See LICENSE in the project root.
+
+#include "search_protocol_client.h"
+#include "search_reply_decoder.h"
+#include <vespa/fnet/frt/rpcrequest.h>
+#include <vespa/fnet/frt/target.h>
+#include <vespa/vespalib/util/compressionconfig.h>
+#include <algorithm>
+
+using vespalib::compression::CompressionConfig;
+
+namespace vbench {
+
+namespace {
+
+constexpr double search_timeout = 60.0;
+
+} // namespace vbench::<unnamed>
+
+struct SearchProtocolClient::Invocation : FRT_IRequestWait {
+    SearchProtocolClient &client;
+    Request::UP request;
+    Invocation(SearchProtocolClient &client_in, Request::UP request_in)
+        : client(client_in), request(std::move(request_in)) {}
+    void RequestDone(FRT_RPCRequest *rpc) override {
+        request->endTime(client._timer.sample());
+        if (rpc->IsError() || !rpc->CheckReturnTypes("bix") ||
+            !SearchReplyDecoder::decode(*rpc->GetReturn(), *request))
+        {
+            request->status(Request::STATUS_FAILED);
+        }
+        rpc->SubRef();
+        client.done(std::move(request));
+        delete this;
+    }
+};
+
+FRT_Target &
+SearchProtocolClient::getTarget(const ServerSpec &server)
+{
+    FRT_Target *&target = _targets[server];
+    if (target == nullptr) {
+        string spec = strfmt("tcp/%s:%d", server.host.c_str(), server.port);
+        target = _frt.supervisor().GetTarget(spec.c_str());
+    }
+    return *target;
+}
+
+void
+SearchProtocolClient::done(Request::UP request)
+{
+    _next.handle(std::move(request));
+    std::lock_guard<std::mutex> guard(_lock);
+    if (--_pending == 0) {
+        _cond.notify_all();
+    }
+}
+
+SearchProtocolClient::SearchProtocolClient(CryptoEngine::SP crypto, Timer &timer,
+                                           Handler<Request> &next, size_t maxPending)
+    : _frt(std::move(crypto)),
+      _timer(timer),
+      _next(next),
+      _maxPending(maxPending),
+      _lock(),
+      _cond(),
+      _pending(0),
+      _targets()
+{
+}
+
+SearchProtocolClient::~SearchProtocolClient()
+{
+    waitForPending();
+    for (const auto &entry: _targets) {
+        entry.second->SubRef();
+    }
+}
+
+void
+SearchProtocolClient::search(Request::UP request)
+{
+    {
+        std::lock_guard<std::mutex> guard(_lock);
+        if (_pending >= _maxPending) {
+            request->status(Request::STATUS_DROPPED);
+        } else {
+            ++_pending;
+        }
+    }
+    if (request->status() == Request::STATUS_DROPPED) {
+        _next.handle(std::move(request));
+        return;
+    }
+    request->startTime(std::min(_timer.sample(), request->scheduledTime()));
+    const string &payload = request->payload();
+    FRT_Target &target = getTarget(request->server());
+    FRT_RPCRequest *rpc = _frt.supervisor().AllocRPCRequest();
+    rpc->SetMethodName("vespa.searchprotocol.search");
+    FRT_Values &params = *rpc->GetParams();
+    params.AddInt8(CompressionConfig::NONE);
+    params.AddInt32(payload.size());
+    params.AddData(payload.data(), payload.size());
+    target.InvokeAsync(rpc, search_timeout, new Invocation(*this, std::move(request)));
+}
+
+void
+SearchProtocolClient::waitForPending()
+{
+    std::unique_lock<std::mutex> guard(_lock);
+    while (_pending > 0) {
+        _cond.wait(guard);
+    }
+}
+
+} // namespace vbench
@@ -0,0 +1,64 @@
+// Copyright 2019 Oath Inc. Licensed under the terms of the Apache 2.0 license. See LICENSE in the project root.
+
+#pragma once
+
+#include <vbench/vbench/request.h>
+#include <vbench/core/handler.h>
+#include <vbench/core/timer.h>
+#include <vespa/fnet/frt/invoker.h>
+#include <vespa/fnet/frt/supervisor.h>
+#include <vespa/vespalib/net/crypto_engine.h>
+#include <condition_variable>
+#include <map>
+#include <mutex>
+
+class FRT_Target;
+
+namespace vbench {
+
+/**
+ * Sends requests with a payload (a serialized protobuf search request)
+ * directly to a search node using the search protocol over rpc.
+ *
+ * Unlike the http workers, requests are sent asynchronously as soon as
+ * they are scheduled, without waiting for earlier requests to
+ * complete (open-loop load). The latency of a request is measured from
+ * its scheduled time, so delays in sending a request are not hidden
+ * from the results (coordinated omission). If the number of requests
+ * waiting for a reply reaches the given max, new requests are dropped.
+ **/
+class SearchProtocolClient
+{
+private:
+    struct Invocation;
+
+    fnet::frt::StandaloneFRT             _frt;
+    Timer                               &_timer;
+    Handler<Request>                    &_next;
+    size_t                               _maxPending;
+    std::mutex                           _lock;
+    std::condition_variable              _cond;
+    size_t                               _pending;
+    std::map<ServerSpec, FRT_Target *>   _targets;
+
+    FRT_Target &getTarget(const ServerSpec &server);
+    void done(Request::UP request);
+
+public:
+    using CryptoEngine = vespalib::CryptoEngine;
+    SearchProtocolClient(CryptoEngine::SP crypto, Timer &timer, Handler<Request> &next, size_t maxPending);
+    ~SearchProtocolClient();
+
+    /**
+     * Send the given request. Not thread-safe; only called by the
+     * request scheduler thread.
+     **/
+    void search(Request::UP request);
+
+    /**
+     * Wait until all requests sent have completed.
+     **/
+    void waitForPending();
+};
+
+} // namespace vbench
@@ -0,0 +1,180 @@
+// Copyright 2019 Oath Inc. Licensed under the terms of the Apache 2.0 license. See LICENSE in the project root.
+
+#include "search_reply_decoder.h"
+#include <vespa/fnet/frt/values.h>
+#include <vespa/vespalib/data/databuffer.h>
+#include <vespa/vespalib/data/slime/slime.h>
+#include <vespa/vespalib/util/compressor.h>
+#include <algorithm>
+
+using vespalib::Slime;
+using vespalib::slime::Inspector;
+using vespalib::compression::CompressionConfig;
+
+namespace vbench {
+
+namespace {
+
+enum WireType { VARINT = 0, FIXED64 = 1, BYTES = 2, FIXED32 = 5 };
+
+/**
+ * Minimal reader for the protobuf wire format.
+ **/
+struct WireReader {
+    const unsigned char *pos;
+    const unsigned char *end;
+    bool failed;
+    WireReader(SearchReplyDecoder::Memory data)
+        : pos(reinterpret_cast<const unsigned char *>(data.data)),
+          end(reinterpret_cast<const unsigned char *>(data.data) + data.size),
+          failed(false) {}
+    bool more() const { return (!failed && (pos < end)); }
+    uint64_t readVarint() {
+        uint64_t value = 0;
+        for (uint32_t shift = 0; (shift < 64) && (pos < end); shift += 7) {
+            uint8_t byte = *pos++;
+            value |= (uint64_t(byte & 0x7f) << shift);
+            if ((byte & 0x80) == 0) {
+                return value;
+            }
+        }
+        failed = true;
+        return 0;
+    }
+    void skip(size_t bytes) {
+        if (size_t(end - pos) < bytes) {
+            failed = true;
+        } else {
+            pos += bytes;
+        }
+    }
+    SearchReplyDecoder::Memory readBytes() {
+        size_t len = readVarint();
+        const char *data = reinterpret_cast<const char *>(pos);
+        skip(len);
+        return failed ? SearchReplyDecoder::Memory() : SearchReplyDecoder::Memory(data, len);
+    }
+    void skipValue(uint32_t type) {
+        switch (type) {
+        case VARINT:  readVarint(); break;
+        case FIXED64: skip(8);      break;
+        case BYTES:   readBytes();  break;
+        case FIXED32: skip(4);      break;
+        default:      failed = true;
+        }
+    }
+};
+
+double findEvent(const Inspector &traces, const char *name) {
+    for (size_t i = 0; i < traces.entries(); ++i) {
+        if (traces[i]["event"].asString() == name) {
+            return traces[i]["timestamp_ms"].asDouble();
+        }
+    }
+    return -1.0;
+}
+
+const Inspector &findTag(const Inspector &traces, const char *name) {
+    for (size_t i = 0; i < traces.entries(); ++i) {
+        if (traces[i]["tag"].asString() == name) {
+            return traces[i];
+        }
+    }
+    return *vespalib::slime::NixValue::invalid();
+}
+
+void setMax(MatchPhases::Value &dst, double start_ms, double end_ms) {
+    if ((start_ms >= 0.0) && (end_ms >= start_ms)) {
+        double seconds = (end_ms - start_ms) / 1000.0;
+        dst.set(dst.is_set ? std::max(dst.value, seconds) : seconds);
+    }
+}
+
+} // namespace vbench::<unnamed>
+
+bool
+SearchReplyDecoder::decode(const FRT_Values &ret, Request &request)
+{
+    uint8_t encoding = ret[0]._intval8;
+    uint32_t uncompressed_size = ret[1]._intval32;
+    vespalib::ConstBufferRef blob(ret[2]._data._buf, ret[2]._data._len);
+    vespalib::DataBuffer uncompressed(ret[2]._data._buf, ret[2]._data._len);
+    vespalib::compression::decompress(CompressionConfig::toType(encoding), uncompressed_size,
+                                      blob, uncompressed, true);
+    if (uncompressed.getDataLen() != uncompressed_size) {
+        return false;
+    }
+    return decodeReply(Memory(uncompressed.getData(), uncompressed.getDataLen()), request);
+}
+
+bool
+SearchReplyDecoder::decodeReply(Memory reply, Request &request)
+{
+    int64_t coverage = 0;
+    int64_t active = 0;
+    bool degraded = false;
+    size_t hits = 0;
+    Memory trace;
+    WireReader reader(reply);
+    while (reader.more()) {
+        uint64_t key = reader.readVarint();
+        uint32_t field = (key >> 3);
+        uint32_t type = (key & 0x7);
+        if ((field == 1) && (type == VARINT)) {
+            request.headers().total_hit_count.set(double(int64_t(reader.readVarint())));
+        } else if ((field == 2) && (type == VARINT)) {
+            coverage = reader.readVarint();
+        } else if ((field == 3) && (type == VARINT)) {
+            active = reader.readVarint();
+        } else if (((field == 5) || (field == 6)) && (type == VARINT)) {
+            degraded = (degraded || (reader.readVarint() != 0));
+        } else if ((field == 7) && (type == BYTES)) {
+            reader.readBytes();
+            ++hits;
+        } else if ((field == 9) && (type == BYTES)) {
+            trace = reader.readBytes();
+        } else {
+            reader.skipValue(type);
+        }
+    }
+    if (reader.failed) {
+        return false;
+    }
+    request.headers().num_hits.set(double(hits));
+    request.headers().docs_searched.set(double(coverage));
+    request.headers().full_coverage.set(((coverage == active) && !degraded) ? 1.0 : 0.0);
+    request.size(reply.size);
+    if (trace.size > 0) {
+        return decodeTrace(trace, request.phases());
+    }
+    return true;
+}
+
+bool
+SearchReplyDecoder::decodeTrace(Memory trace, MatchPhases &phases)
+{
+    Slime slime;
+    if (vespalib::slime::BinaryFormat::decode(trace, slime) != trace.size) {
+        return false;
+    }
+    const Inspector &root = slime.get();
+    const Inspector &traces = root["traces"];
+    setMax(phases.setup, findEvent(traces, "MTF: Start"), findEvent(traces, "MTF: Complete"));
+    const Inspector &threads = findTag(traces, "match_threads")["threads"];
+    for (size_t i = 0; i < threads.entries(); ++i) {
+        const Inspector &events = threads[i]["traces"];
+        double first_start = findEvent(events, "Start match and first phase rank");
+        double second_start = findEvent(events, "Start second phase rerank");
+        double result_start = findEvent(events, "Create result set");
+        double done = findEvent(events, "MatchThread::run Done");
+        setMax(phases.first_phase, first_start, (second_start >= 0.0) ? second_start : result_start);
+        setMax(phases.second_phase, second_start, result_start);
+        setMax(phases.result, result_start, done);
+    }
+    if (root["duration_ms"].valid()) {
+        phases.total.set(root["duration_ms"].asDouble() / 1000.0);
+    }
+    return true;
+}
+
+} // namespace vbench
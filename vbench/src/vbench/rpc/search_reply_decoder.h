@@ -0,0 +1,50 @@
+// Copyright 2019 Oath Inc. Licensed under the terms of the Apache 2.0 license. See LICENSE in the project root.
+
+#pragma once
+
+#include <vbench/vbench/request.h>
+#include <vespa/vespalib/data/memory.h>
+
+class FRT_Values;
+
+namespace vbench {
+
+/**
+ * Extracts the values needed for benchmarking from a protobuf search
+ * reply returned by a search node ('vespa.searchprotocol.search').
+ *
+ * vbench does not depend on the generated protobuf code, so the reply
+ * is scanned directly using the protobuf wire format. Only the fields
+ * below are looked at; all other fields are skipped:
+ *
+ *   1: total_hit_count, 2: coverage_docs, 3: active_docs,
+ *   5: degraded_by_match_phase, 6: degraded_by_soft_timeout,
+ *   7: hits (counted), 9: slime_trace
+ *
+ * The search trace (binary slime) is used to calculate the time spent
+ * in the different match phases. When more than one match thread is
+ * used, the slowest thread is reported for each phase.
+ **/
+class SearchReplyDecoder
+{
+public:
+    using Memory = vespalib::Memory;
+
+    /**
+     * Decode the return values ("bix") of a search rpc into the given
+     * request. Returns false if the reply could not be decoded.
+     **/
+    static bool decode(const FRT_Values &ret, Request &request);
+
+    /**
+     * Decode an uncompressed, serialized protobuf search reply.
+     **/
+    static bool decodeReply(Memory reply, Request &request);
+
+    /**
+     * Decode a search trace (binary slime) into match phases.
+     **/
+    static bool decodeTrace(Memory trace, MatchPhases &phases);
+};
+
+} // namespace vbench
@@ -16,6 +16,9 @@
 #include <vbench/vbench/server_tagger.h>
 #include <vbench/vbench/request.h>
 #include <vbench/vbench/latency_analyzer.h>
+#include <vbench/vbench/latency_histogram.h>
+#include <vbench/vbench/phase_analyzer.h>
+#include <vbench/vbench/captured_request_generator.h>
 #include <vbench/core/input_file_reader.h>
 #include <vbench/core/line_reader.h>
 #include <vbench/core/string.h>
@@ -46,4 +49,6 @@
 #include <vbench/http/http_connection.h>
 #include <vbench/http/server_spec.h>
 #include <vbench/http/http_connection_pool.h>
+#include <vbench/rpc/search_reply_decoder.h>
+#include <vbench/rpc/search_protocol_client.h>
 
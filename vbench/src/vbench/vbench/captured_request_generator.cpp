@@ -0,0 +1,75 @@
+// Copyright 2019 Oath Inc. Licensed under the terms of the Apache 2.0 license. See LICENSE in the project root.
+
+#include "captured_request_generator.h"
+#include <vespa/vespalib/io/mapped_file_input.h>
+
+namespace vbench {
+
+namespace {
+
+// protobuf wire format tag for SearchRequest.trace_level (field 4, varint)
+constexpr char TRACE_LEVEL_TAG = 0x20;
+
+uint32_t readLength(const char *pos) {
+    const unsigned char *p = reinterpret_cast<const unsigned char *>(pos);
+    return ((uint32_t(p[0]) << 24) | (uint32_t(p[1]) << 16) | (uint32_t(p[2]) << 8) | uint32_t(p[3]));
+}
+
+// A field may occur more than once in a protobuf message; the last
+// value wins. Appending the field overrides any value already there.
+void appendTraceLevel(string &payload, int32_t traceLevel) {
+    payload.push_back(TRACE_LEVEL_TAG);
+    uint32_t value = traceLevel;
+    while (value >= 0x80) {
+        payload.push_back(char((value & 0x7f) | 0x80));
+        value >>= 7;
+    }
+    payload.push_back(char(value));
+}
+
+} // namespace vbench::<unnamed>
+
+CapturedRequestGenerator::CapturedRequestGenerator(const string &inputFile,
+                                                   int32_t traceLevel,
+                                                   Handler<Request> &next)
+    : _inputFile(inputFile),
+      _traceLevel(traceLevel),
+      _next(next),
+      _aborted(false),
+      _taint()
+{
+}
+
+void
+CapturedRequestGenerator::abort()
+{
+    _aborted = true;
+}
+
+void
+CapturedRequestGenerator::run()
+{
+    vespalib::MappedFileInput file(_inputFile);
+    if (!file.valid()) {
+        _taint.reset(strfmt("could not open file: %s", _inputFile.c_str()));
+        return;
+    }
+    vespalib::Memory data = file.get();
+    size_t pos = 0;
+    while (!_aborted && ((data.size - pos) >= 4)) {
+        uint32_t len = readLength(data.data + pos);
+        if ((data.size - pos - 4) < len) {
+            break; // truncated record
+        }
+        string payload(data.data + pos + 4, len);
+        if (_traceLevel > 0) {
+            appendTraceLevel(payload, _traceLevel);
+        }
+        pos += (4 + len);
+        Request::UP request(new Request());
+        request->payload(payload);
+        _next.handle(std::move(request));
+    }
+}
+
+} // namespace vbench
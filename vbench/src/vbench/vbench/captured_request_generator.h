@@ -0,0 +1,39 @@
+// Copyright 2019 Oath Inc. Licensed under the terms of the Apache 2.0 license. See LICENSE in the project root.
+
+#pragma once
+
+#include "generator.h"
+#include "request.h"
+#include <vbench/core/handler.h>
+
+namespace vbench {
+
+/**
+ * Reads search requests captured by a search node (see
+ * search::engine::SearchRequestCapture) and generates requests with
+ * the serialized protobuf search request as payload. Each record in
+ * the capture file is a 32-bit length (network byte order) followed
+ * by the serialized request. A truncated record at the end of the
+ * file is ignored.
+ *
+ * If a trace level is given, it is forced into each request so that
+ * the search node reports the time spent in the different match
+ * phases (trace level 4 or more is needed for this).
+ **/
+class CapturedRequestGenerator : public Generator
+{
+private:
+    string            _inputFile;
+    int32_t           _traceLevel;
+    Handler<Request> &_next;
+    bool              _aborted;
+    Taint             _taint;
+
+public:
+    CapturedRequestGenerator(const string &inputFile, int32_t traceLevel, Handler<Request> &next);
+    void abort() override;
+    void run() override;
+    const Taint &tainted() const override { return _taint; }
+};
+
+} // namespace vbench
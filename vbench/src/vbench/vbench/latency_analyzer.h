@@ -3,6 +3,7 @@
 #pragma once
 
 #include "analyzer.h"
+#include "latency_histogram.h"
 
 namespace vbench {
 
@@ -13,32 +14,16 @@ namespace vbench {
 class LatencyAnalyzer : public Analyzer
 {
 private:
-    Handler<Request>    &_next;
-    size_t               _cnt;
-    double               _min;
-    double               _max;
-    double               _total;
-    std::vector<size_t>  _hist;
-
-    double getN(size_t n) const;
-    double getPercentile(double per) const;
+    Handler<Request> &_next;
+    LatencyHistogram  _hist;
 
 public:
-    struct Stats {
-        double min;
-        double avg;
-        double max;
-        double per50;
-        double per95;
-        double per99;
-        Stats() : min(0), avg(0), max(0), per50(0), per95(0), per99(0) {}
-        string toString() const;
-    };
+    using Stats = LatencyHistogram::Stats;
     LatencyAnalyzer(Handler<Request> &next);
     void handle(Request::UP request) override;
     void report() override;
-    void addLatency(double latency);
-    Stats getStats() const;
+    void addLatency(double latency) { _hist.add(latency); }
+    Stats getStats() const { return _hist.getStats(); }
 };
 
 } // namespace vbench
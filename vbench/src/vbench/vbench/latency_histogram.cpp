@@ -0,0 +1,119 @@
+// Copyright 2019 Oath Inc. Licensed under the terms of the Apache 2.0 license. See LICENSE in the project root.
+
+#include "latency_histogram.h"
+#include <algorithm>
+#include <cmath>
+
+namespace vbench {
+
+namespace {
+
+constexpr uint32_t SUB_BUCKET_BITS = 10;
+constexpr uint64_t SUB_BUCKET_COUNT = (uint64_t(1) << SUB_BUCKET_BITS);
+
+} // namespace vbench::<unnamed>
+
+size_t
+LatencyHistogram::bucketOf(uint64_t micros)
+{
+    if (micros < SUB_BUCKET_COUNT) {
+        return micros;
+    }
+    uint32_t shift = (63 - __builtin_clzll(micros)) - SUB_BUCKET_BITS;
+    return ((shift + 1) << SUB_BUCKET_BITS) + ((micros >> shift) - SUB_BUCKET_COUNT);
+}
+
+double
+LatencyHistogram::valueOf(size_t bucket)
+{
+    if (bucket < SUB_BUCKET_COUNT) {
+        return (((double)bucket) / 1000000.0);
+    }
+    uint32_t shift = (bucket >> SUB_BUCKET_BITS) - 1;
+    uint64_t low = ((bucket & (SUB_BUCKET_COUNT - 1)) + SUB_BUCKET_COUNT) << shift;
+    double mid = ((double)low) + (((double)((uint64_t(1) << shift) - 1)) / 2.0);
+    return (mid / 1000000.0);
+}
+
+double
+LatencyHistogram::getN(size_t n) const
+{
+    size_t acc = 0;
+    for (size_t i = 0; i < _hist.size(); ++i) {
+        acc += _hist[i];
+        if (acc > n) {
+            return std::min(std::max(valueOf(i), _min), _max);
+        }
+    }
+    return _max;
+}
+
+double
+LatencyHistogram::getPercentile(double per) const
+{
+    double target = std::max((((double)(_cnt - 1)) * (per / 100.0)), 0.0);
+    size_t before = (size_t)std::floor(target);
+    size_t  after = (size_t)std::ceil(target);
+    double factor = std::ceil(target) - target;
+    return (factor * getN(before) + (1.0 - factor) * getN(after));
+}
+
+string
+LatencyHistogram::Stats::toString(const string &name) const
+{
+    string str = name + " {\n";
+    str += strfmt("  min: %g\n", min);
+    str += strfmt("  avg: %g\n", avg);
+    str += strfmt("  max: %g\n", max);
+    str += strfmt("  50%%: %g\n", per50);
+    str += strfmt("  95%%: %g\n", per95);
+    str += strfmt("  99%%: %g\n", per99);
+    str += "}\n";
+    return str;
+}
+
+LatencyHistogram::LatencyHistogram()
+    : _cnt(0),
+      _min(0.0),
+      _max(0.0),
+      _total(0.0),
+      _hist()
+{
+}
+
+LatencyHistogram::~LatencyHistogram() = default;
+
+void
+LatencyHistogram::add(double latency)
+{
+    if (_cnt == 0 || latency < _min) {
+        _min = latency;
+    }
+    if (_cnt == 0 || latency > _max) {
+        _max = latency;
+    }
+    ++_cnt;
+    _total += latency;
+    size_t idx = bucketOf((uint64_t)(std::max(latency, 0.0) * 1000000.0 + 0.5));
+    if (idx >= _hist.size()) {
+        _hist.resize(idx + 1, 0);
+    }
+    ++_hist[idx];
+}
+
+LatencyHistogram::Stats
+LatencyHistogram::getStats() const
+{
+    Stats stats;
+    stats.min = _min;
+    if (_cnt > 0) {
+        stats.avg = (_total / (double)_cnt);
+    }
+    stats.max = _max;
+    stats.per50 = getPercentile(50.0);
+    stats.per95 = getPercentile(95.0);
+    stats.per99 = getPercentile(99.0);
+    return stats;
+}
+
+} // namespace vbench
@@ -0,0 +1,50 @@
+// Copyright 2019 Oath Inc. Licensed under the terms of the Apache 2.0 license. See LICENSE in the project root.
+
+#pragma once
+
+#include <vbench/core/string.h>
+#include <vector>
+
+namespace vbench {
+
+/**
+ * Keeps track of a set of latencies (in seconds) and calculates
+ * relevant aggregated values.
+ *
+ * Latencies are kept in a log-linear histogram of microseconds with
+ * 1024 buckets per power of two. Latencies below ~1ms are exact, and
+ * larger ones have a relative error below 0.1%, with no upper limit.
+ **/
+class LatencyHistogram
+{
+private:
+    size_t               _cnt;
+    double               _min;
+    double               _max;
+    double               _total;
+    std::vector<size_t>  _hist;
+
+    static size_t bucketOf(uint64_t micros);
+    static double valueOf(size_t bucket);
+    double getN(size_t n) const;
+    double getPercentile(double per) const;
+
+public:
+    struct Stats {
+        double min;
+        double avg;
+        double max;
+        double per50;
+        double per95;
+        double per99;
+        Stats() : min(0), avg(0), max(0), per50(0), per95(0), per99(0) {}
+        string toString(const string &name = "Latency") const;
+    };
+    LatencyHistogram();
+    ~LatencyHistogram();
+    void add(double latency);
+    size_t count() const { return _cnt; }
+    Stats getStats() const;
+};
+
+} // namespace vbench
@@ -0,0 +1,29 @@
+// Copyright 2019 Oath Inc. Licensed under the terms of the Apache 2.0 license. See LICENSE in the project root.
+
+#include "match_phases.h"
+
+namespace vbench {
+
+namespace {
+
+void appendValue(string &str, const char *name, const MatchPhases::Value &value) {
+    if (value.is_set) {
+        str += strfmt("  %s: %g\n", name, value.value);
+    }
+}
+
+} // namespace vbench::<unnamed>
+
+string
+MatchPhases::toString() const
+{
+    string str;
+    appendValue(str, "phase.setup", setup);
+    appendValue(str, "phase.first", first_phase);
+    appendValue(str, "phase.second", second_phase);
+    appendValue(str, "phase.result", result);
+    appendValue(str, "phase.total", total);
+    return str;
+}
+
+} // namespace vbench
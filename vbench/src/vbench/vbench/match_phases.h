@@ -0,0 +1,27 @@
+// Copyright 2019 Oath Inc. Licensed under the terms of the Apache 2.0 license. See LICENSE in the project root.
+
+#pragma once
+
+#include <vbench/core/string.h>
+#include <vbench/http/benchmark_headers.h>
+
+namespace vbench {
+
+/**
+ * Time (in seconds) spent on a content node in the different phases
+ * of a search request, as found in the search trace returned with a
+ * search protocol reply. Values are only set when the request asked
+ * for a trace level that includes them (4 or more).
+ **/
+struct MatchPhases
+{
+    using Value = BenchmarkHeaders::Value;
+    Value setup;        // building the query and fetching postings
+    Value first_phase;  // matching and first phase ranking
+    Value second_phase; // second phase ranking
+    Value result;       // creating and merging the result
+    Value total;        // total time spent on the content node
+    string toString() const;
+};
+
+} // namespace vbench
@@ -3,9 +3,11 @@
 
 #include "native_factory.h"
 #include "request_generator.h"
+#include "captured_request_generator.h"
 #include "server_tagger.h"
 #include "qps_tagger.h"
 #include "latency_analyzer.h"
+#include "phase_analyzer.h"
 #include "qps_analyzer.h"
 #include "request_dumper.h"
 #include "ignore_before.h"
@@ -20,6 +22,10 @@ NativeFactory::createGenerator(const vespalib::slime::Inspector &spec,
     if (type == "RequestGenerator") {
         return Generator::UP(new RequestGenerator(spec["file"].asString().make_string(), next));
     }
+    if (type == "CapturedRequestGenerator") {
+        return Generator::UP(new CapturedRequestGenerator(spec["file"].asString().make_string(),
+                                                          spec["trace_level"].asLong(), next));
+    }
     return Generator::UP();
 }
 
@@ -46,6 +52,9 @@ NativeFactory::createAnalyzer(const vespalib::slime::Inspector &spec,
     if (type == "LatencyAnalyzer") {
         return Analyzer::UP(new LatencyAnalyzer(next));
     }
+    if (type == "PhaseAnalyzer") {
+        return Analyzer::UP(new PhaseAnalyzer(next));
+    }
     if (type == "QpsAnalyzer") {
         return Analyzer::UP(new QpsAnalyzer(next));
     }
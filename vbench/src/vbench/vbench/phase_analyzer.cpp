@@ -0,0 +1,64 @@
+// Copyright 2019 Oath Inc. Licensed under the terms of the Apache 2.0 license. See LICENSE in the project root.
+
+#include "phase_analyzer.h"
+
+namespace vbench {
+
+namespace {
+
+void addValue(LatencyHistogram &hist, const MatchPhases::Value &value) {
+    if (value.is_set) {
+        hist.add(value.value);
+    }
+}
+
+void reportPhase(const char *name, const LatencyHistogram &hist) {
+    if (hist.count() > 0) {
+        fprintf(stdout, "%s\n", hist.getStats().toString(strfmt("Phase %s", name)).c_str());
+    }
+}
+
+} // namespace vbench::<unnamed>
+
+PhaseAnalyzer::PhaseAnalyzer(Handler<Request> &next)
+    : _next(next),
+      _setup(),
+      _firstPhase(),
+      _secondPhase(),
+      _result(),
+      _total()
+{
+}
+
+PhaseAnalyzer::~PhaseAnalyzer() = default;
+
+void
+PhaseAnalyzer::addPhases(const MatchPhases &phases)
+{
+    addValue(_setup, phases.setup);
+    addValue(_firstPhase, phases.first_phase);
+    addValue(_secondPhase, phases.second_phase);
+    addValue(_result, phases.result);
+    addValue(_total, phases.total);
+}
+
+void
+PhaseAnalyzer::handle(Request::UP request)
+{
+    if (request->status() == Request::STATUS_OK) {
+        addPhases(request->phases());
+    }
+    _next.handle(std::move(request));
+}
+
+void
+PhaseAnalyzer::report()
+{
+    reportPhase("setup", _setup);
+    reportPhase("first", _firstPhase);
+    reportPhase("second", _secondPhase);
+    reportPhase("result", _result);
+    reportPhase("total", _total);
+}
+
+} // namespace vbench
@@ -0,0 +1,40 @@
+// Copyright 2019 Oath Inc. Licensed under the terms of the Apache 2.0 license. See LICENSE in the project root.
+
+#pragma once
+
+#include "analyzer.h"
+#include "latency_histogram.h"
+
+namespace vbench {
+
+/**
+ * Component picking up the time spent in the different match phases
+ * on the search node for successful requests sent using the search
+ * protocol, and calculating relevant aggregated values for each
+ * phase.
+ **/
+class PhaseAnalyzer : public Analyzer
+{
+private:
+    Handler<Request> &_next;
+    LatencyHistogram  _setup;
+    LatencyHistogram  _firstPhase;
+    LatencyHistogram  _secondPhase;
+    LatencyHistogram  _result;
+    LatencyHistogram  _total;
+
+public:
+    using Stats = LatencyHistogram::Stats;
+    PhaseAnalyzer(Handler<Request> &next);
+    ~PhaseAnalyzer();
+    void handle(Request::UP request) override;
+    void report() override;
+    void addPhases(const MatchPhases &phases);
+    Stats getSetupStats() const { return _setup.getStats(); }
+    Stats getFirstPhaseStats() const { return _firstPhase.getStats(); }
+    Stats getSecondPhaseStats() const { return _secondPhase.getStats(); }
+    Stats getResultStats() const { return _result.getStats(); }
+    Stats getTotalStats() const { return _total.getStats(); }
+};
+
+} // namespace vbench
@@ -6,12 +6,15 @@ namespace vbench {
 
 Request::Request()
     : _url(),
+      _payload(),
       _server(),
       _scheduledTime(),
       _status(STATUS_OK),
       _startTime(),
       _endTime(),
-      _size(0)
+      _size(0),
+      _headers(),
+      _phases()
 {
 }
 
@@ -39,6 +42,9 @@ Request::toString() const
     string str;
     str += "Request {\n";
     str += strfmt("  url: %s\n", _url.c_str());
+    if (!_payload.empty()) {
+        str += strfmt("  payload: %zu bytes\n", _payload.size());
+    }
     str += strfmt("  server.host: %s\n", _server.host.c_str());
     str += strfmt("  server.port: %d\n", _server.port);
     str += strfmt("  scheduledTime: %g\n", _scheduledTime);
@@ -52,6 +58,7 @@ Request::toString() const
     str += strfmt("  latency: %g\n", latency());
     str += strfmt("  size: %zu\n", _size);
     str += _headers.toString();
+    str += _phases.toString();
     str += "}\n";
     return str;
 }
@@ -2,6 +2,7 @@
 
 #pragma once
 
+#include "match_phases.h"
 #include <vbench/core/string.h>
 #include <vbench/http/benchmark_headers.h>
 #include <vbench/http/server_spec.h>
@@ -28,6 +29,7 @@ public:
 private:
     // parameters to request scheduler
     string     _url;
+    string     _payload;
     ServerSpec _server;
     double     _scheduledTime;
 
@@ -40,6 +42,9 @@ private:
     // benchmark headers from QRS
     BenchmarkHeaders _headers;
 
+    // match phases from search node
+    MatchPhases      _phases;
+
 public:
     Request();
 
@@ -48,6 +53,12 @@ public:
     const string &url() const { return _url; }
     Request &url(const string &value) { _url = value; return *this; }
 
+    // A request with a payload (serialized protobuf search request) is
+    // sent directly to a search node using the search protocol over
+    // rpc instead of using http.
+    const string &payload() const { return _payload; }
+    Request &payload(const string &value) { _payload = value; return *this; }
+
     const ServerSpec &server() const { return _server; }
     Request &server(const ServerSpec &value) { _server = value; return *this; }
 
@@ -67,11 +78,18 @@ public:
 
     double latency() const { return (_endTime - _startTime); }
 
+    size_t size() const { return _size; }
+    Request &size(size_t value) { _size = value; return *this; }
+
     void handleHeader(const string &name, const string &value) override;
     void handleContent(const Memory &data) override;
     void handleFailure(const string &reason) override;
 
     const BenchmarkHeaders &headers() const { return _headers; }
+    BenchmarkHeaders &headers() { return _headers; }
+
+    const MatchPhases &phases() const { return _phases; }
+    MatchPhases &phases() { return _phases; }
 
     string toString() const;
 };
@@ -15,16 +15,22 @@ RequestScheduler::run()
     while (_queue.extract(_timer.sample(), list, sleepTime)) {
         for (size_t i = 0; i < list.size(); ++i) {
             Request::UP request = Request::UP(list[i].release());
-            _dispatcher.handle(std::move(request));
+            if (request->payload().empty()) {
+                _dispatcher.handle(std::move(request));
+            } else {
+                _rpcClient.search(std::move(request));
+            }
         }
         list.clear();
         thread.slumber(sleepTime);
     }
 }
 
-RequestScheduler::RequestScheduler(CryptoEngine::SP crypto, Handler<Request> &next, size_t numWorkers)
+RequestScheduler::RequestScheduler(CryptoEngine::SP crypto, Handler<Request> &next,
+                                   size_t numWorkers, size_t maxRpcPending)
     : _timer(),
       _proxy(next),
+      _rpcClient(crypto, _timer, _proxy, maxRpcPending),
       _queue(10.0, 0.020),
       _droppedTagger(_proxy),
       _dispatcher(_droppedTagger),
@@ -75,6 +81,7 @@ RequestScheduler::join()
     for (size_t i = 0; i < _workers.size(); ++i) {
         _workers[i]->join();
     }
+    _rpcClient.waitForPending();
     _proxy.join();
 }
 
@@ -5,6 +5,7 @@
 #include "worker.h"
 #include "dropped_tagger.h"
 #include <vbench/core/time_queue.h>
+#include <vbench/rpc/search_protocol_client.h>
 #include <vbench/core/dispatcher.h>
 #include <vbench/core/handler_thread.h>
 #include <vespa/vespalib/util/sync.h>
@@ -15,7 +16,8 @@ namespace vbench {
 /**
  * Component responsible for dispatching requests to workers at the
  * appropriate time based on what start time the requests are tagged
- * with.
+ * with. Requests with a payload are sent using the search protocol
+ * rpc client instead of the http workers.
  **/
 class RequestScheduler : public Handler<Request>,
                          public vespalib::Runnable,
@@ -24,6 +26,7 @@ class RequestScheduler : public Handler<Request>,
 private:
     Timer                   _timer;
     HandlerThread<Request>  _proxy;
+    SearchProtocolClient    _rpcClient;
     TimeQueue<Request>      _queue;
     DroppedTagger           _droppedTagger;
     Dispatcher<Request>     _dispatcher;
@@ -35,7 +38,7 @@ private:
 public:
     typedef std::unique_ptr<RequestScheduler> UP;
     using CryptoEngine = vespalib::CryptoEngine;
-    RequestScheduler(CryptoEngine::SP crypto, Handler<Request> &next, size_t numWorkers);
+    RequestScheduler(CryptoEngine::SP crypto, Handler<Request> &next, size_t numWorkers, size_t maxRpcPending);
     void abort();
     void handle(Request::UP request) override;
     void start() override;
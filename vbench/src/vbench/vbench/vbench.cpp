@@ -12,6 +12,9 @@ namespace {
 
 using IllArg = vespalib::IllegalArgumentException;
 
+// default max number of search protocol requests waiting for a reply
+constexpr size_t default_rpc_max_pending = 1000;
+
 string maybe_load(const vespalib::slime::Inspector &file_ref) {
     if (file_ref.valid()) {
         string file_name = file_ref.asString().make_string();
@@ -54,9 +57,12 @@ VBench::VBench(const vespalib::Slime &cfg)
             _analyzers.push_back(Analyzer::UP(obj.release()));
         }
     }
+    vespalib::slime::Inspector &rpc_max_pending = cfg.get()["rpc_max_pending"];
     _scheduler.reset(new RequestScheduler(crypto,
                                           *_analyzers.back(),
-                                          cfg.get()["http_threads"].asLong()));
+                                          cfg.get()["http_threads"].asLong(),
+                                          rpc_max_pending.valid() ? rpc_max_pending.asLong()
+                                                                  : default_rpc_max_pending));
     vespalib::slime::Inspector &inputs = cfg.get()["inputs"];
     for (size_t i = inputs.children(); i-- > 0; ) {
         vespalib::slime::Inspector &input = inputs[i];
@@ -3,9 +3,11 @@
 #pragma once
 
 #include "analyzer.h"
+#include "captured_request_generator.h"
 #include "generator.h"
 #include "latency_analyzer.h"
 #include "native_factory.h"
+#include "phase_analyzer.h"
 #include "qps_analyzer.h"
 #include "qps_tagger.h"
 #include "request_generator.h"
@@ -114,6 +114,13 @@ configure_huge_pages () {
     fi
 }
 
+configure_transparent_huge_pages () {
+    if check_bname_in_value $VESPA_USE_TRANSPARENT_HUGEPAGES_LIST; then
+        log_debug_message "Want transparent huge pages for '$bname' since VESPA_USE_TRANSPARENT_HUGEPAGES_LIST=${VESPA_USE_TRANSPARENT_HUGEPAGES_LIST}"
+        export VESPA_MMAP_TRANSPARENT_HUGEPAGES="yes"
+    fi
+}
+
 configure_use_madvise () {
     for f in $VESPA_USE_MADVISE_LIST
     do
@@ -181,6 +188,7 @@ configure_numa_ctl () {
 
 configure_valgrind
 configure_huge_pages
+configure_transparent_huge_pages
 configure_use_madvise
 configure_vespa_malloc
 
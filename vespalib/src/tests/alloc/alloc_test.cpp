@@ -248,4 +248,59 @@ TEST("auto alloced mmap alloc can not be shrinked below HUGEPAGE_SIZE/2 + 1 ") {
     EXPECT_EQUAL(SZ, buf.size());
 }
 
+TEST("mmapped buffers are huge page aligned when using transparent huge pages") {
+    if (getenv("VESPA_MMAP_TRANSPARENT_HUGEPAGES") == nullptr) {
+        return; // Only checked when run with VESPA_MMAP_TRANSPARENT_HUGEPAGES set
+    }
+    for (size_t sz : {size_t(MemoryAllocator::HUGEPAGE_SIZE), size_t(3 * MemoryAllocator::HUGEPAGE_SIZE)}) {
+        Alloc buf = Alloc::allocMMap(sz);
+        EXPECT_EQUAL(sz, buf.size());
+        EXPECT_EQUAL(0u, reinterpret_cast<uintptr_t>(buf.get()) % MemoryAllocator::HUGEPAGE_SIZE);
+        memset(buf.get(), 0x55, buf.size());
+    }
+    Alloc buf = Alloc::alloc(MemoryAllocator::HUGEPAGE_SIZE + 1);
+    EXPECT_EQUAL(2u * MemoryAllocator::HUGEPAGE_SIZE, buf.size());
+    EXPECT_EQUAL(0u, reinterpret_cast<uintptr_t>(buf.get()) % MemoryAllocator::HUGEPAGE_SIZE);
+}
+
+TEST("mmap policy settings are read from a comma separated list") {
+    MMapPolicy::Settings settings = MMapPolicy::Settings::fromString(nullptr);
+    EXPECT_FALSE(settings.transparentHugePages);
+    EXPECT_FALSE(settings.prefault);
+    EXPECT_FALSE(settings.interleave);
+    settings = MMapPolicy::Settings::fromString("prefault,thp");
+    EXPECT_TRUE(settings.transparentHugePages);
+    EXPECT_TRUE(settings.prefault);
+    EXPECT_FALSE(settings.interleave);
+    settings = MMapPolicy::Settings::fromString("interleave,unknown,");
+    EXPECT_FALSE(settings.transparentHugePages);
+    EXPECT_FALSE(settings.prefault);
+    EXPECT_TRUE(settings.interleave);
+}
+
+TEST("mmap policy is applied to and accounts for mmapped buffers") {
+    static constexpr size_t SZ = MemoryAllocator::HUGEPAGE_SIZE;
+    MMapPolicy policy(MMapPolicy::Settings::fromString("thp,prefault,interleave"));
+    {
+        Alloc small = Alloc::alloc(100, policy);
+        EXPECT_EQUAL(100ul, small.size());
+        Alloc buf = Alloc::alloc(3 * SZ + 1, policy);
+        EXPECT_EQUAL(4 * SZ, buf.size());
+        EXPECT_EQUAL(0u, reinterpret_cast<uintptr_t>(buf.get()) % SZ);
+        MMapPolicy::Stats stats = policy.getStats();
+        EXPECT_EQUAL(1u, stats.mmaps);
+        EXPECT_EQUAL(4 * SZ, stats.mappedBytes);
+        EXPECT_EQUAL(4 * SZ, stats.prefaultedBytes);
+        EXPECT_TRUE(buf.resize_inplace(2 * SZ));
+        EXPECT_EQUAL(2 * SZ, policy.getStats().mappedBytes);
+        Alloc created = buf.create(SZ);
+        EXPECT_EQUAL(2u, policy.getStats().mmaps);
+        EXPECT_EQUAL(3 * SZ, policy.getStats().mappedBytes);
+    }
+    MMapPolicy::Stats stats = policy.getStats();
+    EXPECT_EQUAL(2u, stats.mmaps);
+    EXPECT_EQUAL(0u, stats.mappedBytes);
+    EXPECT_EQUAL(5 * SZ, stats.prefaultedBytes);
+}
+
 TEST_MAIN() { TEST_RUN_ALL(); }
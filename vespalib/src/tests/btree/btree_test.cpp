@@ -3,6 +3,7 @@
 LOG_SETUP("btree_test");
 #include <vespa/vespalib/testkit/testapp.h>
 #include <string>
+#include <limits>
 #include <vespa/vespalib/btree/btreeroot.h>
 #include <vespa/vespalib/btree/btreebuilder.h>
 #include <vespa/vespalib/btree/btreenodeallocator.h>
@@ -185,6 +186,9 @@ private:
     void requireThatTreeRemoveStealWorks();
     void requireThatNodeRemoveWorks();
     void requireThatNodeLowerBoundWorks();
+    template <typename KeyT, uint32_t NumSlots>
+    void requireThatNodeKeySearchWorksT();
+    void requireThatNodeKeySearchWorks();
     void requireThatWeCanInsertAndRemoveFromTree();
     void requireThatSortedTreeInsertWorks();
     void requireThatCornerCaseTreeFindWorks();
@@ -669,6 +673,49 @@ Test::requireThatNodeLowerBoundWorks()
     cleanup(g, m, nPair.ref, n);
 }
 
+template <typename KeyT>
+struct PlainLess {
+    bool operator()(const KeyT &lhs, const KeyT &rhs) const { return lhs < rhs; }
+};
+
+template <typename KeyT, uint32_t NumSlots>
+void
+Test::requireThatNodeKeySearchWorksT()
+{
+    using Search = BTreeNodeKeySearch<KeyT, std::less<KeyT>, NumSlots>;
+    using BinarySearch = BTreeNodeKeySearch<KeyT, PlainLess<KeyT>, NumSlots>;
+    Rand48 rnd;
+    rnd.srand48(42);
+    KeyT keys[NumSlots];
+    for (uint32_t validSlots = 0; validSlots <= NumSlots; ++validSlots) {
+        for (uint32_t i = 0; i < NumSlots; ++i) {
+            // Keys from both ends of the value range, to check signed and unsigned compare
+            keys[i] = (rnd.lrand48() % 4 == 0) ? std::numeric_limits<KeyT>::max() - KeyT(rnd.lrand48() % 3) : KeyT(rnd.lrand48() % 40);
+        }
+        std::sort(keys, keys + validSlots);
+        for (uint32_t sidx = 0; sidx <= validSlots; ++sidx) {
+            for (KeyT key : { KeyT(0), KeyT(1), KeyT(17), KeyT(39), KeyT(40), std::numeric_limits<KeyT>::max(),
+                              std::numeric_limits<KeyT>::min(), KeyT(std::numeric_limits<KeyT>::max() - 1) }) {
+                EXPECT_EQUAL(BinarySearch::lower_bound(keys, sidx, validSlots, key, PlainLess<KeyT>()),
+                             Search::lower_bound(keys, sidx, validSlots, key, std::less<KeyT>()));
+                EXPECT_EQUAL(BinarySearch::upper_bound(keys, sidx, validSlots, key, PlainLess<KeyT>()),
+                             Search::upper_bound(keys, sidx, validSlots, key, std::less<KeyT>()));
+            }
+        }
+    }
+}
+
+void
+Test::requireThatNodeKeySearchWorks()
+{
+    requireThatNodeKeySearchWorksT<uint32_t, 16>();
+    requireThatNodeKeySearchWorksT<uint32_t, 64>();
+    requireThatNodeKeySearchWorksT<uint32_t, 6>();
+    requireThatNodeKeySearchWorksT<int32_t, 16>();
+    requireThatNodeKeySearchWorksT<uint64_t, 16>();
+    requireThatNodeKeySearchWorksT<int64_t, 32>();
+}
+
 void
 generateData(std::vector<LeafPair> & data, size_t numEntries)
 {
@@ -1503,6 +1550,7 @@ Test::Main()
     requireThatTreeRemoveStealWorks();
     requireThatNodeRemoveWorks();
     requireThatNodeLowerBoundWorks();
+    requireThatNodeKeySearchWorks();
     requireThatWeCanInsertAndRemoveFromTree();
     requireThatSortedTreeInsertWorks();
     requireThatCornerCaseTreeFindWorks();
@@ -0,0 +1,214 @@
+// Copyright 2019 Oath Inc. Licensed under the terms of the Apache 2.0 license. See LICENSE in the project root.
+
+#include <vespa/vespalib/btree/btreeroot.h>
+#include <vespa/vespalib/btree/btreenodeallocator.h>
+#include <vespa/vespalib/btree/btree.h>
+#include <vespa/vespalib/btree/btreenodeallocator.hpp>
+#include <vespa/vespalib/btree/btreenode.hpp>
+#include <vespa/vespalib/btree/btreenodestore.hpp>
+#include <vespa/vespalib/btree/btreeiterator.hpp>
+#include <vespa/vespalib/btree/btreeroot.hpp>
+#include <vespa/vespalib/btree/btree.hpp>
+#include <vespa/vespalib/util/rand48.h>
+#include <vespa/vespalib/util/time.h>
+
+#include <vespa/fastos/app.h>
+
+#include <vespa/log/log.h>
+LOG_SETUP("keysearchspeed");
+
+namespace search::btree {
+
+enum class KeySearchMethod
+{
+    INSERT,
+    FIND,
+    SEEK
+};
+
+/**
+ * Comparator giving the same order as std::less, but hiding it from
+ * the node key search, which then falls back to binary search.
+ */
+template <typename KeyT>
+struct BinarySearchLess {
+    bool operator()(const KeyT &lhs, const KeyT &rhs) const { return lhs < rhs; }
+};
+
+class KeySearchSpeed : public FastOS_Application
+{
+    template <typename KeyT, typename CompareT, typename Traits, KeySearchMethod method>
+    void
+    workLoop(int loops, bool enableInsert, bool enableFind, bool enableSeek,
+             int leafSlots, const char *searchName);
+    template <typename KeyT, typename Traits>
+    void
+    workLoops(int loops, bool enableInsert, bool enableFind, bool enableSeek, int leafSlots);
+    void usage();
+    int Main() override;
+};
+
+
+namespace {
+
+const char *methodName(KeySearchMethod method)
+{
+    switch (method) {
+    case KeySearchMethod::INSERT:
+        return "insert";
+    case KeySearchMethod::FIND:
+        return "find";
+    default:
+        return "seek";
+    }
+}
+
+}
+
+template <typename KeyT, typename CompareT, typename Traits, KeySearchMethod method>
+void
+KeySearchSpeed::workLoop(int loops, bool enableInsert, bool enableFind, bool enableSeek,
+                         int leafSlots, const char *searchName)
+{
+    if ((method == KeySearchMethod::INSERT && !enableInsert) ||
+        (method == KeySearchMethod::FIND && !enableFind) ||
+        (method == KeySearchMethod::SEEK && !enableSeek) ||
+        (leafSlots != 0 &&
+         leafSlots != static_cast<int>(Traits::LEAF_SLOTS)))
+        return;
+    using Tree = BTree<KeyT, BTreeNoLeafData, btree::NoAggregated, CompareT, Traits>;
+    using ConstIterator = typename Tree::ConstIterator;
+    size_t numEntries = 1000000;
+    std::vector<KeyT> keys;
+    Rand48 rnd;
+    rnd.srand48(42);
+    for (size_t i = 0; i < numEntries; ++i) {
+        keys.push_back(rnd.lrand48() % (numEntries * 4));
+    }
+    Tree tree;
+    if (method != KeySearchMethod::INSERT) {
+        for (KeyT key : keys) {
+            tree.insert(key, BTreeNoLeafData());
+        }
+        assert(tree.isValid());
+    }
+    for (int l = 0; l < loops; ++l) {
+        vespalib::Timer timer;
+        uint64_t sum = 0;
+        size_t steps = 0;
+        if (method == KeySearchMethod::INSERT) {
+            tree.clear();
+            for (KeyT key : keys) {
+                sum += tree.insert(key, BTreeNoLeafData()) ? 1 : 0;
+            }
+            steps = keys.size();
+        } else if (method == KeySearchMethod::FIND) {
+            for (KeyT key : keys) {
+                ConstIterator itr = tree.lowerBound(key);
+                sum += itr.valid() ? itr.getKey() : 0;
+            }
+            steps = keys.size();
+        } else {
+            // Posting list style iteration, skipping a few keys forward at a time
+            for (uint32_t stride = 1; stride < 64; stride *= 2) {
+                ConstIterator itr = tree.begin();
+                KeyT key = 0;
+                while (itr.valid()) {
+                    key = itr.getKey() + stride;
+                    itr.seek(key);
+                    sum += itr.valid() ? itr.getKey() : 0;
+                    ++steps;
+                }
+            }
+        }
+        double used = vespalib::to_s(timer.elapsed());
+        printf("Elapsed time for %zu %s steps is %8.5f (%6.2f ns/step), "
+               "key=%zu bytes, search=%s, fanout=%u,%u, sum=%" PRIu64 "\n",
+               steps,
+               methodName(method),
+               used,
+               used * 1e9 / steps,
+               sizeof(KeyT),
+               searchName,
+               static_cast<int>(Traits::LEAF_SLOTS),
+               static_cast<int>(Traits::INTERNAL_SLOTS),
+               sum);
+        fflush(stdout);
+    }
+}
+
+template <typename KeyT, typename Traits>
+void
+KeySearchSpeed::workLoops(int loops, bool enableInsert, bool enableFind, bool enableSeek, int leafSlots)
+{
+    workLoop<KeyT, BinarySearchLess<KeyT>, Traits, KeySearchMethod::INSERT>(loops, enableInsert, enableFind, enableSeek, leafSlots, "binary");
+    workLoop<KeyT, std::less<KeyT>, Traits, KeySearchMethod::INSERT>(loops, enableInsert, enableFind, enableSeek, leafSlots, "std::less");
+    workLoop<KeyT, BinarySearchLess<KeyT>, Traits, KeySearchMethod::FIND>(loops, enableInsert, enableFind, enableSeek, leafSlots, "binary");
+    workLoop<KeyT, std::less<KeyT>, Traits, KeySearchMethod::FIND>(loops, enableInsert, enableFind, enableSeek, leafSlots, "std::less");
+    workLoop<KeyT, BinarySearchLess<KeyT>, Traits, KeySearchMethod::SEEK>(loops, enableInsert, enableFind, enableSeek, leafSlots, "binary");
+    workLoop<KeyT, std::less<KeyT>, Traits, KeySearchMethod::SEEK>(loops, enableInsert, enableFind, enableSeek, leafSlots, "std::less");
+}
+
+
+void
+KeySearchSpeed::usage()
+{
+    printf("keysearchspeed "
+           "[-F <leafSlots>] "
+           "[-c <numLoops>] "
+           "[-f] "
+           "[-i] "
+           "[-s]\n");
+}
+
+int
+KeySearchSpeed::Main()
+{
+    int argi;
+    char c;
+    const char *optArg;
+    argi = 1;
+    int loops = 1;
+    bool insert = false;
+    bool find = false;
+    bool seek = false;
+    int leafSlots = 0;
+    while ((c = GetOpt("F:c:fis", optArg, argi)) != -1) {
+        switch (c) {
+        case 'F':
+            leafSlots = atoi(optArg);
+            break;
+        case 'c':
+            loops = atoi(optArg);
+            break;
+        case 'f':
+            find = true;
+            break;
+        case 'i':
+            insert = true;
+            break;
+        case 's':
+            seek = true;
+            break;
+        default:
+            usage();
+            return 1;
+        }
+    }
+    if (!insert && !find && !seek) {
+        insert = true;
+        find = true;
+        seek = true;
+    }
+
+    using DefTraits = BTreeDefaultTraits;
+    using LargeTraits = BTreeTraits<32, 16, 10, true>;
+    workLoops<uint32_t, DefTraits>(loops, insert, find, seek, leafSlots);
+    workLoops<uint32_t, LargeTraits>(loops, insert, find, seek, leafSlots);
+    workLoops<uint64_t, DefTraits>(loops, insert, find, seek, leafSlots);
+    return 0;
+}
+
+}
+
+FASTOS_MAIN(search::btree::KeySearchSpeed);
@@ -3,6 +3,7 @@
 #include <vespa/vespalib/test/datastore/buffer_stats.h>
 #include <vespa/vespalib/test/datastore/memstats.h>
 #include <vespa/vespalib/datastore/array_store.hpp>
+#include <vespa/vespalib/datastore/incremental_compaction.h>
 #include <vespa/vespalib/testkit/testapp.h>
 #include <vespa/vespalib/test/insertion_operators.h>
 #include <vespa/vespalib/util/traits.h>
@@ -343,6 +344,49 @@ TEST_F("require that compactWorst selects on neither memory nor address space",
     testCompaction(f, false, false);
 }
 
+TEST_F("require that incremental compaction moves entries in slices", NumberFixture(3))
+{
+    for (uint32_t i = 0; i < 10; ++i) {
+        f.add({i, i});
+    }
+    f.remove({0, 0});
+    f.remove({1, 1});
+    f.trimHoldLists();
+    std::vector<EntryRef> refs;
+    for (const auto &elem : f.refStore) {
+        refs.push_back(elem.first);
+    }
+    std::vector<EntryRef> compactedRefs = refs;
+    uint32_t oldBufferId = f.getBufferId(refs[0]);
+
+    IncrementalCompaction compaction(3);
+    compaction.start(f.store.compactWorst(true, false));
+    EXPECT_TRUE(compaction.active());
+    EXPECT_FALSE(compaction.compactSlice(ArrayRef<EntryRef>(compactedRefs)));
+    EXPECT_NOT_EQUAL(oldBufferId, f.getBufferId(compactedRefs[2]));
+    EXPECT_EQUAL(refs[3].ref(), compactedRefs[3].ref());
+    EXPECT_FALSE(f.store.bufferState(refs[0]).isOnHold());
+    // Entries added while compacting are not put in the compacting buffer
+    EXPECT_NOT_EQUAL(oldBufferId, f.getBufferId(f.add({11, 11})));
+    compactedRefs.pop_back(); // lid space shrinks
+    EXPECT_FALSE(compaction.compactSlice(ArrayRef<EntryRef>(compactedRefs)));
+    EXPECT_TRUE(compaction.compactSlice(ArrayRef<EntryRef>(compactedRefs)));
+    EXPECT_FALSE(compaction.active());
+    for (size_t i = 0; i < compactedRefs.size(); ++i) {
+        EXPECT_NOT_EQUAL(oldBufferId, f.getBufferId(compactedRefs[i]));
+        TEST_DO(f.assertGet(compactedRefs[i], f.refStore[refs[i]]));
+    }
+    f.assertGet(refs[0], f.refStore[refs[0]]); // Old ref should still point to data.
+    EXPECT_TRUE(f.store.bufferState(refs[0]).isOnHold());
+    f.trimHoldLists();
+    EXPECT_TRUE(f.store.bufferState(refs[0]).isFree());
+
+    const auto &stats = compaction.getStats();
+    EXPECT_EQUAL(1u, stats.compactions);
+    EXPECT_EQUAL(3u, stats.slices);
+    EXPECT_EQUAL(7u, stats.refs);
+}
+
 TEST_F("require that used, onHold and dead memory usage is tracked for small arrays", NumberFixture(2))
 {
     MemStats exp(f.store.getMemoryUsage());
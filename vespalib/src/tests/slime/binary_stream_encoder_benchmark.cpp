@@ -0,0 +1,164 @@
+// Copyright 2019 Oath Inc. Licensed under the terms of the Apache 2.0 license. See LICENSE in the project root.
+#include <vespa/vespalib/testkit/test_kit.h>
+#include <vespa/vespalib/util/stringfmt.h>
+#include <vespa/vespalib/data/slime/slime.h>
+#include <vespa/vespalib/data/slime/binary_stream_encoder.h>
+
+using namespace vespalib;
+using namespace vespalib::slime::convenience;
+using vespalib::slime::BinaryStreamEncoder;
+using vespalib::slime::SymbolTable;
+
+/**
+ * Encodes 1000 docsums, one buffer per hit, the way proton does for the
+ * docsum reply: either by building a Slime per hit and encoding it, or by
+ * streaming the fields directly using a symbol table per summary class.
+ * The sparse case uses a summary class with many more fields than the
+ * ones present in each docsum.
+ **/
+
+constexpr size_t NUM_HITS = 1000;
+constexpr size_t NUM_FIELDS = 12;
+
+struct MyBuffer : public Output {
+    std::vector<char> data;
+    size_t            used;
+    MyBuffer() : data(16 * 1024 * 1024), used(0) {}
+    ~MyBuffer();
+    WritableMemory reserve(size_t bytes) override {
+        assert(data.size() >= (used + bytes));
+        return WritableMemory(&data[used], data.size() - used);
+    }
+    Output &commit(size_t bytes) override {
+        used += bytes;
+        return *this;
+    }
+};
+
+MyBuffer::~MyBuffer() = default;
+
+struct SummaryClass {
+    std::vector<vespalib::string> names;
+    SymbolTable symbols;
+    vespalib::string title;
+    vespalib::string body;
+    explicit SummaryClass(size_t numClassFields = NUM_FIELDS)
+        : names(), symbols(), title("a title of moderate length"), body(400, 'x')
+    {
+        for (size_t i = 0; i < numClassFields; ++i) {
+            names.push_back(make_string("summary_field_%zu", i));
+            symbols.insert(names.back());
+        }
+    }
+    ~SummaryClass();
+};
+
+SummaryClass::~SummaryClass() = default;
+
+void insertDocsum(const SummaryClass &cls, size_t hit, Cursor &docsum) {
+    for (size_t i = 0; i < NUM_FIELDS; ++i) {
+        Memory name(cls.names[i]);
+        switch (i % 4) {
+        case 0: docsum.setLong(name, hit * i); break;
+        case 1: docsum.setDouble(name, 0.017 * hit); break;
+        case 2: docsum.setString(name, cls.title); break;
+        case 3: docsum.setString(name, cls.body); break;
+        }
+    }
+}
+
+void writeDocsum(const SummaryClass &cls, size_t hit, BinaryStreamEncoder &encoder) {
+    encoder.openObject();
+    for (size_t i = 0; i < NUM_FIELDS; ++i) {
+        encoder.field(Symbol(i));
+        switch (i % 4) {
+        case 0: encoder.writeLong(hit * i); break;
+        case 1: encoder.writeDouble(0.017 * hit); break;
+        case 2: encoder.writeString(cls.title); break;
+        case 3: encoder.writeString(cls.body); break;
+        }
+    }
+    encoder.close();
+}
+
+template <typename F>
+void benchmark(const char *name, F &&encodeReply) {
+    size_t size = 0;
+    double minTime = 1000000.0;
+    MyBuffer buffer;
+    for (size_t i = 0; i < 16; ++i) {
+        vespalib::Timer timer;
+        for (size_t j = 0; j < 16; ++j) {
+            buffer.used = 0;
+            encodeReply(buffer);
+        }
+        minTime = std::min(minTime, vespalib::count_ms(timer.elapsed()) / 16.0);
+        size = buffer.used;
+    }
+    fprintf(stderr, "%s: %g ms per %zu hits (size: %zu bytes)\n", name, minTime, NUM_HITS, size);
+}
+
+TEST_F("slime tree -> binary docsums", SummaryClass()) {
+    const SummaryClass &cls = f1;
+    benchmark("slime tree", [&cls](MyBuffer &buffer) {
+                  auto symbols = std::make_unique<SymbolTable>();
+                  for (size_t hit = 0; hit < NUM_HITS; ++hit) {
+                      Slime slime(Slime::Params(std::move(symbols)));
+                      insertDocsum(cls, hit, slime.setObject());
+                      slime::BinaryFormat::encode(slime, buffer);
+                      symbols = Slime::reclaimSymbols(std::move(slime));
+                  }
+              });
+}
+
+TEST_F("streamed binary docsums", SummaryClass()) {
+    const SummaryClass &cls = f1;
+    BinaryStreamEncoder encoder;
+    benchmark("streamed", [&cls, &encoder](MyBuffer &buffer) {
+                  for (size_t hit = 0; hit < NUM_HITS; ++hit) {
+                      encoder.reset(&cls.symbols);
+                      writeDocsum(cls, hit, encoder);
+                      encoder.flush(buffer);
+                  }
+              });
+}
+
+TEST_F("streamed binary docsums, sparse summary class", SummaryClass(8 * NUM_FIELDS)) {
+    const SummaryClass &cls = f1;
+    BinaryStreamEncoder encoder;
+    benchmark("streamed (sparse)", [&cls, &encoder](MyBuffer &buffer) {
+                  for (size_t hit = 0; hit < NUM_HITS; ++hit) {
+                      encoder.reset(&cls.symbols);
+                      writeDocsum(cls, hit, encoder);
+                      encoder.flush(buffer);
+                  }
+              });
+}
+
+TEST_F("require that streamed docsum matches slime tree docsum", SummaryClass()) {
+    Slime slime;
+    insertDocsum(f1, 7, slime.setObject());
+    BinaryStreamEncoder encoder;
+    encoder.reset(&f1.symbols);
+    writeDocsum(f1, 7, encoder);
+    SimpleBuffer expect;
+    SimpleBuffer actual;
+    slime::BinaryFormat::encode(slime, expect);
+    encoder.flush(actual);
+    EXPECT_EQUAL(expect.get(), actual.get());
+}
+
+TEST_F("require that streamed sparse docsum matches slime tree docsum", SummaryClass(8 * NUM_FIELDS)) {
+    Slime slime;
+    insertDocsum(f1, 7, slime.setObject());
+    BinaryStreamEncoder encoder;
+    encoder.reset(&f1.symbols);
+    writeDocsum(f1, 7, encoder);
+    SimpleBuffer expect;
+    SimpleBuffer actual;
+    slime::BinaryFormat::encode(slime, expect);
+    encoder.flush(actual);
+    EXPECT_EQUAL(expect.get(), actual.get());
+}
+
+TEST_MAIN() { TEST_RUN_ALL(); }
@@ -0,0 +1,207 @@
+// Copyright 2019 Oath Inc. Licensed under the terms of the Apache 2.0 license. See LICENSE in the project root.
+#include <vespa/vespalib/testkit/test_kit.h>
+#include <vespa/vespalib/data/slime/slime.h>
+#include <vespa/vespalib/data/slime/binary_stream_encoder.h>
+#include <vespa/vespalib/data/simple_buffer.h>
+#include <vespa/vespalib/util/stringfmt.h>
+
+using namespace vespalib::slime::convenience;
+using namespace vespalib::slime;
+using namespace vespalib;
+
+vespalib::string encodeAsJson(const BinaryStreamEncoder &encoder) {
+    SimpleBuffer buf;
+    encoder.flush(buf);
+    Slime slime;
+    EXPECT_EQUAL(buf.get().size, BinaryFormat::decode(buf.get(), slime));
+    return slime.toString();
+}
+
+void fillNested(Slime &slime) {
+    Cursor &obj = slime.setObject();
+    obj.setNix("nix");
+    obj.setBool("bool", true);
+    obj.setLong("long", -123456);
+    obj.setDouble("double", 2.5);
+    obj.setString("string", "foo");
+    obj.setData("data", "bar");
+    Cursor &arr = obj.setArray("array");
+    arr.addLong(1);
+    arr.addObject().setLong("long", 2);
+}
+
+void writeNested(BinaryStreamEncoder &encoder) {
+    encoder.openObject();
+    encoder.field(Memory("nix"));
+    encoder.writeNix();
+    encoder.field(Memory("bool"));
+    encoder.writeBool(true);
+    encoder.field(Memory("long"));
+    encoder.writeLong(-123456);
+    encoder.field(Memory("double"));
+    encoder.writeDouble(2.5);
+    encoder.field(Memory("string"));
+    encoder.writeString("foo");
+    encoder.field(Memory("data"));
+    encoder.writeData("bar");
+    encoder.field(Memory("array"));
+    encoder.openArray();
+    encoder.writeLong(1);
+    encoder.openObject();
+    encoder.field(Memory("long"));
+    encoder.writeLong(2);
+    encoder.close();
+    encoder.close();
+    encoder.close();
+}
+
+TEST("require that streamed value is encoded like slime") {
+    Slime slime;
+    fillNested(slime);
+    BinaryStreamEncoder encoder;
+    encoder.reset();
+    EXPECT_TRUE(encoder.empty());
+    writeNested(encoder);
+    EXPECT_FALSE(encoder.empty());
+    SimpleBuffer expect;
+    SimpleBuffer actual;
+    BinaryFormat::encode(slime, expect);
+    encoder.flush(actual);
+    EXPECT_EQUAL(expect.get(), actual.get());
+}
+
+TEST("require that large arrays and objects get patched headers") {
+    Slime slime;
+    Cursor &obj = slime.setObject();
+    Cursor &arr = obj.setArray("array");
+    BinaryStreamEncoder encoder;
+    encoder.reset();
+    encoder.openObject();
+    encoder.field(Memory("array"));
+    encoder.openArray();
+    for (size_t i = 0; i < 1000; ++i) {
+        arr.addLong(i);
+        encoder.writeLong(i);
+    }
+    encoder.close();
+    for (size_t i = 0; i < 40; ++i) {
+        vespalib::string name = vespalib::make_string("field_%zu", i);
+        obj.setString(name, name);
+        encoder.field(Memory(name));
+        encoder.writeString(name);
+    }
+    encoder.close();
+    SimpleBuffer expect;
+    SimpleBuffer actual;
+    BinaryFormat::encode(slime, expect);
+    encoder.flush(actual);
+    EXPECT_EQUAL(expect.get(), actual.get());
+}
+
+TEST("require that preset symbols are used before local symbols") {
+    SymbolTable preset;
+    Symbol foo = preset.insert("foo");
+    preset.insert("unused");
+    BinaryStreamEncoder encoder;
+    encoder.reset(&preset);
+    EXPECT_EQUAL(foo.getValue(), encoder.resolve("foo").getValue());
+    EXPECT_EQUAL(2u, encoder.resolve("bar").getValue());
+    EXPECT_EQUAL(2u, encoder.resolve("bar").getValue());
+    encoder.openObject();
+    encoder.field(foo);
+    encoder.writeLong(1);
+    encoder.field(Memory("bar"));
+    encoder.writeLong(2);
+    encoder.close();
+    Slime expect;
+    Cursor &obj = expect.setObject();
+    obj.setLong("foo", 1);
+    obj.setLong("bar", 2);
+    EXPECT_EQUAL(expect.toString(), encodeAsJson(encoder));
+    encoder.reset(&preset);
+    EXPECT_EQUAL(2u, encoder.resolve("baz").getValue());
+}
+
+TEST("require that only used symbols are written in order of first use") {
+    SymbolTable preset;
+    for (size_t i = 0; i < 100; ++i) {
+        preset.insert(make_string("field_%zu", i));
+    }
+    BinaryStreamEncoder encoder;
+    for (size_t round = 0; round < 2; ++round) {
+        encoder.reset(&preset);
+        encoder.openObject();
+        encoder.field(Symbol(42));
+        encoder.writeLong(1);
+        encoder.field(Memory("local"));
+        encoder.writeLong(2);
+        encoder.field(Symbol(7));
+        encoder.openObject();
+        encoder.field(Symbol(42));
+        encoder.writeLong(3);
+        encoder.close();
+        encoder.close();
+        Slime slime;
+        Cursor &obj = slime.setObject();
+        obj.setLong("field_42", 1);
+        obj.setLong("local", 2);
+        obj.setObject("field_7").setLong("field_42", 3);
+        SimpleBuffer expect;
+        SimpleBuffer actual;
+        BinaryFormat::encode(slime, expect);
+        encoder.flush(actual);
+        EXPECT_EQUAL(expect.get(), actual.get());
+    }
+}
+
+TEST("require that inspected value can be written") {
+    Slime slime;
+    fillNested(slime);
+    BinaryStreamEncoder encoder;
+    encoder.reset();
+    encoder.writeValue(slime.get());
+    EXPECT_EQUAL(slime.toString(), encodeAsJson(encoder));
+}
+
+TEST("require that binary value can be written with remapped symbols") {
+    Slime slime;
+    fillNested(slime);
+    SimpleBuffer binary;
+    BinaryFormat::encode(slime, binary);
+    SymbolTable preset;
+    preset.insert("other");
+    preset.insert("long");
+    BinaryStreamEncoder encoder;
+    encoder.reset(&preset);
+    encoder.openObject();
+    encoder.field(Memory("value"));
+    EXPECT_EQUAL(binary.get().size, encoder.writeBinary(binary.get()));
+    encoder.close();
+    Slime expect;
+    inject(slime.get(), ObjectInserter(expect.setObject(), "value"));
+    EXPECT_EQUAL(expect.toString(), encodeAsJson(encoder));
+    // Only used symbols are written
+    SimpleBuffer expectBinary;
+    SimpleBuffer actualBinary;
+    BinaryFormat::encode(expect, expectBinary);
+    encoder.flush(actualBinary);
+    EXPECT_EQUAL(expectBinary.get(), actualBinary.get());
+}
+
+TEST("require that nix is written for bad binary value") {
+    BinaryStreamEncoder encoder;
+    encoder.reset();
+    encoder.openObject();
+    encoder.field(Memory("bad"));
+    EXPECT_EQUAL(0u, encoder.writeBinary(Memory("abc")));
+    encoder.field(Memory("good"));
+    encoder.writeLong(5);
+    encoder.close();
+    Slime expect;
+    Cursor &obj = expect.setObject();
+    obj.setNix("bad");
+    obj.setLong("good", 5);
+    EXPECT_EQUAL(expect.toString(), encodeAsJson(encoder));
+}
+
+TEST_MAIN() { TEST_RUN_ALL(); }
@@ -3,6 +3,7 @@
 #pragma once
 
 #include "btreenode.h"
+#include "btreenodekeysearch.h"
 #include <algorithm>
 
 namespace search::btree {
@@ -43,9 +44,7 @@ uint32_t
 BTreeNodeT<KeyT, NumSlots>::
 lower_bound(uint32_t sidx, const KeyT & key, CompareT comp) const
 {
-    const KeyT * itr = std::lower_bound<const KeyT *, KeyT, CompareT>
-        (_keys + sidx, _keys + validSlots(), key, comp);
-    return itr - _keys;
+    return BTreeNodeKeySearch<KeyT, CompareT, NumSlots>::lower_bound(_keys, sidx, validSlots(), key, comp);
 }
 
 template <typename KeyT, uint32_t NumSlots>
@@ -53,10 +52,7 @@ template <typename CompareT>
 uint32_t
 BTreeNodeT<KeyT, NumSlots>::lower_bound(const KeyT & key, CompareT comp) const
 {
-    
-    const KeyT * itr = std::lower_bound<const KeyT *, KeyT, CompareT>
-        (_keys, _keys + validSlots(), key, comp);
-    return itr - _keys;
+    return BTreeNodeKeySearch<KeyT, CompareT, NumSlots>::lower_bound(_keys, 0, validSlots(), key, comp);
 }
 
 
@@ -66,9 +62,7 @@ uint32_t
 BTreeNodeT<KeyT, NumSlots>::
 upper_bound(uint32_t sidx, const KeyT & key, CompareT comp) const
 {
-    const KeyT * itr = std::upper_bound<const KeyT *, KeyT, CompareT>
-        (_keys + sidx, _keys + validSlots(), key, comp);
-    return itr - _keys;
+    return BTreeNodeKeySearch<KeyT, CompareT, NumSlots>::upper_bound(_keys, sidx, validSlots(), key, comp);
 }
 
 
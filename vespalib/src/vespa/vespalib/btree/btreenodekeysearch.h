@@ -0,0 +1,134 @@
+// Copyright 2019 Oath Inc. Licensed under the terms of the Apache 2.0 license. See LICENSE in the project root.
+
+#pragma once
+
+#include <algorithm>
+#include <cstdint>
+#include <functional>
+#include <type_traits>
+#if defined(__x86_64__)
+#include <immintrin.h>
+#endif
+
+namespace search::btree {
+
+/**
+ * Vector instructions for comparing keys in B-tree nodes. Only
+ * specialized for the key types and instruction sets where it pays off,
+ * as selected at compile time. Signed compare instructions are used for
+ * unsigned keys after flipping the sign bit of both sides.
+ */
+template <typename KeyT>
+struct BTreeNodeSimdKeyOps {
+    static constexpr uint32_t width = 0;
+};
+
+#if defined(__x86_64__)
+#ifdef __AVX2__
+
+template <typename KeyT>
+struct BTreeNodeSimdKeyOps32 {
+    using Vector = __m256i;
+    static constexpr uint32_t width = 8;
+    static constexpr bool flip = std::is_unsigned_v<KeyT>;
+    static Vector sign() { return _mm256_set1_epi32(INT32_MIN); }
+    static Vector splat(KeyT key) { return flip ? _mm256_xor_si256(_mm256_set1_epi32(key), sign()) : _mm256_set1_epi32(key); }
+    static Vector load(const KeyT *keys) {
+        Vector v = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(keys));
+        return flip ? _mm256_xor_si256(v, sign()) : v;
+    }
+    static uint32_t greater(Vector a, Vector b) { return _mm256_movemask_ps(_mm256_castsi256_ps(_mm256_cmpgt_epi32(a, b))); }
+};
+
+template <typename KeyT>
+struct BTreeNodeSimdKeyOps64 {
+    using Vector = __m256i;
+    static constexpr uint32_t width = 4;
+    static constexpr bool flip = std::is_unsigned_v<KeyT>;
+    static Vector sign() { return _mm256_set1_epi64x(INT64_MIN); }
+    static Vector splat(KeyT key) { return flip ? _mm256_xor_si256(_mm256_set1_epi64x(key), sign()) : _mm256_set1_epi64x(key); }
+    static Vector load(const KeyT *keys) {
+        Vector v = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(keys));
+        return flip ? _mm256_xor_si256(v, sign()) : v;
+    }
+    static uint32_t greater(Vector a, Vector b) { return _mm256_movemask_pd(_mm256_castsi256_pd(_mm256_cmpgt_epi64(a, b))); }
+};
+
+template <> struct BTreeNodeSimdKeyOps<int64_t> : BTreeNodeSimdKeyOps64<int64_t> { };
+template <> struct BTreeNodeSimdKeyOps<uint64_t> : BTreeNodeSimdKeyOps64<uint64_t> { };
+
+#else
+
+template <typename KeyT>
+struct BTreeNodeSimdKeyOps32 {
+    using Vector = __m128i;
+    static constexpr uint32_t width = 4;
+    static constexpr bool flip = std::is_unsigned_v<KeyT>;
+    static Vector sign() { return _mm_set1_epi32(INT32_MIN); }
+    static Vector splat(KeyT key) { return flip ? _mm_xor_si128(_mm_set1_epi32(key), sign()) : _mm_set1_epi32(key); }
+    static Vector load(const KeyT *keys) {
+        Vector v = _mm_loadu_si128(reinterpret_cast<const __m128i *>(keys));
+        return flip ? _mm_xor_si128(v, sign()) : v;
+    }
+    static uint32_t greater(Vector a, Vector b) { return _mm_movemask_ps(_mm_castsi128_ps(_mm_cmpgt_epi32(a, b))); }
+};
+
+#endif
+
+template <> struct BTreeNodeSimdKeyOps<int32_t> : BTreeNodeSimdKeyOps32<int32_t> { };
+template <> struct BTreeNodeSimdKeyOps<uint32_t> : BTreeNodeSimdKeyOps32<uint32_t> { };
+
+#endif
+
+/**
+ * Finds the position of a key among the sorted keys [sidx, eidx) of a
+ * B-tree node, using a binary search with the given comparator.
+ */
+template <typename KeyT, typename CompareT, uint32_t NumSlots, typename Enable = void>
+struct BTreeNodeKeySearch {
+    static uint32_t lower_bound(const KeyT *keys, uint32_t sidx, uint32_t eidx, const KeyT &key, CompareT comp) {
+        return std::lower_bound<const KeyT *, KeyT, CompareT>(keys + sidx, keys + eidx, key, comp) - keys;
+    }
+    static uint32_t upper_bound(const KeyT *keys, uint32_t sidx, uint32_t eidx, const KeyT &key, CompareT comp) {
+        return std::upper_bound<const KeyT *, KeyT, CompareT>(keys + sidx, keys + eidx, key, comp) - keys;
+    }
+};
+
+/**
+ * Integral keys ordered by std::less are instead compared against the
+ * keys in the node with vector instructions, and the position is found
+ * by counting the keys in [sidx, eidx) that are less than (or not
+ * greater than) the key. This avoids the unpredictable branches of the
+ * binary search. The vectors overlapping [sidx, eidx) are read in
+ * full, so the number of slots must be a multiple of the vector width.
+ */
+template <typename KeyT, uint32_t NumSlots>
+struct BTreeNodeKeySearch<KeyT, std::less<KeyT>, NumSlots,
+                          std::enable_if_t<(BTreeNodeSimdKeyOps<KeyT>::width != 0 &&
+                                            NumSlots % BTreeNodeSimdKeyOps<KeyT>::width == 0 &&
+                                            NumSlots <= 64)>>
+{
+    using Ops = BTreeNodeSimdKeyOps<KeyT>;
+
+    static uint64_t lowBits(uint32_t n) { return (n >= 64) ? ~uint64_t(0) : ((uint64_t(1) << n) - 1); }
+    static uint64_t rangeMask(uint32_t sidx, uint32_t eidx) { return lowBits(eidx) & ~lowBits(sidx); }
+
+    static uint32_t lower_bound(const KeyT *keys, uint32_t sidx, uint32_t eidx, const KeyT &key, std::less<KeyT>) {
+        auto splatKey = Ops::splat(key);
+        uint64_t less = 0;
+        for (uint32_t i = sidx & ~(Ops::width - 1); i < eidx; i += Ops::width) {
+            less |= uint64_t(Ops::greater(splatKey, Ops::load(keys + i))) << i;
+        }
+        return sidx + __builtin_popcountll(less & rangeMask(sidx, eidx));
+    }
+    static uint32_t upper_bound(const KeyT *keys, uint32_t sidx, uint32_t eidx, const KeyT &key, std::less<KeyT>) {
+        auto splatKey = Ops::splat(key);
+        uint64_t greater = 0;
+        for (uint32_t i = sidx & ~(Ops::width - 1); i < eidx; i += Ops::width) {
+            greater |= uint64_t(Ops::greater(Ops::load(keys + i), splatKey)) << i;
+        }
+        return sidx + __builtin_popcountll(~greater & rangeMask(sidx, eidx));
+    }
+};
+
+}
@@ -36,7 +36,9 @@ public:
     Reference push_back(const void * data, const size_t sz);
     void swap(MemoryDataStore & rhs) { _buffers.swap(rhs._buffers); }
     void clear() {
-        _buffers.clear();
+        // Keep the initial buffer to allow further use of the store
+        _buffers.erase(_buffers.begin() + 1, _buffers.end());
+        _writePos = 0;
     }
 private:
     std::vector<alloc::Alloc> _buffers;
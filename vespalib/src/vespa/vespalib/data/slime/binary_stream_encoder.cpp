@@ -0,0 +1,346 @@
+// Copyright 2019 Oath Inc. Licensed under the terms of the Apache 2.0 license. See LICENSE in the project root.
+
+#include "binary_stream_encoder.h"
+#include "binary_format.h"
+#include "array_traverser.h"
+#include "object_traverser.h"
+#include "inspector.h"
+#include <vespa/vespalib/data/memory_input.h>
+#include <cassert>
+
+#include <vespa/log/log.h>
+LOG_SETUP(".vespalib.data.slime.binary_stream_encoder");
+
+namespace vespalib {
+namespace slime {
+
+using namespace binary_format;
+
+namespace {
+
+uint32_t encode_type_and_size(char *out, uint32_t type, uint64_t size) {
+    // pre-req: out has room for 11 bytes
+    if (size <= 30) {
+        *out = encode_type_and_meta(type, size + 1);
+        return 1;
+    }
+    *out = encode_type_and_meta(type, 0);
+    return 1 + encode_cmpr_ulong(out + 1, size);
+}
+
+struct ValueEncoder : public ArrayTraverser,
+                      public ObjectTraverser
+{
+    BinaryStreamEncoder &out;
+    ValueEncoder(BinaryStreamEncoder &out_in) : out(out_in) {}
+    void encodeValue(const Inspector &inspector) {
+        switch (inspector.type().getId()) {
+        case NIX::ID:    return out.writeNix();
+        case BOOL::ID:   return out.writeBool(inspector.asBool());
+        case LONG::ID:   return out.writeLong(inspector.asLong());
+        case DOUBLE::ID: return out.writeDouble(inspector.asDouble());
+        case STRING::ID: return out.writeString(inspector.asString());
+        case DATA::ID:   return out.writeData(inspector.asData());
+        case ARRAY::ID:
+            out.openArray();
+            inspector.traverse(static_cast<ArrayTraverser &>(*this));
+            return out.close();
+        case OBJECT::ID:
+            out.openObject();
+            inspector.traverse(static_cast<ObjectTraverser &>(*this));
+            return out.close();
+        }
+        LOG_ABORT("should not be reached");
+    }
+    void entry(size_t, const Inspector &inspector) override {
+        encodeValue(inspector);
+    }
+    void field(const Memory &symbol, const Inspector &inspector) override {
+        out.field(symbol);
+        encodeValue(inspector);
+    }
+};
+
+/**
+ * Copies a value in the binary format into the encoder, mapping the
+ * symbols of the input onto the symbols of the encoder.
+ **/
+struct Transcoder
+{
+    BinaryStreamEncoder &out;
+    InputReader         &in;
+    std::vector<Symbol>  symbols;
+    Transcoder(BinaryStreamEncoder &out_in, InputReader &in_in) : out(out_in), in(in_in), symbols() {}
+
+    void decodeSymbolTable() {
+        uint64_t numSymbols = read_cmpr_ulong(in);
+        for (size_t i = 0; (i < numSymbols) && !in.failed(); ++i) {
+            uint64_t size = read_cmpr_ulong(in);
+            Memory image = in.read(size);
+            if (!in.failed()) {
+                symbols.push_back(out.resolve(image));
+            }
+        }
+    }
+    void decodeValue() {
+        char byte = in.read();
+        uint32_t meta = decode_meta(byte);
+        switch (decode_type(byte)) {
+        case NIX::ID:    return out.writeNix();
+        case BOOL::ID:   return out.writeBool(meta != 0);
+        case LONG::ID:   return out.writeLong(decode_zigzag(read_bytes<false>(in, meta)));
+        case DOUBLE::ID: return out.writeDouble(decode_double(read_bytes<true>(in, meta)));
+        case STRING::ID: return out.writeString(in.read(read_size(in, meta)));
+        case DATA::ID:   return out.writeData(in.read(read_size(in, meta)));
+        case ARRAY::ID:  return decodeArray(read_size(in, meta));
+        case OBJECT::ID: return decodeObject(read_size(in, meta));
+        }
+        in.fail("unknown value type");
+    }
+    void decodeArray(uint64_t size) {
+        out.openArray();
+        for (size_t i = 0; (i < size) && !in.failed(); ++i) {
+            decodeValue();
+        }
+        out.close();
+    }
+    void decodeObject(uint64_t size) {
+        out.openObject();
+        for (size_t i = 0; (i < size) && !in.failed(); ++i) {
+            uint64_t symbol = read_cmpr_ulong(in);
+            if (symbol >= symbols.size()) {
+                in.fail("symbol id out of range");
+                break;
+            }
+            out.field(symbols[symbol]);
+            decodeValue();
+        }
+        out.close();
+    }
+};
+
+}
+
+BinaryStreamEncoder::BinaryStreamEncoder()
+    : _preset(nullptr),
+      _symbols(),
+      _remap(),
+      _usedSymbols(),
+      _buf(),
+      _used(0),
+      _stack()
+{
+}
+
+BinaryStreamEncoder::~BinaryStreamEncoder() = default;
+
+void
+BinaryStreamEncoder::grow(size_t bytes)
+{
+    _buf.resize(std::max(_used + bytes, std::max(size_t(1024), _buf.size() * 2)));
+}
+
+void
+BinaryStreamEncoder::writeTypeAndSize(uint32_t type, uint64_t size)
+{
+    commit(encode_type_and_size(reserve(11), type, size));
+}
+
+template <bool top>
+void
+BinaryStreamEncoder::writeTypeAndBytes(uint32_t type, uint64_t bits)
+{
+    char *start = reserve(9); // max size
+    char *pos = start + 1;
+    while (bits != 0) {
+        if (top) {
+            *pos++ = (bits >> 56);
+            bits <<= 8;
+        } else {
+            *pos++ = (bits & 0xff);
+            bits >>= 8;
+        }
+    }
+    *start = encode_type_and_meta(type, pos - start - 1);
+    commit(pos - start);
+}
+
+void
+BinaryStreamEncoder::open(uint32_t type)
+{
+    value();
+    _stack.emplace_back(_used, type);
+    // Room for the header when there are at most 30 children
+    reserve(1);
+    commit(1);
+}
+
+void
+BinaryStreamEncoder::unuseSymbols(size_t keep)
+{
+    for (size_t i = keep; i < _usedSymbols.size(); ++i) {
+        _remap[_usedSymbols[i]] = UNUSED;
+    }
+    _usedSymbols.resize(keep);
+}
+
+void
+BinaryStreamEncoder::reset(const SymbolTable *preset)
+{
+    unuseSymbols(0);
+    _preset = preset;
+    _symbols.clear();
+    _remap.resize(numPreset(), UNUSED);
+    _used = 0;
+    _stack.clear();
+}
+
+Symbol
+BinaryStreamEncoder::resolve(const Memory &name)
+{
+    if (_preset != nullptr) {
+        Symbol symbol = _preset->lookup(name);
+        if (!symbol.undefined()) {
+            return symbol;
+        }
+    }
+    size_t value = numPreset() + _symbols.insert(name).getValue();
+    if (value >= _remap.size()) {
+        _remap.resize(value + 1, UNUSED);
+    }
+    return Symbol(value);
+}
+
+void
+BinaryStreamEncoder::field(const Symbol &symbol)
+{
+    assert(!_stack.empty() && _stack.back().type == OBJECT::ID);
+    assert(symbol.getValue() < _remap.size());
+    uint32_t &outputSymbol = _remap[symbol.getValue()];
+    if (outputSymbol == UNUSED) {
+        outputSymbol = _usedSymbols.size();
+        _usedSymbols.push_back(symbol.getValue());
+    }
+    commit(encode_cmpr_ulong(reserve(10), outputSymbol));
+}
+
+void
+BinaryStreamEncoder::writeNix()
+{
+    value();
+    *reserve(1) = NIX::ID;
+    commit(1);
+}
+
+void
+BinaryStreamEncoder::writeBool(bool v)
+{
+    value();
+    *reserve(1) = encode_type_and_meta(BOOL::ID, v ? 1 : 0);
+    commit(1);
+}
+
+void
+BinaryStreamEncoder::writeLong(int64_t v)
+{
+    value();
+    writeTypeAndBytes<false>(LONG::ID, encode_zigzag(v));
+}
+
+void
+BinaryStreamEncoder::writeDouble(double v)
+{
+    value();
+    writeTypeAndBytes<true>(DOUBLE::ID, encode_double(v));
+}
+
+void
+BinaryStreamEncoder::writeString(const Memory &v)
+{
+    value();
+    writeTypeAndSize(STRING::ID, v.size);
+    memcpy(reserve(v.size), v.data, v.size);
+    commit(v.size);
+}
+
+void
+BinaryStreamEncoder::writeData(const Memory &v)
+{
+    value();
+    writeTypeAndSize(DATA::ID, v.size);
+    memcpy(reserve(v.size), v.data, v.size);
+    commit(v.size);
+}
+
+void
+BinaryStreamEncoder::close()
+{
+    assert(!_stack.empty());
+    Frame frame = _stack.back();
+    _stack.pop_back();
+    if (frame.children <= 30) {
+        _buf[frame.header] = encode_type_and_meta(frame.type, frame.children + 1);
+        return;
+    }
+    char header[11];
+    uint32_t headerSize = encode_type_and_size(header, frame.type, frame.children);
+    size_t extra = headerSize - 1;
+    reserve(extra);
+    memmove(&_buf[frame.header + headerSize], &_buf[frame.header + 1], _used - frame.header - 1);
+    memcpy(&_buf[frame.header], header, headerSize);
+    commit(extra);
+}
+
+void
+BinaryStreamEncoder::writeValue(const Inspector &inspector)
+{
+    ValueEncoder encoder(*this);
+    encoder.encodeValue(inspector);
+}
+
+size_t
+BinaryStreamEncoder::writeBinary(const Memory &memory)
+{
+    size_t used = _used;
+    size_t usedSymbols = _usedSymbols.size();
+    size_t depth = _stack.size();
+    size_t children = _stack.empty() ? 0 : _stack.back().children;
+    MemoryInput memory_input(memory);
+    InputReader input(memory_input);
+    Transcoder transcoder(*this, input);
+    transcoder.decodeSymbolTable();
+    if (!input.failed()) {
+        transcoder.decodeValue();
+    }
+    if (input.failed()) {
+        _used = used;
+        unuseSymbols(usedSymbols);
+        _stack.resize(depth, Frame(0, NIX::ID));
+        if (!_stack.empty()) {
+            _stack.back().children = children;
+        }
+        writeNix();
+        return 0;
+    }
+    return input.get_offset();
+}
+
+void
+BinaryStreamEncoder::flush(Output &output) const
+{
+    assert(_stack.empty());
+    OutputWriter out(output, 8000);
+    size_t numPresetSymbols = numPreset();
+    write_cmpr_ulong(out, _usedSymbols.size());
+    for (uint32_t symbol : _usedSymbols) {
+        Memory image = (symbol < numPresetSymbols)
+                       ? _preset->inspect(Symbol(symbol))
+                       : _symbols.inspect(Symbol(symbol - numPresetSymbols));
+        write_cmpr_ulong(out, image.size);
+        out.write(image);
+    }
+    out.write(_buf.data(), _used);
+}
+
+} // namespace vespalib::slime
+} // namespace vespalib
@@ -0,0 +1,132 @@
+// Copyright 2019 Oath Inc. Licensed under the terms of the Apache 2.0 license. See LICENSE in the project root.
+
+#pragma once
+
+#include "symbol_table.h"
+#include "type.h"
+#include <vespa/vespalib/data/memory.h>
+#include <limits>
+#include <vector>
+
+namespace vespalib {
+
+struct Output;
+
+namespace slime {
+
+struct Inspector;
+
+/**
+ * Encodes a single value in the slime binary format while it is being
+ * produced, without building a Slime tree first.
+ *
+ * Arrays and objects are opened and closed explicitly, and the number
+ * of children is patched into the container header when it is closed.
+ * The value is written to an internal buffer that is reused after
+ * reset(), and flush() writes the symbol table followed by the value to
+ * the output, giving the same format as BinaryFormat::encode.
+ *
+ * Field names are first looked up in an optional preset symbol table
+ * (e.g. one per summary class). Names not found there are added to a
+ * symbol table owned by the encoder. Only the symbols used by the
+ * value are written, numbered in order of first use, so the output is
+ * the same as for a Slime built in the same order.
+ **/
+class BinaryStreamEncoder
+{
+private:
+    struct Frame {
+        size_t   header;   // offset of the type and size byte
+        size_t   children;
+        uint32_t type;
+        Frame(size_t header_in, uint32_t type_in) : header(header_in), children(0), type(type_in) {}
+    };
+
+    static constexpr uint32_t UNUSED = std::numeric_limits<uint32_t>::max();
+
+    const SymbolTable    *_preset;
+    SymbolTable           _symbols;
+    std::vector<uint32_t> _remap;       // resolved symbol -> output symbol
+    std::vector<uint32_t> _usedSymbols; // resolved symbols in output order
+    std::vector<char>     _buf;
+    size_t                _used;
+    std::vector<Frame>    _stack;
+
+    void grow(size_t bytes);
+    char *reserve(size_t bytes) {
+        if (__builtin_expect((_used + bytes) > _buf.size(), false)) {
+            grow(bytes);
+        }
+        return _buf.data() + _used;
+    }
+    void commit(size_t bytes) { _used += bytes; }
+    void value() {
+        if (!_stack.empty()) {
+            ++_stack.back().children;
+        }
+    }
+    void writeTypeAndSize(uint32_t type, uint64_t size);
+    template <bool top>
+    void writeTypeAndBytes(uint32_t type, uint64_t bits);
+    void open(uint32_t type);
+    size_t numPreset() const { return (_preset != nullptr) ? _preset->symbols() : 0; }
+    void unuseSymbols(size_t keep);
+
+public:
+    BinaryStreamEncoder();
+    ~BinaryStreamEncoder();
+
+    /**
+     * Prepare for encoding a new value, using the given preset symbol
+     * table (if any). The preset symbol table must outlive the encoding.
+     **/
+    void reset(const SymbolTable *preset = nullptr);
+
+    /**
+     * Returns true if no value has been written since the last reset.
+     **/
+    bool empty() const { return (_used == 0); }
+    const SymbolTable *getPreset() const { return _preset; }
+
+    Symbol resolve(const Memory &name);
+
+    /**
+     * Start a field in the innermost open object. The value of the
+     * field must be written next.
+     **/
+    void field(const Symbol &symbol);
+    void field(const Memory &name) { field(resolve(name)); }
+
+    void writeNix();
+    void writeBool(bool value);
+    void writeLong(int64_t value);
+    void writeDouble(double value);
+    void writeString(const Memory &value);
+    void writeData(const Memory &value);
+    void openArray() { open(ARRAY::ID); }
+    void openObject() { open(OBJECT::ID); }
+    void close();
+
+    /**
+     * Write a copy of the value referenced by the given inspector.
+     **/
+    void writeValue(const Inspector &inspector);
+
+    /**
+     * Write the value contained in the given slime binary format
+     * buffer, remapping its symbols. Nix is written if the buffer
+     * could not be decoded.
+     *
+     * @return number of bytes decoded, or 0 on failure
+     **/
+    size_t writeBinary(const Memory &memory);
+
+    /**
+     * Write the symbol table and the value to the given output. All
+     * arrays and objects must have been closed.
+     **/
+    void flush(Output &output) const;
+};
+
+} // namespace vespalib::slime
+} // namespace vespalib
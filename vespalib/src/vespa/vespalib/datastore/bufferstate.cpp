@@ -5,6 +5,7 @@
 
 using vespalib::alloc::Alloc;
 using vespalib::alloc::MemoryAllocator;
+using vespalib::alloc::MMapPolicy;
 
 namespace search::datastore {
 
@@ -31,7 +32,7 @@ BufferState::BufferState()
       _typeId(0),
       _arraySize(0),
       _compacting(false),
-      _buffer(Alloc::alloc(0, MemoryAllocator::HUGEPAGE_SIZE))
+      _buffer(Alloc::alloc(0, MMapPolicy::dataStore()))
 {
 }
 
@@ -159,7 +160,7 @@ BufferState::onFree(void *&buffer)
     assert(_deadElems <= _usedElems);
     assert(_holdElems == _usedElems - _deadElems);
     _typeHandler->destroyElements(buffer, _usedElems);
-    Alloc::alloc().swap(_buffer);
+    Alloc::alloc(MMapPolicy::dataStore()).swap(_buffer);
     _typeHandler->onFree(_usedElems);
     buffer = NULL;
     _usedElems = 0;
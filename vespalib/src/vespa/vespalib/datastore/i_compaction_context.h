@@ -2,7 +2,9 @@
 
 #pragma once
 
+#include "entryref.h"
 #include <vespa/vespalib/util/array.h>
+#include <vespa/vespalib/util/arrayref.h>
 
 namespace search::datastore {
 
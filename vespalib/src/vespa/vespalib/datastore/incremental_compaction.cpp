@@ -0,0 +1,79 @@
+// Copyright 2019 Oath Inc. Licensed under the terms of the Apache 2.0 license. See LICENSE in the project root.
+
+#include "incremental_compaction.h"
+#include <algorithm>
+#include <cassert>
+
+namespace search::datastore {
+
+IncrementalCompaction::Stats::Stats()
+    : compactions(0),
+      slices(0),
+      refs(0),
+      totalSliceTime(vespalib::duration::zero()),
+      maxSliceTime(vespalib::duration::zero())
+{
+}
+
+IncrementalCompaction::IncrementalCompaction(size_t sliceSize)
+    : _context(),
+      _nextRef(0),
+      _sliceSize(sliceSize),
+      _stats()
+{
+    assert(sliceSize > 0);
+}
+
+IncrementalCompaction::~IncrementalCompaction() = default;
+
+void
+IncrementalCompaction::start(ICompactionContext::UP context)
+{
+    assert(!active());
+    _context = std::move(context);
+    _nextRef = 0;
+    ++_stats.compactions;
+}
+
+bool
+IncrementalCompaction::compact(vespalib::ArrayRef<EntryRef> refs, size_t sliceSize)
+{
+    assert(active());
+    vespalib::Timer timer;
+    // refs might have shrunk since the previous slice
+    size_t start = std::min(_nextRef, refs.size());
+    size_t end = start + std::min(sliceSize, refs.size() - start);
+    _context->compact(vespalib::ArrayRef<EntryRef>(refs.begin() + start, end - start));
+    _stats.refs += end - start;
+    _nextRef = end;
+    bool done = (end == refs.size());
+    if (done) {
+        _context.reset();
+    }
+    vespalib::duration sliceTime = timer.elapsed();
+    ++_stats.slices;
+    _stats.totalSliceTime += sliceTime;
+    _stats.maxSliceTime = std::max(_stats.maxSliceTime, sliceTime);
+    return done;
+}
+
+bool
+IncrementalCompaction::compactSlice(vespalib::ArrayRef<EntryRef> refs)
+{
+    return compact(refs, _sliceSize);
+}
+
+void
+IncrementalCompaction::compactAll(vespalib::ArrayRef<EntryRef> refs)
+{
+    compact(refs, refs.size());
+}
+
+void
+IncrementalCompaction::reset()
+{
+    _context.reset();
+    _nextRef = 0;
+}
+
+}
@@ -0,0 +1,79 @@
+// Copyright 2019 Oath Inc. Licensed under the terms of the Apache 2.0 license. See LICENSE in the project root.
+
+#pragma once
+
+#include "entryref.h"
+#include "i_compaction_context.h"
+#include <vespa/vespalib/util/time.h>
+
+namespace search::datastore {
+
+/**
+ * Drives a compaction context over a vector of entry refs in bounded
+ * slices, instead of moving all entries in one step.
+ *
+ * The owner of the refs calls compactSlice() once per commit on the
+ * write thread, passing all refs each time. Entries written between the
+ * slices are allocated in non-compacting buffers and are left alone, while
+ * readers using old refs are protected by the generation hold of the
+ * compacted buffers. The buffers are not put on hold until the last slice
+ * has been compacted, thus memory used by them is not released before then.
+ */
+class IncrementalCompaction
+{
+public:
+    struct Stats {
+        uint64_t compactions;   // number of compactions started
+        uint64_t slices;        // number of slices compacted
+        uint64_t refs;          // number of refs passed to the compaction context
+        vespalib::duration totalSliceTime;
+        vespalib::duration maxSliceTime;
+        Stats();
+    };
+
+private:
+    ICompactionContext::UP _context;
+    size_t                 _nextRef;
+    size_t                 _sliceSize;
+    Stats                  _stats;
+
+    bool compact(vespalib::ArrayRef<EntryRef> refs, size_t sliceSize);
+
+public:
+    explicit IncrementalCompaction(size_t sliceSize);
+    ~IncrementalCompaction();
+
+    bool active() const { return static_cast<bool>(_context); }
+    size_t getNextRef() const { return _nextRef; }
+    size_t getSliceSize() const { return _sliceSize; }
+    void setSliceSize(size_t sliceSize) { _sliceSize = sliceSize; }
+    const Stats &getStats() const { return _stats; }
+
+    /**
+     * Start compaction using the given context. Any compaction already
+     * in progress must have been completed.
+     */
+    void start(ICompactionContext::UP context);
+
+    /**
+     * Compact the next slice of the given refs. When the end is reached
+     * the compaction context is dropped, finishing the compaction.
+     *
+     * @return true if the compaction is completed.
+     */
+    bool compactSlice(vespalib::ArrayRef<EntryRef> refs);
+
+    /**
+     * Compact all remaining refs, finishing the compaction.
+     */
+    void compactAll(vespalib::ArrayRef<EntryRef> refs);
+
+    /**
+     * Drop the compaction context without compacting the remaining refs.
+     * Only safe when the refs are not used afterwards, e.g. when the
+     * owner of the refs and the store is being destroyed.
+     */
+    void reset();
+};
+
+}
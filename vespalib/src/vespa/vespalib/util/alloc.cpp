@@ -9,6 +9,7 @@
 #include <atomic>
 #include <unordered_map>
 #include <vespa/fastos/file.h>
+#include <sys/syscall.h>
 #include <unistd.h>
 
 #include <vespa/log/log.h>
@@ -21,6 +22,7 @@ namespace {
 volatile bool _G_hasHugePageFailureJustHappened(false);
 bool _G_SilenceCoreOnOOM(false);
 int  _G_HugeFlags = 0;
+bool _G_TransparentHugePages(false);
 const size_t _G_pageSize = getpagesize();
 size_t _G_MMapLogLimit = std::numeric_limits<size_t>::max();
 size_t _G_MMapNoCoreLimit = std::numeric_limits<size_t>::max();
@@ -67,6 +69,7 @@ readOptionalEnvironmentVar(const char * name, size_t defaultValue) {
 void initializeEnvironment()
 {
     _G_HugeFlags = (getenv("VESPA_USE_HUGEPAGES") != nullptr) ? MAP_HUGETLB : 0;
+    _G_TransparentHugePages = (_G_HugeFlags == 0) && (getenv("VESPA_MMAP_TRANSPARENT_HUGEPAGES") != nullptr);
     _G_SilenceCoreOnOOM = (getenv("VESPA_SILENCE_CORE_ON_OOM") != nullptr) ? true : false;
     _G_MMapLogLimit = readOptionalEnvironmentVar("VESPA_MMAP_LOG_LIMIT", std::numeric_limits<size_t>::max());
     _G_MMapNoCoreLimit = readOptionalEnvironmentVar("VESPA_MMAP_NOCORE_LIMIT", std::numeric_limits<size_t>::max());
@@ -79,6 +82,95 @@ public:
 
 Initialize _G_initializer;
 
+/**
+ * Trim a mapping of sz + HUGEPAGE_SIZE bytes to the sz bytes starting at
+ * the first huge page boundary, as the kernel can only back huge page
+ * aligned ranges with transparent huge pages.
+ */
+void *
+alignToHugePage(void * buf, size_t sz)
+{
+    constexpr size_t hugePageSize = alloc::MemoryAllocator::HUGEPAGE_SIZE;
+    uintptr_t start = reinterpret_cast<uintptr_t>(buf);
+    uintptr_t aligned = (start + (hugePageSize - 1)) & ~uintptr_t(hugePageSize - 1);
+    size_t head = aligned - start;
+    size_t tail = hugePageSize - head;
+    if (head > 0) {
+        int retval = munmap(buf, head);
+        assert(retval == 0);
+        (void) retval;
+    }
+    if (tail > 0) {
+        int retval = munmap(reinterpret_cast<char *>(aligned) + sz, tail);
+        assert(retval == 0);
+        (void) retval;
+    }
+    return reinterpret_cast<void *>(aligned);
+}
+
+void
+adviseTransparentHugePages(void * buf, size_t sz)
+{
+#ifdef MADV_HUGEPAGE
+    if (madvise(buf, sz, MADV_HUGEPAGE) != 0) {
+        LOG(debug, "Failed madvise(%p, %ld, MADV_HUGEPAGE) = '%s'", buf, sz, FastOS_FileInterface::getLastErrorString().c_str());
+    }
+#else
+    (void) buf;
+    (void) sz;
+#endif
+}
+
+/**
+ * The NUMA nodes this process may allocate memory on, as a bit mask.
+ */
+unsigned long
+allowedNumaNodes()
+{
+    unsigned long nodes = 0;
+#ifdef SYS_get_mempolicy
+    constexpr unsigned long getMemsAllowed = 4; // MPOL_F_MEMS_ALLOWED in <numaif.h>
+    int mode = 0;
+    if (syscall(SYS_get_mempolicy, &mode, &nodes, sizeof(nodes) * 8, nullptr, getMemsAllowed) != 0) {
+        LOG(debug, "Failed get_mempolicy(MPOL_F_MEMS_ALLOWED) = '%s'", FastOS_FileInterface::getLastErrorString().c_str());
+        nodes = 0;
+    }
+#endif
+    return nodes;
+}
+
+void
+interleaveAcrossNumaNodes(void * buf, size_t sz)
+{
+#ifdef SYS_mbind
+    static const unsigned long nodes = allowedNumaNodes();
+    if (__builtin_popcountl(nodes) < 2) {
+        return;
+    }
+    constexpr int interleave = 3; // MPOL_INTERLEAVE in <numaif.h>
+    if (syscall(SYS_mbind, buf, sz, interleave, &nodes, sizeof(nodes) * 8, 0) != 0) {
+        LOG(debug, "Failed mbind(%p, %ld, MPOL_INTERLEAVE) = '%s'", buf, sz, FastOS_FileInterface::getLastErrorString().c_str());
+    }
+#else
+    (void) buf;
+    (void) sz;
+#endif
+}
+
+void
+prefaultPages(void * buf, size_t sz)
+{
+#ifdef MADV_POPULATE_WRITE
+    if (madvise(buf, sz, MADV_POPULATE_WRITE) == 0) {
+        return;
+    }
+#endif
+    volatile char * pages = static_cast<char *>(buf);
+    for (size_t offset(0); offset < sz; offset += _G_pageSize) {
+        pages[offset] = 0;
+    }
+}
+
 size_t sum(const MMapStore & s)
 {
     size_t sum(0);
@@ -143,18 +235,22 @@ public:
     PtrAndSize alloc(size_t sz) const override;
     void free(PtrAndSize alloc) const override;
     size_t resize_inplace(PtrAndSize current, size_t newSize) const override;
-    static size_t sresize_inplace(PtrAndSize current, size_t newSize);
-    static PtrAndSize salloc(size_t sz, void * wantedAddress);
-    static void sfree(PtrAndSize alloc);
+    static size_t sresize_inplace(PtrAndSize current, size_t newSize, const MMapPolicy * policy = nullptr);
+    static PtrAndSize salloc(size_t sz, void * wantedAddress, const MMapPolicy * policy = nullptr);
+    static void sfree(PtrAndSize alloc, const MMapPolicy * policy = nullptr);
     static MemoryAllocator & getDefault();
 private:
-    static size_t extend_inplace(PtrAndSize current, size_t newSize);
-    static size_t shrink_inplace(PtrAndSize current, size_t newSize);
+    static size_t extend_inplace(PtrAndSize current, size_t newSize, const MMapPolicy * policy);
+    static size_t shrink_inplace(PtrAndSize current, size_t newSize, const MMapPolicy * policy);
 };
 
 class AutoAllocator : public MemoryAllocator {
 public:
-    AutoAllocator(size_t mmapLimit, size_t alignment) : _mmapLimit(mmapLimit), _alignment(alignment) { }
+    AutoAllocator(size_t mmapLimit, size_t alignment, const MMapPolicy * policy = nullptr)
+        : _mmapLimit(mmapLimit),
+          _alignment(alignment),
+          _policy(policy)
+    { }
     PtrAndSize alloc(size_t sz) const override;
     void free(PtrAndSize alloc) const override;
     size_t resize_inplace(PtrAndSize current, size_t newSize) const override;
@@ -174,8 +270,9 @@ private:
             return (sz >= _mmapLimit);
         }
     }
-    size_t _mmapLimit;
-    size_t _alignment;
+    size_t               _mmapLimit;
+    size_t               _alignment;
+    const MMapPolicy   * _policy;
 };
 
 
@@ -314,7 +411,7 @@ MMapAllocator::alloc(size_t sz) const {
 }
 
 MemoryAllocator::PtrAndSize
-MMapAllocator::salloc(size_t sz, void * wantedAddress)
+MMapAllocator::salloc(size_t sz, void * wantedAddress, const MMapPolicy * policy)
 {
     void * buf(nullptr);
     sz = roundUp2PageSize(sz);
@@ -327,7 +424,12 @@ MMapAllocator::salloc(size_t sz, void * wantedAddress)
             stackTrace = getStackTrace(1);
             LOG(info, "mmap %ld of size %ld from %s", mmapId, sz, stackTrace.c_str());
         }
-        buf = mmap(wantedAddress, sz, prot, flags | _G_HugeFlags, -1, 0);
+        bool transparentHugePages = _G_TransparentHugePages ||
+                                    ((policy != nullptr) && policy->getSettings().transparentHugePages && (_G_HugeFlags == 0));
+        // Over allocate to be able to align on a huge page boundary, unless extending an existing mapping
+        bool alignMapping = transparentHugePages && (wantedAddress == nullptr) && (sz >= HUGEPAGE_SIZE);
+        size_t mapSz = alignMapping ? (sz + HUGEPAGE_SIZE) : sz;
+        buf = mmap(wantedAddress, mapSz, prot, flags | _G_HugeFlags, -1, 0);
         if (buf == MAP_FAILED) {
             if ( ! _G_hasHugePageFailureJustHappened ) {
                 _G_hasHugePageFailureJustHappened = true;
@@ -335,7 +437,7 @@ MMapAllocator::salloc(size_t sz, void * wantedAddress)
                           " Will resort to ordinary mmap until it works again.",
                            sz, FastOS_FileInterface::getLastErrorString().c_str());
             }
-            buf = mmap(wantedAddress, sz, prot, flags, -1, 0);
+            buf = mmap(wantedAddress, mapSz, prot, flags, -1, 0);
             if (buf == MAP_FAILED) {
                 stackTrace = getStackTrace(1);
                 string msg = make_string("Failed mmaping anonymous of size %ld errno(%d) from %s", sz, errno, stackTrace.c_str());
@@ -352,6 +454,25 @@ MMapAllocator::salloc(size_t sz, void * wantedAddress)
                 _G_hasHugePageFailureJustHappened = false;
             }
         }
+        if (transparentHugePages) {
+            if (alignMapping) {
+                buf = alignToHugePage(buf, sz);
+            }
+            adviseTransparentHugePages(buf, sz);
+        }
+        if (policy != nullptr) {
+            // A failed extension lands elsewhere and is unmapped right away, don't bother setting it up
+            bool inPlace = (wantedAddress == nullptr) || (buf == wantedAddress);
+            size_t prefaulted(0);
+            if (inPlace && policy->getSettings().interleave) {
+                interleaveAcrossNumaNodes(buf, sz);
+            }
+            if (inPlace && policy->getSettings().prefault) {
+                prefaultPages(buf, sz);
+                prefaulted = sz;
+            }
+            policy->onMapped(sz, wantedAddress == nullptr, prefaulted);
+        }
         if (sz >= _G_MMapNoCoreLimit) {
             if (madvise(buf, sz, MADV_DONTDUMP) != 0) {
                 LOG(warning, "Failed madvise(%p, %ld, MADV_DONTDUMP) = '%s'", buf, sz, FastOS_FileInterface::getLastErrorString().c_str());
@@ -367,32 +488,32 @@ MMapAllocator::salloc(size_t sz, void * wantedAddress)
 }
 
 size_t
-MMapAllocator::sresize_inplace(PtrAndSize current, size_t newSize) {
+MMapAllocator::sresize_inplace(PtrAndSize current, size_t newSize, const MMapPolicy * policy) {
     newSize = roundUp2PageSize(newSize);
     if (newSize > current.second) {
-        return extend_inplace(current, newSize);
+        return extend_inplace(current, newSize, policy);
     } else if (newSize < current.second) {
-        return shrink_inplace(current, newSize);
+        return shrink_inplace(current, newSize, policy);
     } else {
         return current.second;
     }
 }
 
 size_t
-MMapAllocator::extend_inplace(PtrAndSize current, size_t newSize) {
-    PtrAndSize got = MMapAllocator::salloc(newSize - current.second, static_cast<char *>(current.first)+current.second);
+MMapAllocator::extend_inplace(PtrAndSize current, size_t newSize, const MMapPolicy * policy) {
+    PtrAndSize got = MMapAllocator::salloc(newSize - current.second, static_cast<char *>(current.first)+current.second, policy);
     if ((static_cast<const char *>(current.first) + current.second) == static_cast<const char *>(got.first)) {
         return current.second + got.second;
     } else {
-        MMapAllocator::sfree(got);
+        MMapAllocator::sfree(got, policy);
         return 0;
     }
 }
 
 size_t
-MMapAllocator::shrink_inplace(PtrAndSize current, size_t newSize) {
+MMapAllocator::shrink_inplace(PtrAndSize current, size_t newSize, const MMapPolicy * policy) {
     PtrAndSize toUnmap(static_cast<char *>(current.first)+newSize, current.second - newSize);
-    sfree(toUnmap);
+    sfree(toUnmap, policy);
     return newSize;
 }
 
@@ -400,13 +521,16 @@ void MMapAllocator::free(PtrAndSize alloc) const {
     sfree(alloc);
 }
 
-void MMapAllocator::sfree(PtrAndSize alloc)
+void MMapAllocator::sfree(PtrAndSize alloc, const MMapPolicy * policy)
 {
     if (alloc.first != nullptr) {
         int retval = madvise(alloc.first, alloc.second, MADV_DONTNEED);
         assert(retval == 0);
         retval = munmap(alloc.first, alloc.second);
         assert(retval == 0);
+        if (policy != nullptr) {
+            policy->onUnmapped(alloc.second);
+        }
         if (alloc.second >= _G_MMapLogLimit) {
             LockGuard guard(_G_lock);
             MMapInfo info = _G_HugeMappings[alloc.first];
@@ -422,7 +546,7 @@ size_t
 AutoAllocator::resize_inplace(PtrAndSize current, size_t newSize) const {
     if (isMMapped(current.second) && useMMap(newSize)) {
         newSize = roundUpToHugePages(newSize);
-        return MMapAllocator::sresize_inplace(current, newSize);
+        return MMapAllocator::sresize_inplace(current, newSize, _policy);
     } else {
         return 0;
     }
@@ -432,7 +556,7 @@ MMapAllocator::PtrAndSize
 AutoAllocator::alloc(size_t sz) const {
     if (useMMap(sz)) {
         sz = roundUpToHugePages(sz);
-        return MMapAllocator::salloc(sz, nullptr);
+        return MMapAllocator::salloc(sz, nullptr, _policy);
     } else {
         if (_alignment == 0) {
             return HeapAllocator::salloc(sz);
@@ -445,7 +569,7 @@ AutoAllocator::alloc(size_t sz) const {
 void
 AutoAllocator::free(PtrAndSize alloc) const {
     if (isMMapped(alloc.second)) {
-        return MMapAllocator::sfree(alloc);
+        return MMapAllocator::sfree(alloc, _policy);
     } else {
         return HeapAllocator::sfree(alloc);
     }
@@ -502,6 +626,95 @@ Alloc::alloc(size_t sz, size_t mmapLimit, size_t alignment)
     return Alloc(&AutoAllocator::getAllocator(mmapLimit, alignment), sz);
 }
 
+Alloc
+Alloc::alloc(size_t sz, const MMapPolicy & policy)
+{
+    return Alloc(&policy.getAllocator(), sz);
+}
+
+Alloc
+Alloc::alloc(const MMapPolicy & policy)
+{
+    return Alloc(&policy.getAllocator());
+}
+
+MMapPolicy::Settings
+MMapPolicy::Settings::fromString(const char * str)
+{
+    Settings settings;
+    if (str == nullptr) {
+        return settings;
+    }
+    string remaining(str);
+    while ( ! remaining.empty()) {
+        size_t end = remaining.find(',');
+        string option = remaining.substr(0, end);
+        remaining = (end == string::npos) ? string() : remaining.substr(end + 1);
+        if (option == "thp") {
+            settings.transparentHugePages = true;
+        } else if (option == "prefault") {
+            settings.prefault = true;
+        } else if (option == "interleave") {
+            settings.interleave = true;
+        } else if ( ! option.empty()) {
+            LOG(warning, "Ignoring unknown mmap policy option '%s' in '%s'", option.c_str(), str);
+        }
+    }
+    return settings;
+}
+
+MMapPolicy::MMapPolicy(const Settings & settings)
+    : _settings(settings),
+      _mmaps(0),
+      _mappedBytes(0),
+      _prefaultedBytes(0),
+      _allocator(std::make_unique<AutoAllocator>(MemoryAllocator::HUGEPAGE_SIZE, 0, this))
+{ }
+
+MMapPolicy::~MMapPolicy() = default;
+
+MMapPolicy::Stats
+MMapPolicy::getStats() const
+{
+    Stats stats;
+    stats.mmaps = _mmaps.load(std::memory_order_relaxed);
+    stats.mappedBytes = _mappedBytes.load(std::memory_order_relaxed);
+    stats.prefaultedBytes = _prefaultedBytes.load(std::memory_order_relaxed);
+    return stats;
+}
+
+void
+MMapPolicy::onMapped(size_t sz, bool newMapping, size_t prefaulted) const
+{
+    if (newMapping) {
+        _mmaps.fetch_add(1, std::memory_order_relaxed);
+    }
+    _mappedBytes.fetch_add(sz, std::memory_order_relaxed);
+    _prefaultedBytes.fetch_add(prefaulted, std::memory_order_relaxed);
+}
+
+void
+MMapPolicy::onUnmapped(size_t sz) const
+{
+    _mappedBytes.fetch_sub(sz, std::memory_order_relaxed);
+}
+
+// The component policies are never destroyed, as their buffers may be freed during static destruction.
+
+const MMapPolicy &
+MMapPolicy::dataStore()
+{
+    static const MMapPolicy * policy = new MMapPolicy(Settings::fromString(getenv("VESPA_MMAP_POLICY_DATASTORE")));
+    return *policy;
+}
+
+const MMapPolicy &
+MMapPolicy::rcuVector()
+{
+    static const MMapPolicy * policy = new MMapPolicy(Settings::fromString(getenv("VESPA_MMAP_POLICY_RCUVECTOR")));
+    return *policy;
+}
+
 }
 
 }
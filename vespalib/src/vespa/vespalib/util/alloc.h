@@ -2,6 +2,7 @@
 #pragma once
 
 #include <vespa/vespalib/util/optimized.h>
+#include <atomic>
 #include <memory>
 
 namespace vespalib::alloc {
@@ -32,6 +33,51 @@ public:
     }
 };
 
+/**
+ * Settings applied to the memory mapped on behalf of one component, and
+ * counters for that memory. Allocations made through a policy must not
+ * outlive it.
+ *
+ * The policies used by the data store buffers and RcuVector are set up
+ * from VESPA_MMAP_POLICY_DATASTORE and VESPA_MMAP_POLICY_RCUVECTOR, which
+ * take a comma separated list of 'thp', 'prefault' and 'interleave'.
+ **/
+class MMapPolicy {
+public:
+    struct Settings {
+        Settings() : transparentHugePages(false), prefault(false), interleave(false) { }
+        static Settings fromString(const char * str);
+        // Align mappings on huge page boundaries and advise MADV_HUGEPAGE
+        bool transparentHugePages;
+        // Fault in new mappings up front instead of on first access
+        bool prefault;
+        // Interleave new mappings across all NUMA nodes
+        bool interleave;
+    };
+    struct Stats {
+        size_t mmaps;
+        size_t mappedBytes;
+        size_t prefaultedBytes;
+    };
+    MMapPolicy(const Settings & settings);
+    MMapPolicy(const MMapPolicy &) = delete;
+    MMapPolicy & operator = (const MMapPolicy &) = delete;
+    ~MMapPolicy();
+    const Settings & getSettings() const { return _settings; }
+    Stats getStats() const;
+    const MemoryAllocator & getAllocator() const { return *_allocator; }
+    void onMapped(size_t sz, bool newMapping, size_t prefaulted) const;
+    void onUnmapped(size_t sz) const;
+    static const MMapPolicy & dataStore();
+    static const MMapPolicy & rcuVector();
+private:
+    Settings                    _settings;
+    mutable std::atomic<size_t> _mmaps;
+    mutable std::atomic<size_t> _mappedBytes;
+    mutable std::atomic<size_t> _prefaultedBytes;
+    MemoryAllocator::UP         _allocator;
+};
+
 /**
  * This represents an allocation.
  * It can be created, moved, swapped.
@@ -100,6 +146,12 @@ public:
      */
     static Alloc alloc(size_t sz, size_t mmapLimit = MemoryAllocator::HUGEPAGE_SIZE, size_t alignment=0);
     static Alloc alloc();
+    /**
+     * Allocates like alloc(sz), but memory mapped buffers are set up
+     * and accounted according to the given policy.
+     */
+    static Alloc alloc(size_t sz, const MMapPolicy & policy);
+    static Alloc alloc(const MMapPolicy & policy);
 private:
     Alloc(const MemoryAllocator * allocator, size_t sz) : _alloc(allocator->alloc(sz)), _allocator(allocator) { }
     Alloc(const MemoryAllocator * allocator) : _alloc(nullptr, 0), _allocator(allocator) { }
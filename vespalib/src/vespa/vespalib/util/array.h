@@ -131,6 +131,8 @@ public:
     size_t byteSize() const                 { return _sz * sizeof(T); }
     size_t byteCapacity() const             { return _array.size(); }
     size_t capacity() const                 { return _array.size()/sizeof(T); }
+    // Pass as initial alloc to create an array with the same allocation strategy
+    const Alloc & getAlloc() const          { return _array; }
     void clear() {
         std::destroy(array(0), array(_sz));
         _sz = 0;
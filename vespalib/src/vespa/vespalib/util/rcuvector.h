@@ -62,7 +62,7 @@ private:
 public:
     using ValueType = T;
     RcuVectorBase(GenerationHolderType &genHolder,
-                  const Alloc &initialAlloc = Alloc::alloc());
+                  const Alloc &initialAlloc = Alloc::alloc(alloc::MMapPolicy::rcuVector()));
 
     /**
      * Construct a new vector with the given initial capacity and grow
@@ -73,11 +73,11 @@ public:
      **/
     RcuVectorBase(size_t initialCapacity, size_t growPercent, size_t growDelta,
                   GenerationHolderType &genHolder,
-                  const Alloc &initialAlloc = Alloc::alloc());
+                  const Alloc &initialAlloc = Alloc::alloc(alloc::MMapPolicy::rcuVector()));
 
     RcuVectorBase(GrowStrategy growStrategy,
                   GenerationHolderType &genHolder,
-                  const Alloc &initialAlloc = Alloc::alloc());
+                  const Alloc &initialAlloc = Alloc::alloc(alloc::MMapPolicy::rcuVector()));
 
     virtual ~RcuVectorBase();
 
@@ -118,6 +118,8 @@ public:
     void clear() { _data.clear(); }
     T & operator[](size_t i) { return _data[i]; }
     const T & operator[](size_t i) const { return _data[i]; }
+    T * data() { return _data.begin(); }
+    const T * data() const { return _data.begin(); }
 
     void reset();
     void shrink(size_t newSize) __attribute__((noinline));
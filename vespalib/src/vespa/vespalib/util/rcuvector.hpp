@@ -41,7 +41,7 @@ template <typename T>
 void
 RcuVectorBase<T>::reset() {
     // Assumes no readers at this moment
-    ArrayType().swap(_data);
+    ArrayType(_data.getAlloc()).swap(_data);
     _data.reserve(16);
 }
 
@@ -51,7 +51,7 @@ RcuVectorBase<T>::~RcuVectorBase() = default;
 template <typename T>
 void
 RcuVectorBase<T>::expand(size_t newCapacity) {
-    std::unique_ptr<ArrayType> tmpData(new ArrayType());
+    std::unique_ptr<ArrayType> tmpData(new ArrayType(_data.getAlloc()));
     tmpData->reserve(newCapacity);
     for (const T & v : _data) {
         tmpData->push_back_fast(v);
@@ -89,7 +89,7 @@ RcuVectorBase<T>::shrink(size_t newSize)
         return;
     }
     if (!_data.try_unreserve(wantedCapacity)) {
-        std::unique_ptr<ArrayType> tmpData(new ArrayType());
+        std::unique_ptr<ArrayType> tmpData(new ArrayType(_data.getAlloc()));
         tmpData->reserve(wantedCapacity);
         tmpData->resize(newSize);
         for (uint32_t i = 0; i < newSize; ++i) {